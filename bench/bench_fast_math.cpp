@@ -0,0 +1,79 @@
+/// @ref bench
+/// @file bench_fast_math.cpp
+///
+/// @brief Benchmarks for csfast_math: libm versus the FastMath polynomials, the batched sincos, and the
+/// rotate() / perspective() builders under both policies.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <random>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csmatrix_utils.hpp"
+#include "csfast_math.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("fast_math", argc, argv);
+
+    // 动画系统一帧生成的角度（弧度）
+    size_t n = 4096;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f), halfFov(0.1f, 1.4f);
+    std::vector<float> angles(n), fovs(n), sines(n), cosines(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        angles[i] = angle(rng);
+        fovs[i] = halfFov(rng);
+    }
+
+    // ---------------------------------------------------------------- sincos
+    runner.run("sincos/libm/4096", double(n), [&]()
+               {
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       sines[i] = sinf(angles[i]);
+                       cosines[i] = cosf(angles[i]);
+                   }
+                   doNotOptimize(sines[0]); });
+    runner.run("sincos/FastMath/4096", double(n), [&]()
+               {
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       glmCS::FastMath::sincos(angles[i], &sines[i], &cosines[i]);
+                   }
+                   doNotOptimize(sines[0]); });
+    runner.run("sincos/batch/4096", double(n), [&]()
+               { glmCS::sincos(angles.data(), sines.data(), cosines.data(), n); doNotOptimize(sines[0]); });
+
+    // ---------------------------------------------------------------- tan
+    runner.run("tan/libm/4096", double(n), [&]()
+               {
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       sines[i] = tanf(fovs[i]);
+                   }
+                   doNotOptimize(sines[0]); });
+    runner.run("tan/FastMath/4096", double(n), [&]()
+               {
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       sines[i] = glmCS::FastMath::tan(fovs[i]);
+                   }
+                   doNotOptimize(sines[0]); });
+
+    // ---------------------------------------------------------------- builders
+    glmCS::Matrix<float, 4, 4> model = glmCS::initIdentityMatrix<float, 4>();
+    volatile float degrees = 37.0f;
+    runner.run("rotate/PreciseMath", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::rotate<float, glmCS::PreciseMath>(degrees, model, 0, 1, 0); doNotOptimize(m); });
+    runner.run("rotate/FastMath", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::rotate<float, glmCS::FastMath>(degrees, model, 0, 1, 0); doNotOptimize(m); });
+    runner.run("perspective/PreciseMath", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::perspective<float, glmCS::PreciseMath>(degrees * 0.01f, 4.0f / 3.0f, 0.01f, 100.0f); doNotOptimize(m); });
+    runner.run("perspective/FastMath", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::perspective<float, glmCS::FastMath>(degrees * 0.01f, 4.0f / 3.0f, 0.01f, 100.0f); doNotOptimize(m); });
+    return 0;
+}
@@ -0,0 +1,309 @@
+/// @ref bench
+/// @file bench_glsl_builtins.cpp
+///
+/// @brief Throughput of the GLSL built-ins of csglsl_builtins per function. Each function is timed with a plain
+/// float loop ("scalar") and with Lane<float, 4 / 8 / 16> over the same 4096 inputs; items/s counts results. The
+/// geometric functions compare an array of glmCS::Vec3 with SoA streams processed as Vector<Lane<float, W>, 3>.
+/// "precision/*" records the largest error over 1M samples against the same formula evaluated in double, for the
+/// scalar and the Lane<float, 8> version, in ULP or as absolute error. "glsl_limit" is the bound GLSL 4.60 (or the
+/// Vulkan environment for sin / cos) states; it is omitted for functions whose precision is inherited from their formula.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csglsl_builtins.hpp"
+
+using glmcs_bench::doNotOptimize;
+using namespace glmCS::glsl;
+
+namespace
+{
+    // float 与 Lane 的统一读写
+    template <typename L>
+    struct Access
+    {
+        static const size_t width = L::width;
+        static L load(const float *p) { return L::load(p); }
+        static void store(float *p, const L &v) { v.store(p); }
+    };
+    template <>
+    struct Access<float>
+    {
+        static const size_t width = 1;
+        static float load(const float *p) { return *p; }
+        static void store(float *p, float v) { *p = v; }
+    };
+
+    struct Streams
+    {
+        std::vector<float> a, b, c, out;
+    };
+
+    // out[i] = f(a[i], b[i], c[i])，每次处理 L 的宽度个元素
+    template <typename L, typename F>
+    void runKernel(glmcs_bench::Runner &runner, const std::string &name, Streams &s, F f)
+    {
+        typedef Access<L> A;
+        // 指针取到局部变量：SIMD 写入可与任何对象重叠，否则每次迭代都会重新读取 vector 的数据指针
+        size_t n = s.a.size();
+        const float *a = s.a.data(), *b = s.b.data(), *c = s.c.data();
+        float *out = s.out.data();
+        runner.run(name, double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; i += A::width)
+                       {
+                           A::store(out + i, f(A::load(a + i), A::load(b + i), A::load(c + i)));
+                       }
+                       doNotOptimize(out[0]); });
+    }
+
+    template <typename F>
+    void runWidths(glmcs_bench::Runner &runner, const std::string &fn, Streams &s, F f)
+    {
+        const std::string suffix = "/" + std::to_string(s.a.size());
+        runKernel<float>(runner, fn + "/scalar" + suffix, s, f);
+        runKernel<Lane4>(runner, fn + "/lane4" + suffix, s, f);
+        runKernel<Lane8>(runner, fn + "/lane8" + suffix, s, f);
+        runKernel<Lane16>(runner, fn + "/lane16" + suffix, s, f);
+    }
+
+    // vec3 流：SoA 三个分量
+    struct Vec3Streams
+    {
+        std::vector<float> a[3], b[3], out[3];
+        std::vector<glmCS::Vec3> aosA, aosB, aosOut;
+    };
+
+    template <typename L, typename F>
+    void runVec3Lanes(glmcs_bench::Runner &runner, const std::string &name, Vec3Streams &s, F f)
+    {
+        typedef glmCS::Vector<L, 3> V;
+        size_t n = s.a[0].size();
+        const float *ax = s.a[0].data(), *ay = s.a[1].data(), *az = s.a[2].data();
+        const float *bx = s.b[0].data(), *by = s.b[1].data(), *bz = s.b[2].data();
+        float *ox = s.out[0].data(), *oy = s.out[1].data(), *oz = s.out[2].data();
+        runner.run(name, double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; i += L::width)
+                       {
+                           V r = f(V(L::load(ax + i), L::load(ay + i), L::load(az + i)), V(L::load(bx + i), L::load(by + i), L::load(bz + i)));
+                           r.v[0].store(ox + i);
+                           r.v[1].store(oy + i);
+                           r.v[2].store(oz + i);
+                       }
+                       doNotOptimize(ox[0]); });
+    }
+
+    template <typename F>
+    void runVec3Widths(glmcs_bench::Runner &runner, const std::string &fn, Vec3Streams &s, F f)
+    {
+        size_t n = s.aosA.size();
+        const std::string suffix = "/" + std::to_string(n);
+        runner.run(fn + "/vec3" + suffix, double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           s.aosOut[i] = f(s.aosA[i], s.aosB[i]);
+                       }
+                       doNotOptimize(s.aosOut[0]); });
+        runVec3Lanes<Lane4>(runner, fn + "/lane4x3" + suffix, s, f);
+        runVec3Lanes<Lane8>(runner, fn + "/lane8x3" + suffix, s, f);
+        runVec3Lanes<Lane16>(runner, fn + "/lane16x3" + suffix, s, f);
+    }
+
+    // 以参考值处 float 的间距为单位的误差
+    double ulpError(float got, double ref)
+    {
+        float r = float(ref);
+        double ulp = double(nextafterf(fabsf(r), INFINITY)) - double(fabsf(r));
+        return fabs(double(got) - ref) / ulp;
+    }
+
+    // 对 samples 组输入分别计算标量与 Lane<float, 8> 的最大误差
+    template <typename Gen, typename F, typename Ref, typename Err>
+    void measure(glmcs_bench::Runner &runner, const std::string &name, double limit, Gen gen, F f, Ref ref, Err err)
+    {
+        const size_t samples = 1 << 20;
+        double maxScalar = 0.0, maxLane = 0.0;
+        float x[8], y[8], z[8], lane[8];
+        for (size_t i = 0; i < samples; i += 8)
+        {
+            for (size_t k = 0; k < 8; k++)
+            {
+                gen(&x[k], &y[k], &z[k]);
+            }
+            f(Lane8::load(x), Lane8::load(y), Lane8::load(z)).store(lane);
+            for (size_t k = 0; k < 8; k++)
+            {
+                double r = ref(double(x[k]), double(y[k]), double(z[k]));
+                double es = err(f(x[k], y[k], z[k]), r), el = err(lane[k], r);
+                maxScalar = es > maxScalar ? es : maxScalar;
+                maxLane = el > maxLane ? el : maxLane;
+            }
+        }
+        std::map<std::string, double> counters = {{"scalar_max", maxScalar}, {"lane8_max", maxLane}};
+        if (limit > 0.0)
+        {
+            counters["glsl_limit"] = limit; // 精度“继承”自公式的函数没有单独的上限
+        }
+        runner.record("precision/" + name, counters);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("glsl_builtins", argc, argv);
+
+    // ---------------------------------------------------------------- 精度
+    std::mt19937 rng(50);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f), wide(-100.0f, 100.0f), mantissa(1.0f, 2.0f);
+    std::uniform_real_distribution<float> exponent(-60.0f, 60.0f), angle(-3.14159265f, 3.14159265f);
+    auto positive = [&](float *x, float *y, float *)
+    {
+        *x = mantissa(rng) * exp2f(floorf(exponent(rng)));
+        *y = mantissa(rng) * exp2f(floorf(exponent(rng)));
+    };
+    auto ulp = [](float got, double ref)
+    { return ulpError(got, ref); };
+    auto absolute = [](float got, double ref)
+    { return fabs(double(got) - ref); };
+    measure(
+        runner, "divide_ulp", 2.5, positive, [](auto x, auto y, auto)
+        { return x / y; },
+        [](double x, double y, double)
+        { return x / y; },
+        ulp);
+    measure(
+        runner, "sqrt_ulp", 0.0, positive, [](auto x, auto, auto)
+        { return sqrt(x); },
+        [](double x, double, double)
+        { return ::sqrt(x); },
+        ulp);
+    measure(
+        runner, "inversesqrt_ulp", 2.0, positive, [](auto x, auto, auto)
+        { return inversesqrt(x); },
+        [](double x, double, double)
+        { return 1.0 / ::sqrt(x); },
+        ulp);
+    // mix / smoothstep 的精度“继承”自定义公式；端点同号时以结果的 ULP 计
+    measure(
+        runner, "mix_ulp", 0.0, [&](float *x, float *y, float *a)
+        { *x = mantissa(rng); *y = mantissa(rng) * 4.0f; *a = unit(rng); },
+        [](auto x, auto y, auto a)
+        { return mix(x, y, a); },
+        [](double x, double y, double a)
+        { return x * (1.0 - a) + y * a; },
+        ulp);
+    measure(
+        runner, "smoothstep_abs", 0.0, [&](float *x, float *, float *)
+        { *x = unit(rng) * 1.2f - 0.1f; },
+        [](auto x, auto, auto)
+        { return smoothstep(0.0f, 1.0f, x); },
+        [](double x, double, double)
+        { double t = x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x); return t * t * (3.0 - 2.0 * t); },
+        absolute);
+    measure(
+        runner, "sin_abs", 1.0 / 2048.0, [&](float *x, float *, float *)
+        { *x = angle(rng); },
+        [](auto x, auto, auto)
+        { return sin(x); },
+        [](double x, double, double)
+        { return ::sin(x); },
+        absolute);
+    measure(
+        runner, "cos_abs_8192", 1.0 / 2048.0, [&](float *x, float *, float *)
+        { *x = angle(rng) * 2607.6f; },
+        [](auto x, auto, auto)
+        { return cos(x); },
+        [](double x, double, double)
+        { return ::cos(x); },
+        absolute);
+    // normalize 的 x 分量：x * inversesqrt(dot(v, v))
+    measure(
+        runner, "normalize_abs", 0.0, [&](float *x, float *y, float *z)
+        { *x = wide(rng); *y = wide(rng); *z = wide(rng); },
+        [](auto x, auto y, auto z)
+        {
+            glmCS::Vector<decltype(x), 3> v(x, y, z);
+            return normalize(v).v[0]; },
+        [](double x, double y, double z)
+        { return x / ::sqrt(x * x + y * y + z * z); },
+        absolute);
+
+    // ---------------------------------------------------------------- 通用函数吞吐
+    size_t n = 4096;
+    Streams s;
+    s.a.resize(n);
+    s.b.resize(n);
+    s.c.resize(n);
+    s.out.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        s.a[i] = wide(rng) * 0.05f;
+        s.b[i] = 0.5f + unit(rng) * 4.0f;
+        s.c[i] = unit(rng);
+    }
+    runWidths(runner, "mix", s, [](auto x, auto y, auto a)
+              { return mix(x, y, a); });
+    runWidths(runner, "clamp", s, [](auto x, auto, auto)
+              { return clamp(x, -1.0f, 1.0f); });
+    runWidths(runner, "step", s, [](auto x, auto, auto)
+              { return step(0.0f, x); });
+    runWidths(runner, "smoothstep", s, [](auto x, auto, auto)
+              { return smoothstep(-1.0f, 1.0f, x); });
+    runWidths(runner, "floor", s, [](auto x, auto, auto)
+              { return floor(x); });
+    runWidths(runner, "fract", s, [](auto x, auto, auto)
+              { return fract(x); });
+    runWidths(runner, "mod", s, [](auto x, auto y, auto)
+              { return mod(x, y); });
+    runWidths(runner, "min", s, [](auto x, auto y, auto)
+              { return min(x, y); });
+    runWidths(runner, "sqrt", s, [](auto, auto y, auto)
+              { return sqrt(y); });
+    runWidths(runner, "inversesqrt", s, [](auto, auto y, auto)
+              { return inversesqrt(y); });
+    runWidths(runner, "sin", s, [](auto x, auto, auto)
+              { return sin(x); });
+    runWidths(runner, "cos", s, [](auto x, auto, auto)
+              { return cos(x); });
+    runWidths(runner, "exp2", s, [](auto x, auto, auto)
+              { return exp2(x); });
+
+    // ---------------------------------------------------------------- 几何函数吞吐
+    Vec3Streams v;
+    v.aosA.resize(n);
+    v.aosB.resize(n);
+    v.aosOut.resize(n);
+    for (size_t k = 0; k < 3; ++k)
+    {
+        v.a[k].resize(n);
+        v.b[k].resize(n);
+        v.out[k].resize(n);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        glmCS::Vec3 a = glmCS::normalize(glmCS::Vec3(wide(rng), wide(rng), wide(rng)));
+        glmCS::Vec3 b = glmCS::normalize(glmCS::Vec3(wide(rng), wide(rng), wide(rng)));
+        v.aosA[i] = a;
+        v.aosB[i] = b;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            v.a[k][i] = a.v[k];
+            v.b[k][i] = b.v[k];
+        }
+    }
+    runVec3Widths(runner, "normalize", v, [](const auto &a, const auto &)
+                  { return normalize(a); });
+    runVec3Widths(runner, "reflect", v, [](const auto &i, const auto &nrm)
+                  { return reflect(i, nrm); });
+    runVec3Widths(runner, "refract", v, [](const auto &i, const auto &nrm)
+                  { return refract(i, nrm, 0.66f); });
+    runVec3Widths(runner, "faceforward", v, [](const auto &i, const auto &nrm)
+                  { return faceforward(nrm, i, nrm); });
+    return 0;
+}
@@ -0,0 +1,323 @@
+/// @ref bench
+/// @file bench_matrix.cpp
+///
+/// @brief Benchmarks for the csmatrix_utils hot paths: single builders, model-matrix composition chains
+/// and batch transforms over arrays of matrices.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "bench_utils.hpp"
+#include "csmatrix_utils.hpp"
+#include "csvector_utils.hpp"
+#include "cstransform_hierarchy.hpp"
+#include "csmatrix_palette.hpp"
+#include "csquaternion_utils.hpp"
+#include "cstrs_utils.hpp"
+#include "csorthonormalize.hpp"
+#include "csframe_arena.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("csmatrix_utils", argc, argv);
+
+    glmCS::Matrix<float, 4, 4> model = glmCS::initIdentityMatrix<float, 4>();
+    model = glmCS::translateMatrix<float>(model, 1.0f, 2.0f, 3.0f);
+    model = glmCS::rotate(30.0f, model, 0, 1, 0);
+    glmCS::Matrix<double, 4, 4> modeld = glmCS::initIdentityMatrix<double, 4>();
+    modeld = glmCS::translateMatrix<double>(modeld, 1.0, 2.0, 3.0);
+    volatile float angle = 37.0f;
+
+    // ---------------------------------------------------------------- builders
+    runner.run("initIdentityMatrix<float,4>", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::initIdentityMatrix<float, 4>(); doNotOptimize(m); });
+    runner.run("matrixMultiply<float,4,4>", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::matrixMultiply(model, model.mat); doNotOptimize(m); });
+    runner.run("matrixMultiply<double,4,4>", 1, [&]()
+               { glmCS::Matrix<double, 4, 4> m = glmCS::matrixMultiply(modeld, modeld.mat); doNotOptimize(m); });
+    runner.run("rotate/x", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::rotate(angle, model, 1, 0, 0); doNotOptimize(m); });
+    runner.run("rotate/z", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::rotate(angle, model, 0, 0, 1); doNotOptimize(m); });
+    runner.run("translateMatrix<float>", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::translateMatrix<float>(model, 1.0f, angle, 3.0f); doNotOptimize(m); });
+    runner.run("scaleMatrix<float>", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::scaleMatrix<float>(model, 1.0f, angle, 3.0f); doNotOptimize(m); });
+    runner.run("lookAt", 1, [&]()
+               {
+                   glmCS::Matrix<float, 4, 4> m = glmCS::lookAt(glmCS::vec3(0.0f, angle, 3.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+                   doNotOptimize(m); });
+    runner.run("perspective", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::perspective(angle * 0.01f, 4.0f / 3.0f, 0.01f, 100.0f); doNotOptimize(m); });
+    runner.run("rotate<double>/z", 1, [&]()
+               { glmCS::Matrix<double, 4, 4> m = glmCS::rotate(double(angle), modeld, 0, 0, 1); doNotOptimize(m); });
+    runner.run("cameraRelativeMatrix", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::cameraRelativeMatrix(modeld, glmCS::dvec3(1e7, angle, 2e7)); doNotOptimize(m); });
+    runner.run("modelViewMatrix<double->float>", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::modelViewMatrix(modeld, modeld); doNotOptimize(m); });
+
+    // ---------------------------------------------------------------- vectors
+    runner.run("normalize/Vector3(sqrt)", 1, [&]()
+               {
+                   glmCS::Vector3 v = glmCS::vec3(1.0f, angle, 3.0f);
+                   glmCS::normalize(&v);
+                   doNotOptimize(v); });
+    runner.run("normalize/Vec3(rsqrt+newton)", 1, [&]()
+               { glmCS::Vec3 v = glmCS::normalize(glmCS::Vec3(1.0f, angle, 3.0f)); doNotOptimize(v); });
+    runner.run("mat4*vec4", 1, [&]()
+               { glmCS::Vec4 v = model * glmCS::Vec4(1.0f, angle, 3.0f, 1.0f); doNotOptimize(v); });
+
+    // ---------------------------------------------------------------- composition chains
+    // 典型的模型矩阵：单位矩阵 -> 平移 -> 旋转 -> 缩放
+    runner.run("chain/identity_translate_rotate_scale", 1, [&]()
+               {
+                   glmCS::Matrix<float, 4, 4> m = glmCS::initIdentityMatrix<float, 4>();
+                   m = glmCS::translateMatrix<float>(m, 4.0f, 5.0f, 6.0f);
+                   m = glmCS::rotate(angle, m, 0, 0, 1);
+                   m = glmCS::scaleMatrix<float>(m, 2.0f, 2.0f, 2.0f);
+                   doNotOptimize(m); });
+    // 每帧的 model * view * projection
+    glmCS::Matrix<float, 4, 4> view = glmCS::lookAt(glmCS::vec3(0.0f, 0.0f, 3.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+    glmCS::Matrix<float, 4, 4> proj = glmCS::perspective(0.785f, 4.0f / 3.0f, 0.01f, 100.0f);
+    runner.run("chain/model_view_projection", 1, [&]()
+               {
+                   glmCS::Matrix<float, 4, 4> m = glmCS::rotate(angle, model, 0, 1, 0);
+                   m = glmCS::matrixMultiply(m, view.mat);
+                   m = glmCS::matrixMultiply(m, proj.mat);
+                   doNotOptimize(m); });
+    runner.run("chain/rotate_xyz", 1, [&]()
+               {
+                   glmCS::Matrix<float, 4, 4> m = glmCS::rotate(angle, model, 1, 0, 0);
+                   m = glmCS::rotate(angle, m, 0, 1, 0);
+                   m = glmCS::rotate(angle, m, 0, 0, 1);
+                   doNotOptimize(m); });
+
+    // ---------------------------------------------------------------- batch transforms
+    const size_t counts[] = {64, 4096, 65536};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const size_t n = counts[c];
+        std::vector<glmCS::Matrix<float, 4, 4>> models(n), out(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            models[i] = glmCS::translateMatrix<float>(glmCS::initIdentityMatrix<float, 4>(), float(i), 0.0f, 1.0f);
+        }
+        glmCS::Matrix<float, 4, 4> vp = glmCS::matrixMultiply(view, proj.mat);
+        runner.run("batch/matrixMultiply_by_vp/" + std::to_string(n), double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           out[i] = glmCS::matrixMultiply(models[i], vp.mat);
+                       }
+                       doNotOptimize(out[n - 1]); });
+        runner.run("batch/trs_build/" + std::to_string(n), double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           glmCS::Matrix<float, 4, 4> m = glmCS::initIdentityMatrix<float, 4>();
+                           m = glmCS::translateMatrix<float>(m, float(i), 0.0f, 1.0f);
+                           m = glmCS::rotate(angle + float(i), m, 0, 1, 0);
+                           out[i] = glmCS::scaleMatrix<float>(m, 1.0f, 2.0f, 1.0f);
+                       }
+                       doNotOptimize(out[n - 1]); });
+    }
+
+    // ---------------------------------------------------------------- skinning palette
+    {
+        const size_t bones = 100000;
+        std::vector<glmCS::Matrix<float, 4, 4>> inverseBind(bones), pose(bones), palette(bones);
+        for (size_t i = 0; i < bones; ++i)
+        {
+            inverseBind[i] = glmCS::translateMatrix<float>(glmCS::initIdentityMatrix<float, 4>(), -float(i), 0.0f, 0.0f);
+            pose[i] = glmCS::rotate(float(i % 360), model, 0, 1, 0);
+        }
+        runner.run("palette/matrixMultiply_loop/100000", double(bones), [&]()
+                   {
+                       for (size_t i = 0; i < bones; ++i)
+                       {
+                           palette[i] = glmCS::matrixMultiply(inverseBind[i], pose[i].mat);
+                       }
+                       doNotOptimize(palette[bones - 1]); });
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("palette/buildMatrixPalette/100000/" + std::to_string(threads[t]) + "threads", double(bones), [&]()
+                       {
+                           glmCS::buildMatrixPalette(inverseBind.data(), pose.data(), bones, palette.data(), threads[t]);
+                           doNotOptimize(palette[bones - 1]); });
+        }
+    }
+
+    // ---------------------------------------------------------------- instance TRS
+    {
+        size_t n = 100000;
+        std::vector<float> tx(n), ty(n), tz(n), qx(n), qy(n), qz(n), qw(n), sx(n), sy(n), sz(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            glmCS::Quaternion<float> q = glmCS::quaternionFromAxisAngle<float>(float(i % 360), glmCS::Vector3T<float>{0.0f, 1.0f, 0.0f});
+            tx[i] = float(i);
+            ty[i] = 1.0f;
+            tz[i] = -float(i);
+            qx[i] = q.x;
+            qy[i] = q.y;
+            qz[i] = q.z;
+            qw[i] = q.w;
+            sx[i] = sy[i] = sz[i] = 1.0f + float(i % 7) * 0.25f;
+        }
+        glmCS::TRSArraysSoA trs = {tx.data(), ty.data(), tz.data(), qx.data(), qy.data(), qz.data(), qw.data(), sx.data(), sy.data(), sz.data()};
+        std::vector<glmCS::Matrix<float, 4, 4>> instances(n);
+        std::vector<float> instances3x4(n * 12);
+        runner.run("trs/quaternion_chain/100000", double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           glmCS::Matrix<float, 4, 4> m = glmCS::scaleMatrix<float>(glmCS::initIdentityMatrix<float, 4>(), sx[i], sy[i], sz[i]);
+                           m = glmCS::matrixMultiply(m, glmCS::quaternionToMatrix(glmCS::quaternion(qx[i], qy[i], qz[i], qw[i])).mat);
+                           instances[i] = glmCS::translateMatrix<float>(m, tx[i], ty[i], tz[i]);
+                       }
+                       doNotOptimize(instances[n - 1]); });
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            std::string suffix = "/100000/" + std::to_string(threads[t]) + "threads";
+            runner.run("trs/buildTRSMatrices" + suffix, double(n), [&]()
+                       {
+                           glmCS::buildTRSMatrices(trs, n, instances.data(), threads[t]);
+                           doNotOptimize(instances[n - 1]); });
+            runner.run("trs/buildTRSMatrices3x4" + suffix, double(n), [&]()
+                       {
+                           glmCS::buildTRSMatrices3x4(trs, n, instances3x4.data(), threads[t]);
+                           doNotOptimize(instances3x4[n * 12 - 1]); });
+        }
+
+        glmCS::buildTRSMatrices(trs, n, instances.data());
+        std::vector<glmCS::Vector3> translations(n), scales(n);
+        std::vector<glmCS::Quaternion<float>> rotations(n);
+        runner.run("trs/decomposeTRS_loop/100000", double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           glmCS::decomposeTRS(instances[i], &translations[i], &rotations[i], &scales[i]);
+                       }
+                       doNotOptimize(rotations[n - 1]); });
+        glmCS::TRSSoABuffer decomposed;
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("trs/decomposeTRSMatrices/100000/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       {
+                           glmCS::decomposeTRSMatrices(instances.data(), n, decomposed, threads[t]);
+                           doNotOptimize(decomposed.rotationW[n - 1]); });
+        }
+    }
+
+    // ---------------------------------------------------------------- re-orthonormalization
+    {
+        size_t n = 100000;
+        std::vector<glmCS::Matrix<float, 4, 4>> rotations(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            rotations[i] = glmCS::rotate(float(i % 360), model, 0, 1, 0);
+            rotations[i].mat[0][0] *= 1.001f;
+        }
+        runner.run("orthonormal/maxOrthonormalDrift/100000", double(n), [&]()
+                   { doNotOptimize(glmCS::maxOrthonormalDrift(rotations.data(), n)); });
+        runner.run("orthonormal/orthonormalize_loop/100000", double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           rotations[i] = glmCS::orthonormalize(rotations[i]);
+                       }
+                       doNotOptimize(rotations[n - 1]); });
+        runner.run("orthonormal/orthonormalizeMatrices_polar/100000", double(n), [&]()
+                   { doNotOptimize(glmCS::orthonormalizeMatrices(rotations.data(), n, -1.0f)); });
+        runner.run("orthonormal/orthonormalizeMatrices_gram_schmidt/100000", double(n), [&]()
+                   { doNotOptimize(glmCS::orthonormalizeMatrices(rotations.data(), n, -1.0f, glmCS::GLMCS_orthonormalize_gram_schmidt)); });
+        runner.run("orthonormal/orthonormalizeMatrices_within_tolerance/100000", double(n), [&]()
+                   { doNotOptimize(glmCS::orthonormalizeMatrices(rotations.data(), n, 1e-4f)); });
+    }
+
+    // ---------------------------------------------------------------- frame arena
+    {
+        // 每帧 16 个临时矩阵数组（每个 256 个），写入后丢弃
+        size_t arrays = 16, perArray = 256;
+        runner.run("arena/std_vector_per_frame/16x256", double(arrays * perArray), [&]()
+                   {
+                       for (size_t a = 0; a < arrays; ++a)
+                       {
+                           std::vector<glmCS::Matrix<float, 4, 4>> tmp(perArray);
+                           for (size_t i = 0; i < perArray; ++i)
+                           {
+                               tmp[i] = model;
+                           }
+                           doNotOptimize(tmp[perArray - 1]);
+                       } });
+        glmCS::FrameArena arena(size_t(1) << 20);
+        runner.run("arena/FrameArena_per_frame/16x256", double(arrays * perArray), [&]()
+                   {
+                       for (size_t a = 0; a < arrays; ++a)
+                       {
+                           glmCS::Matrix<float, 4, 4> *tmp = arena.allocateArray<glmCS::Matrix<float, 4, 4>>(perArray);
+                           for (size_t i = 0; i < perArray; ++i)
+                           {
+                               tmp[i] = model;
+                           }
+                           doNotOptimize(tmp[perArray - 1]);
+                       }
+                       arena.reset(); });
+        runner.run("arena/FrameVector_per_frame/16x256", double(arrays * perArray), [&]()
+                   {
+                       for (size_t a = 0; a < arrays; ++a)
+                       {
+                           glmCS::FrameVector<glmCS::Matrix<float, 4, 4>> tmp(perArray, model, glmCS::FrameAllocator<glmCS::Matrix<float, 4, 4>>(arena));
+                           doNotOptimize(tmp[perArray - 1]);
+                       }
+                       arena.reset(); });
+    }
+
+    // ---------------------------------------------------------------- transform hierarchy
+    {
+        // 单一场景根 + 64 个角色，每个角色 4 层、每层 4 个子节点
+        glmCS::TransformHierarchy scene;
+        glmCS::Matrix<float, 4, 4> offset = glmCS::translateMatrix<float>(glmCS::initIdentityMatrix<float, 4>(), 0.1f, 0.2f, 0.0f);
+        uint32_t root = scene.addNode(glmCS::TransformHierarchy::npos, offset);
+        std::vector<uint32_t> level, next;
+        for (int c = 0; c < 64; ++c)
+        {
+            level.assign(1, scene.addNode(root, offset));
+            for (int depth = 0; depth < 4; ++depth)
+            {
+                next.clear();
+                for (size_t i = 0; i < level.size(); ++i)
+                {
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        next.push_back(scene.addNode(level[i], offset));
+                    }
+                }
+                level.swap(next);
+            }
+        }
+        scene.update();
+        const size_t nodes = scene.size();
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            std::string suffix = "/" + std::to_string(nodes) + "nodes/" + std::to_string(threads[t]) + "threads";
+            runner.run("hierarchy/update_all" + suffix, double(nodes), [&]()
+                       {
+                           scene.setLocal(root, offset);
+                           scene.update(threads[t]);
+                           doNotOptimize(scene.worldMatrices()[nodes - 1]); });
+            runner.run("hierarchy/update_1pct_dirty" + suffix, double(nodes), [&]()
+                       {
+                           for (size_t i = 0; i < nodes / 100; ++i)
+                           {
+                               scene.setLocal(uint32_t(1 + (i * 97) % (nodes - 1)), offset);
+                           }
+                           scene.update(threads[t]);
+                           doNotOptimize(scene.worldMatrices()[nodes - 1]); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/// @ref bench
+/// @file bench_occlusion.cpp
+///
+/// @brief Software occlusion culling: a street of 64 box-shaped buildings (768 occluder triangles) is rasterized
+/// into a 256x128 depth buffer, then 16384 object boxes scattered behind and between them are tested. The
+/// rasterize cases include queuing (transform, near clipping and triangle setup). The share of boxes proven hidden
+/// is reported under "occlusion/test_aabbs/stats".
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+#include "cscamera.hpp"
+#include "csocclusion.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+namespace
+{
+    // 单位立方体的 8 个顶点与 12 个三角形
+    void appendBox(std::vector<float> &positions, std::vector<uint32_t> &indices, float cx, float cy, float cz, float ex, float ey, float ez)
+    {
+        static const uint32_t faces[36] = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                                           2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+        uint32_t base = uint32_t(positions.size() / 3);
+        for (size_t k = 0; k < 8; ++k)
+        {
+            positions.push_back(cx + ((k & 1) ? ex : -ex));
+            positions.push_back(cy + ((k & 2) ? ey : -ey));
+            positions.push_back(cz + ((k & 4) ? ez : -ez));
+        }
+        for (size_t k = 0; k < 36; ++k)
+        {
+            indices.push_back(base + faces[k]);
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("csocclusion", argc, argv);
+
+    glmCS::Camera camera;
+    camera.setPerspective(1.2f, 2.0f, 0.1f, 500.0f);
+    camera.setLookAt(glmCS::vec3(0.0f, 1.7f, 0.0f), glmCS::vec3(0.0f, 1.7f, -1.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+    const glmCS::Matrix<float, 4, 4> &viewProjection = camera.viewProjection();
+
+    // 街道两侧的建筑：8 排 x 8 列
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    for (size_t row = 0; row < 8; ++row)
+    {
+        for (size_t col = 0; col < 8; ++col)
+        {
+            float x = (float(col) - 3.5f) * 12.0f + (col < 4 ? -4.0f : 4.0f);
+            appendBox(positions, indices, x, 8.0f, -15.0f - float(row) * 20.0f, 5.0f, 8.0f, 5.0f);
+        }
+    }
+    size_t vertexCount = positions.size() / 3, triangleCount = indices.size() / 3;
+
+    // 物体：散布在建筑之间与之后
+    size_t n = 16384;
+    std::vector<float> cx(n), cy(n), cz(n), extent(n, 0.5f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        cx[i] = float((i * 7919) % 1000) * 0.12f - 60.0f;
+        cy[i] = float((i * 104729) % 100) * 0.05f + 0.5f;
+        cz[i] = -float((i * 15485863) % 1000) * 0.2f - 5.0f;
+    }
+    glmCS::AABBArraysSoA boxes = {cx.data(), cy.data(), cz.data(), extent.data(), extent.data(), extent.data()};
+    std::vector<uint32_t> mask((n + 31) / 32);
+
+    glmCS::OcclusionCuller culler(256, 128);
+    const unsigned threadCounts[] = {1, 4};
+    for (size_t t = 0; t < 2; ++t)
+    {
+        unsigned threads = threadCounts[t];
+        std::string suffix = threads > 1 ? "_" + std::to_string(threads) + "threads" : "";
+        runner.run("occlusion/rasterize" + suffix + "/" + std::to_string(triangleCount), double(triangleCount), [&]()
+                   {
+                       culler.clear();
+                       culler.addOccluder(positions.data(), vertexCount, indices.data(), triangleCount, viewProjection);
+                       culler.rasterize(threads);
+                       doNotOptimize(culler); });
+    }
+    for (size_t t = 0; t < 2; ++t)
+    {
+        unsigned threads = threadCounts[t];
+        std::string suffix = threads > 1 ? "_" + std::to_string(threads) + "threads" : "";
+        runner.run("occlusion/test_aabbs" + suffix + "/" + std::to_string(n), double(n), [&]()
+                   {
+                       std::fill(mask.begin(), mask.end(), ~0u);
+                       culler.testAABBs(boxes, n, viewProjection, mask.data(), threads);
+                       doNotOptimize(mask.data()); });
+    }
+    std::vector<uint32_t> indicesOut(n);
+    double visible = double(glmCS::maskToIndices(mask.data(), n, indicesOut.data()));
+    runner.record("occlusion/test_aabbs/stats", {{"hidden_fraction", 1.0 - visible / double(n)}});
+    return 0;
+}
@@ -0,0 +1,209 @@
+/// @ref bench
+/// @file bench_projection.cpp
+///
+/// @brief Projection builders: throughput of every variant and a depth-precision table.
+/// For view distances sampled logarithmically in [near, far], the view-space point is projected with the float
+/// matrix, the window depth is stored as float32 and as 24-bit unorm, and the distance is reconstructed in double
+/// with the analytic inverse. The relative reconstruction error (max / mean / at the far end) is reported per
+/// variant under "precision/<variant>/<depth format>". The camera/* cases compare recomputing lookAt + perspective
+/// for each of 4 per-frame queries (view-projection + frustum) with the cached glmCS::Camera. The shadow/* cases
+/// compare scalar lookAt() calls with the SoA batch builder and time cubemap face views and 4-cascade fitting.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <functional>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csprojection_utils.hpp"
+#include "cscamera.hpp"
+#include "csshadow_utils.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+struct Variant
+{
+    const char *name;
+    bool zeroToOne; // 深度范围为 [0,1]
+    std::function<glmCS::Projection<float>(float, float, float, float)> buildFloat;
+    std::function<glmCS::Projection<double>(double, double, double, double)> buildDouble;
+};
+
+static void measurePrecision(glmcs_bench::Runner &runner, const Variant &v, float nearPlane, float farPlane)
+{
+    const float fov = 1.0f, aspect = 16.0f / 9.0f;
+    glmCS::Projection<float> pf = v.buildFloat(fov, aspect, nearPlane, farPlane);
+    glmCS::Projection<double> pd = v.buildDouble(fov, aspect, nearPlane, farPlane);
+    const int samples = 4096;
+    const char *formats[] = {"float32", "unorm24"};
+    for (int format = 0; format < 2; ++format)
+    {
+        double maxErr = 0.0, sumErr = 0.0, farErr = 0.0;
+        for (int s = 0; s < samples; ++s)
+        {
+            double t = double(s) / double(samples - 1);
+            double dist = double(nearPlane) * pow(double(farPlane) / double(nearPlane), t);
+            float z = -float(dist);
+            // 单精度投影（GPU 上的顶点变换）
+            float cz = pf.matrix.mat[2][2] * z + pf.matrix.mat[3][2];
+            float cw = pf.matrix.mat[2][3] * z + pf.matrix.mat[3][3];
+            float ndc = cz / cw;
+            float window = v.zeroToOne ? ndc : ndc * 0.5f + 0.5f;
+            double stored = window;
+            if (format == 1)
+            {
+                const double scale = double((1 << 24) - 1);
+                double clamped = window < 0.0f ? 0.0 : (window > 1.0f ? 1.0 : double(window));
+                stored = floor(clamped * scale + 0.5) / scale;
+            }
+            double ndcStored = v.zeroToOne ? stored : stored * 2.0 - 1.0;
+            double reconstructed = glmCS::linearizeDepth(pd, ndcStored);
+            double err = fabs(reconstructed - dist) / dist;
+            if (!(err == err) || err > 1.0)
+            {
+                err = 1.0; // 深度塌缩为同一值或溢出
+            }
+            maxErr = err > maxErr ? err : maxErr;
+            sumErr += err;
+            if (s == samples - 1)
+            {
+                farErr = err;
+            }
+        }
+        char name[128];
+        snprintf(name, sizeof(name), "precision/%s/%s/near%g_far%g", v.name, formats[format], nearPlane, farPlane);
+        runner.record(name, {{"max_rel_error", maxErr}, {"mean_rel_error", sumErr / samples}, {"far_rel_error", farErr}});
+    }
+}
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("projection", argc, argv);
+
+    std::vector<Variant> variants = {
+        {"gl_minus1_1", false,
+         [](float f, float a, float n, float z)
+         { return glmCS::perspectiveWithInverse<float>(f, a, n, z); },
+         [](double f, double a, double n, double z)
+         { return glmCS::perspectiveWithInverse<double>(f, a, n, z); }},
+        {"zero_to_one", true,
+         [](float f, float a, float n, float z)
+         { return glmCS::perspectiveZO<float>(f, a, n, z); },
+         [](double f, double a, double n, double z)
+         { return glmCS::perspectiveZO<double>(f, a, n, z); }},
+        {"reverse_z", true,
+         [](float f, float a, float n, float z)
+         { return glmCS::perspectiveReverseZ<float>(f, a, n, z); },
+         [](double f, double a, double n, double z)
+         { return glmCS::perspectiveReverseZ<double>(f, a, n, z); }},
+        {"infinite_gl", false,
+         [](float f, float a, float n, float)
+         { return glmCS::perspectiveInfinite<float>(f, a, n); },
+         [](double f, double a, double n, double)
+         { return glmCS::perspectiveInfinite<double>(f, a, n); }},
+        {"infinite_reverse_z", true,
+         [](float f, float a, float n, float)
+         { return glmCS::perspectiveInfiniteReverseZ<float>(f, a, n); },
+         [](double f, double a, double n, double)
+         { return glmCS::perspectiveInfiniteReverseZ<double>(f, a, n); }},
+        {"orthographic_zo", true,
+         [](float, float, float n, float z)
+         { return glmCS::orthographic<float>(-1, 1, -1, 1, n, z, true); },
+         [](double, double, double n, double z)
+         { return glmCS::orthographic<double>(-1, 1, -1, 1, n, z, true); }},
+    };
+
+    // ---------------------------------------------------------------- depth precision
+    const float ranges[][2] = {{0.1f, 1000.0f}, {0.01f, 100000.0f}};
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r)
+    {
+        for (size_t i = 0; i < variants.size(); ++i)
+        {
+            measurePrecision(runner, variants[i], ranges[r][0], ranges[r][1]);
+        }
+    }
+
+    // ---------------------------------------------------------------- builder throughput
+    volatile float fov = 1.0f;
+    runner.run("build/perspective", 1, [&]()
+               { glmCS::Matrix<float, 4, 4> m = glmCS::perspective(fov, 1.5f, 0.1f, 100.0f); doNotOptimize(m); });
+    for (size_t i = 0; i < variants.size(); ++i)
+    {
+        const Variant &v = variants[i];
+        runner.run(std::string("build/") + v.name + "+inverse", 1, [&]()
+                   { glmCS::Projection<float> p = v.buildFloat(fov, 1.5f, 0.1f, 100.0f); doNotOptimize(p); });
+    }
+    runner.run("unproject/linearizeDepth", 1, [&]()
+               {
+                   static const glmCS::Projection<float> p = glmCS::perspectiveInfiniteReverseZ(1.0f, 1.5f, 0.1f);
+                   float d = glmCS::linearizeDepth(p, fov * 0.01f);
+                   doNotOptimize(d); });
+
+    // ---------------------------------------------------------------- camera: 4 systems query VP + frustum per frame
+    const size_t queries = 4;
+    volatile float eyeX = 1.0f;
+    runner.run("camera/recompute_per_query", double(queries), [&]()
+               {
+                   for (size_t q = 0; q < queries; ++q)
+                   {
+                       glmCS::Matrix<float, 4, 4> view = glmCS::lookAt(glmCS::vec3(eyeX, 2.0f, 5.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+                       glmCS::Matrix<float, 4, 4> vp = glmCS::matrixMultiply(view, glmCS::perspective(fov, 1.5f, 0.1f, 100.0f).mat);
+                       glmCS::Frustum f = glmCS::extractFrustum(vp);
+                       doNotOptimize(f);
+                   } });
+    glmCS::Camera camera;
+    camera.setPerspective(fov, 1.5f, 0.1f, 100.0f);
+    camera.setLookAt(glmCS::vec3(eyeX, 2.0f, 5.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+    runner.run("camera/cached_queries", double(queries), [&]()
+               {
+                   for (size_t q = 0; q < queries; ++q)
+                   {
+                       doNotOptimize(camera.viewProjection());
+                       doNotOptimize(camera.frustum());
+                   } });
+    float step = 0.0f;
+    runner.run("camera/move_then_queries", double(queries), [&]()
+               {
+                   camera.setPosition(glmCS::vec3(eyeX + (step += 1e-3f), 2.0f, 5.0f));
+                   for (size_t q = 0; q < queries; ++q)
+                   {
+                       doNotOptimize(camera.viewProjection());
+                       doNotOptimize(camera.frustum());
+                   } });
+
+    // ---------------------------------------------------------------- shadow views: n spot-light lookAt / n / 6 cube lights
+    size_t n = 6144;
+    std::vector<float> soa[9];
+    for (size_t k = 0; k < 9; ++k)
+    {
+        soa[k].resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            // eye / target 散布在场景中，up 固定为 +Y
+            soa[k][i] = k >= 6 ? (k == 7 ? 1.0f : 0.0f) : float((i * 7919 + k * 104729) % 2000) * 0.01f - 10.0f;
+        }
+    }
+    std::vector<glmCS::Matrix<float, 4, 4>> views(n);
+    const std::string suffix = "/" + std::to_string(n);
+    runner.run("shadow/lookAt_scalar" + suffix, double(n), [&]()
+               {
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       views[i] = glmCS::lookAt(glmCS::vec3(soa[0][i], soa[1][i], soa[2][i]), glmCS::vec3(soa[3][i], soa[4][i], soa[5][i]),
+                                                glmCS::vec3(soa[6][i], soa[7][i], soa[8][i]));
+                   }
+                   doNotOptimize(views.data()); });
+    glmCS::LookAtArraysSoA spots = {soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(), soa[5].data(),
+                                    soa[6].data(), soa[7].data(), soa[8].data()};
+    runner.run("shadow/lookAt_batch" + suffix, double(n), [&]()
+               { glmCS::buildLookAtMatrices(spots, n, views.data()); doNotOptimize(views.data()); });
+    runner.run("shadow/lookAt_batch_4threads" + suffix, double(n), [&]()
+               { glmCS::buildLookAtMatrices(spots, n, views.data(), 4); doNotOptimize(views.data()); });
+    runner.run("shadow/cubemap_views" + suffix, double(n), [&]()
+               { glmCS::buildCubemapViews(soa[0].data(), soa[1].data(), soa[2].data(), n / 6, views.data()); doNotOptimize(views.data()); });
+    glmCS::ShadowCascade cascades[4];
+    runner.run("shadow/cascades_4", 4, [&]()
+               {
+                   glmCS::buildShadowCascades(camera, glmCS::vec3(-0.3f, -1.0f, -0.2f), 4, 200.0f, 0.75f, 2048.0f, cascades);
+                   doNotOptimize(cascades); });
+    return 0;
+}
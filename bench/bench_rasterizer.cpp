@@ -0,0 +1,119 @@
+/// @ref bench
+/// @file bench_rasterizer.cpp
+///
+/// @brief Headless software rasterizer throughput at 512x512: fill rate with a flat-colour fullscreen quad, and a
+/// Lambert-lit UV sphere (8064 triangles, normal varyings, depth test) with 1 and 4 threads. items/s counts frame
+/// pixels per second. The sphere case includes the vertex transform.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+#include "cscamera.hpp"
+#include "cssoftware_rasterizer.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+namespace
+{
+    // UV 球：位置与法线（单位球上二者相同）
+    void buildSphere(size_t rings, size_t segments, std::vector<float> &positions, std::vector<uint32_t> &indices)
+    {
+        for (size_t r = 0; r <= rings; ++r)
+        {
+            float theta = float(r) / float(rings) * 3.14159265f;
+            for (size_t s = 0; s <= segments; ++s)
+            {
+                float phi = float(s) / float(segments) * 6.28318531f;
+                positions.push_back(sinf(theta) * cosf(phi));
+                positions.push_back(cosf(theta));
+                positions.push_back(sinf(theta) * sinf(phi));
+            }
+        }
+        for (size_t r = 0; r < rings; ++r)
+        {
+            for (size_t s = 0; s < segments; ++s)
+            {
+                uint32_t a = uint32_t(r * (segments + 1) + s), b = a + uint32_t(segments + 1);
+                if (r != 0)
+                {
+                    indices.insert(indices.end(), {a, a + 1, b});
+                }
+                if (r + 1 != rings)
+                {
+                    indices.insert(indices.end(), {a + 1, b + 1, b});
+                }
+            }
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("cssoftware_rasterizer", argc, argv);
+
+    const size_t size = 512;
+    const double pixels = double(size * size);
+    glmCS::SoftwareRasterizer raster(size, size);
+    std::vector<uint8_t> image(size * size * 4);
+
+    // ---------------------------------------------------------------- fill rate
+    const float quad[] = {-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f};
+    const uint32_t quadIndices[] = {0, 1, 2, 0, 2, 3};
+    auto flat = [](const glmCS::FragmentLanes &, glmCS::FragmentOutput &out)
+    {
+        for (size_t l = 0; l < glmCS::FragmentLanes::width; ++l)
+        {
+            out.color[0][l] = 0.2f;
+            out.color[1][l] = 0.4f;
+            out.color[2][l] = 0.8f;
+            out.color[3][l] = 1.0f;
+        }
+    };
+    runner.run("fill/fullscreen_quad/" + std::to_string(size), pixels, [&]()
+               {
+                   raster.clear(0.0f, 0.0f, 0.0f, 1.0f);
+                   raster.drawIndexed(quad, nullptr, 0, 4, quadIndices, 2, flat);
+                   doNotOptimize(raster); });
+
+    // ---------------------------------------------------------------- lit sphere
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    buildSphere(64, 64, positions, indices);
+    size_t vertexCount = positions.size() / 3, triangleCount = indices.size() / 3;
+    std::vector<float> clip(vertexCount * 4);
+    glmCS::Camera camera;
+    camera.setPerspective(0.8f, 1.0f, 0.1f, 100.0f);
+    camera.setLookAt(glmCS::vec3(0.0f, 0.5f, 2.6f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+    auto lambert = [](const glmCS::FragmentLanes &in, glmCS::FragmentOutput &out)
+    {
+        for (size_t l = 0; l < glmCS::FragmentLanes::width; ++l)
+        {
+            float nx = in.varyings[0][l], ny = in.varyings[1][l], nz = in.varyings[2][l];
+            float diffuse = (nx * 0.48f + ny * 0.64f + nz * 0.6f) / sqrtf(nx * nx + ny * ny + nz * nz);
+            diffuse = diffuse > 0.0f ? diffuse : 0.0f;
+            out.color[0][l] = 0.1f + 0.9f * diffuse;
+            out.color[1][l] = 0.1f + 0.6f * diffuse;
+            out.color[2][l] = 0.1f + 0.3f * diffuse;
+            out.color[3][l] = 1.0f;
+        }
+    };
+    raster.setCullMode(glmCS::GLMCS_cull_back);
+    const unsigned threadCounts[] = {1, 4};
+    for (size_t t = 0; t < 2; ++t)
+    {
+        unsigned threads = threadCounts[t];
+        std::string suffix = threads > 1 ? "_" + std::to_string(threads) + "threads" : "";
+        runner.run("sphere/lambert" + suffix + "/" + std::to_string(triangleCount), pixels, [&]()
+                   {
+                       raster.clear(0.0f, 0.0f, 0.0f, 1.0f);
+                       glmCS::transformPositions(positions.data(), vertexCount, camera.viewProjection(), clip.data());
+                       raster.drawIndexed(clip.data(), positions.data(), 3, vertexCount, indices.data(), triangleCount, lambert, threads);
+                       doNotOptimize(raster); });
+    }
+    runner.run("readback/rgba8_top_down/" + std::to_string(size), pixels, [&]()
+               { raster.readColor(image.data(), true); doNotOptimize(image.data()); });
+    return 0;
+}
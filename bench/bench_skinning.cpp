@@ -0,0 +1,110 @@
+/// @ref bench
+/// @file bench_skinning.cpp
+///
+/// @brief Benchmarks for CPU skinning: the straightforward per-vertex Matrix loop versus the csskinning kernels
+/// (linear blend and dual quaternion), single- and multi-threaded. Throughput is reported in vertices per second; each vertex reads 48 bytes and
+/// writes 32 bytes.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <random>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csmatrix_utils.hpp"
+#include "csvector_utils.hpp"
+#include "csmatrix_palette.hpp"
+#include "csquaternion_utils.hpp"
+#include "csskinning.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("skinning", argc, argv);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f), angle(0.0f, 360.0f);
+
+    const size_t bones = 256;
+    std::vector<glmCS::Matrix<float, 4, 4>> inverseBind(bones), pose(bones), palette(bones);
+    for (size_t b = 0; b < bones; ++b)
+    {
+        inverseBind[b] = glmCS::translateMatrix<float>(glmCS::initIdentityMatrix<float, 4>(), unit(rng), unit(rng), unit(rng));
+        pose[b] = glmCS::rotate(angle(rng), glmCS::initIdentityMatrix<float, 4>(), 0, 1, 0);
+    }
+    glmCS::buildMatrixPalette(inverseBind.data(), pose.data(), bones, palette.data());
+    std::vector<glmCS::DualQuaternion<float>> dqPalette(bones);
+    for (size_t b = 0; b < bones; ++b)
+    {
+        dqPalette[b] = glmCS::dualQuaternionFromMatrix(palette[b]);
+    }
+
+    const size_t counts[] = {10000, 1000000};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const size_t n = counts[c];
+        std::vector<glmCS::SkinVertex> vertices(n);
+        std::vector<glmCS::SkinnedVertex> out(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            glmCS::SkinVertex &v = vertices[i];
+            for (size_t k = 0; k < 3; ++k)
+            {
+                v.position[k] = unit(rng) * 10.0f;
+                v.normal[k] = unit(rng);
+            }
+            float sum = 0.0f;
+            for (size_t k = 0; k < 4; ++k)
+            {
+                v.weights[k] = unit(rng) + 1.0f;
+                v.indices[k] = uint16_t(rng() % bones);
+                sum += v.weights[k];
+            }
+            for (size_t k = 0; k < 4; ++k)
+            {
+                v.weights[k] /= sum;
+            }
+        }
+
+        // 逐顶点用 Matrix 与 Vec4 混合、变换
+        runner.run("skin/matrix_loop/" + std::to_string(n), double(n), [&]()
+                   {
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           const glmCS::SkinVertex &v = vertices[i];
+                           glmCS::Matrix<float, 4, 4> m;
+                           for (size_t r = 0; r < 4; ++r)
+                           {
+                               for (size_t e = 0; e < 4; ++e)
+                               {
+                                   m.mat[r][e] = 0.0f;
+                                   for (size_t k = 0; k < 4; ++k)
+                                   {
+                                       m.mat[r][e] += v.weights[k] * palette[v.indices[k]].mat[r][e];
+                                   }
+                               }
+                           }
+                           glmCS::Vec4 p = m * glmCS::Vec4(v.position[0], v.position[1], v.position[2], 1.0f);
+                           glmCS::Vec4 nrm = m * glmCS::Vec4(v.normal[0], v.normal[1], v.normal[2], 0.0f);
+                           for (size_t e = 0; e < 4; ++e)
+                           {
+                               out[i].position[e] = p[e];
+                               out[i].normal[e] = nrm[e];
+                           }
+                       }
+                       doNotOptimize(out[n - 1]); });
+
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("skin/skinVertices/" + std::to_string(n) + "/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       {
+                           glmCS::skinVertices(vertices.data(), n, palette.data(), out.data(), threads[t]);
+                           doNotOptimize(out[n - 1]); });
+            runner.run("skin/skinVerticesDQ/" + std::to_string(n) + "/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       {
+                           glmCS::skinVerticesDQ(vertices.data(), n, dqPalette.data(), out.data(), threads[t]);
+                           doNotOptimize(out[n - 1]); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+/// @ref bench
+/// @file bench_spatial.cpp
+///
+/// @brief Benchmarks for the glmCS spatial query kernels: batched frustum culling, ray picking and BVH
+/// build / query / refit.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <random>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csfrustum_utils.hpp"
+#include "cspicking.hpp"
+#include "csbvh.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("spatial", argc, argv);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f), extent(0.1f, 4.0f);
+
+    // ---------------------------------------------------------------- frustum culling
+    {
+        glmCS::Matrix<float, 4, 4> view = glmCS::lookAt(glmCS::vec3(0.0f, 10.0f, 50.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+        glmCS::Matrix<float, 4, 4> proj = glmCS::perspective(1.0f, 16.0f / 9.0f, 0.1f, 300.0f);
+        glmCS::Frustum frustum = glmCS::extractFrustum(glmCS::matrixMultiply(view, proj.mat));
+
+        size_t n = 100000;
+        std::vector<float> cx(n), cy(n), cz(n), ex(n), ey(n), ez(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            cx[i] = position(rng);
+            cy[i] = position(rng);
+            cz[i] = position(rng);
+            ex[i] = extent(rng);
+            ey[i] = extent(rng);
+            ez[i] = extent(rng);
+        }
+        glmCS::AABBArraysSoA boxes = {cx.data(), cy.data(), cz.data(), ex.data(), ey.data(), ez.data()};
+        glmCS::SphereArraysSoA spheres = {cx.data(), cy.data(), cz.data(), ex.data()};
+        std::vector<uint32_t> mask((n + 31) / 32), indices(n);
+
+        runner.run("frustum/extractFrustum", 1, [&]()
+                   { glmCS::Frustum f = glmCS::extractFrustum(view); doNotOptimize(f); });
+        runner.run("frustum/scalar_aabb/100000", double(n), [&]()
+                   {
+                       size_t visible = 0;
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           visible += glmCS::intersectAABB(frustum, cx[i], cy[i], cz[i], ex[i], ey[i], ez[i]);
+                       }
+                       doNotOptimize(visible); });
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            std::string suffix = "/100000/" + std::to_string(threads[t]) + "threads";
+            runner.run("frustum/cullAABBs_mask" + suffix, double(n), [&]()
+                       { glmCS::cullAABBs(frustum, boxes, n, mask.data(), threads[t]); doNotOptimize(mask[0]); });
+            runner.run("frustum/cullSpheres_mask" + suffix, double(n), [&]()
+                       { glmCS::cullSpheres(frustum, spheres, n, mask.data(), threads[t]); doNotOptimize(mask[0]); });
+            runner.run("frustum/cullAABBs_indices" + suffix, double(n), [&]()
+                       { size_t k = glmCS::cullAABBsToIndices(frustum, boxes, n, indices.data(), threads[t]); doNotOptimize(k); });
+        }
+    }
+
+    // ---------------------------------------------------------------- ray picking
+    {
+        glmCS::Matrix<float, 4, 4> view = glmCS::lookAt(glmCS::vec3(0.0f, 10.0f, 250.0f), glmCS::vec3(0.0f, 0.0f, 0.0f), glmCS::vec3(0.0f, 1.0f, 0.0f));
+        glmCS::Projection<float> proj = glmCS::perspectiveWithInverse(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        glmCS::Ray ray = glmCS::pickRay(proj, view, 0.01f, -0.02f);
+
+        // 随机散布的小三角形
+        size_t n = 100000;
+        std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+        std::vector<float> positions(n * 9);
+        std::vector<uint32_t> triangleIndices(n * 3);
+        for (size_t i = 0; i < n; ++i)
+        {
+            float c[3] = {position(rng), position(rng), position(rng)};
+            for (size_t v = 0; v < 3; ++v)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    positions[i * 9 + v * 3 + k] = c[k] + jitter(rng);
+                }
+                triangleIndices[i * 3 + v] = uint32_t(i * 3 + v);
+            }
+        }
+        glmCS::TriangleSoABuffer mesh;
+        mesh.build(positions.data(), 3, triangleIndices.data(), n);
+        glmCS::TriangleArraysSoA tris = mesh.arrays();
+
+        runner.run("picking/pickRay", 1, [&]()
+                   { glmCS::Ray r = glmCS::pickRay(proj, view, 0.01f, -0.02f); doNotOptimize(r); });
+        runner.run("picking/scalar_triangles/100000", double(n), [&]()
+                   {
+                       float best = FLT_MAX;
+                       for (size_t i = 0; i < n; ++i)
+                       {
+                           const float v0[3] = {tris.v0x[i], tris.v0y[i], tris.v0z[i]};
+                           const float e1[3] = {tris.e1x[i], tris.e1y[i], tris.e1z[i]};
+                           const float e2[3] = {tris.e2x[i], tris.e2y[i], tris.e2z[i]};
+                           float t, u, v;
+                           glmCS::intersectRayTriangle(ray, v0, e1, e2, best, &t, &u, &v) && (best = t);
+                       }
+                       doNotOptimize(best); });
+        runner.run("picking/intersectRayTriangles/100000", double(n), [&]()
+                   {
+                       glmCS::RayHit hit;
+                       glmCS::intersectRayTriangles(ray, tris, n, FLT_MAX, &hit);
+                       doNotOptimize(hit); });
+
+        std::vector<float> cx(n), cy(n), cz(n), ex(n), ey(n), ez(n), tNear(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            cx[i] = position(rng);
+            cy[i] = position(rng);
+            cz[i] = position(rng);
+            ex[i] = extent(rng);
+            ey[i] = extent(rng);
+            ez[i] = extent(rng);
+        }
+        glmCS::AABBArraysSoA boxes = {cx.data(), cy.data(), cz.data(), ex.data(), ey.data(), ez.data()};
+        std::vector<uint32_t> mask((n + 31) / 32);
+        const unsigned threads[] = {1, 4};
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("picking/intersectRayAABBs/100000/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       { glmCS::intersectRayAABBs(ray, boxes, n, FLT_MAX, mask.data(), tNear.data(), threads[t]); doNotOptimize(mask[0]); });
+        }
+
+        // ------------------------------------------------------------ BVH
+        glmCS::AABBSoABuffer triangleBoxes;
+        glmCS::triangleBounds(tris, n, triangleBoxes);
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("bvh/build/100000/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       { glmCS::BVH b; b.build(triangleBoxes.arrays(), n, threads[t]); doNotOptimize(b); });
+        }
+        glmCS::BVH bvh;
+        bvh.build(triangleBoxes.arrays(), n);
+
+        // 从相机出发的一批拾取射线
+        size_t rayCount = 1024;
+        std::vector<glmCS::Ray> rays(rayCount);
+        std::uniform_real_distribution<float> ndc(-1.0f, 1.0f);
+        for (size_t i = 0; i < rayCount; ++i)
+        {
+            rays[i] = glmCS::pickRay(proj, view, ndc(rng), ndc(rng));
+        }
+        runner.run("bvh/intersectRayTriangles/1024rays", double(rayCount), [&]()
+                   {
+                       size_t hits = 0;
+                       for (size_t i = 0; i < rayCount; ++i)
+                       {
+                           glmCS::RayHit hit;
+                           hits += glmCS::intersectRayTriangles(bvh, rays[i], tris, FLT_MAX, &hit);
+                       }
+                       doNotOptimize(hits); });
+        runner.run("bvh/occludedRayTriangles/1024rays", double(rayCount), [&]()
+                   {
+                       size_t hits = 0;
+                       for (size_t i = 0; i < rayCount; ++i)
+                       {
+                           hits += glmCS::occludedRayTriangles(bvh, rays[i], tris, FLT_MAX);
+                       }
+                       doNotOptimize(hits); });
+        runner.run("bvh/queryAABB/1024boxes", double(rayCount), [&]()
+                   {
+                       size_t overlaps = 0;
+                       for (size_t i = 0; i < rayCount; ++i)
+                       {
+                           const float lo[3] = {cx[i] - 5.0f, cy[i] - 5.0f, cz[i] - 5.0f};
+                           const float hi[3] = {cx[i] + 5.0f, cy[i] + 5.0f, cz[i] + 5.0f};
+                           bvh.queryAABB(lo, hi, [&](uint32_t) { overlaps++; });
+                       }
+                       doNotOptimize(overlaps); });
+
+        // 1% 的图元移动后：整体 refit 与只更新移动部分
+        std::vector<uint32_t> moved;
+        for (size_t i = 0; i < n; i += 100)
+        {
+            triangleBoxes.centerY[i] += 1.0f;
+            moved.push_back(uint32_t(i));
+        }
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            runner.run("bvh/refit/100000/" + std::to_string(threads[t]) + "threads", double(n), [&]()
+                       { bvh.refit(triangleBoxes.arrays(), threads[t]); doNotOptimize(bvh); });
+        }
+        runner.run("bvh/refitPrimitives/1000moved", double(moved.size()), [&]()
+                   { bvh.refitPrimitives(triangleBoxes.arrays(), moved.data(), moved.size()); doNotOptimize(bvh); });
+    }
+    return 0;
+}
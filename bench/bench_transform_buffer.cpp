@@ -0,0 +1,164 @@
+/// @ref bench
+/// @file bench_transform_buffer.cpp
+///
+/// @brief Contention benchmarks for handing a frame of world matrices from a simulation thread to a render thread:
+/// a mutex around one shared array versus glmCS::TransformTripleBuffer. One side is measured while the other runs
+/// flat out on a background thread. Every frame writes its frame number into all matrices, so the reader also
+/// counts torn frames (matrices from different frames seen in one read).
+//////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_utils.hpp"
+#include "csmatrix_utils.hpp"
+#include "cstransform_buffer.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+namespace
+{
+    typedef glmCS::Matrix<float, 4, 4> Mat4;
+
+    void writeFrame(Mat4 *dst, size_t count, float frame)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] = glmCS::initIdentityMatrix<float, 4>();
+            dst[i].mat[3][0] = frame;
+        }
+    }
+
+    // 返回本次读取是否撕裂（首尾矩阵来自不同帧）
+    bool readFrame(const Mat4 *src, size_t count, float *checksum)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            sum += src[i].mat[3][0];
+        }
+        *checksum = sum;
+        return src[0].mat[3][0] != src[count - 1].mat[3][0];
+    }
+
+    // 带互斥锁的共享数组（对照组）
+    struct MutexTransforms
+    {
+        std::mutex lock;
+        std::vector<Mat4> data;
+    };
+} // namespace
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("cstransform_buffer", argc, argv);
+
+    size_t n = 10000;
+    std::string suffix = "/" + std::to_string(n);
+
+    // ---------------------------------------------------------------- consumer side (producer on a background thread)
+    {
+        MutexTransforms shared;
+        shared.data.resize(n);
+        std::atomic<bool> stop(false);
+        std::thread producer([&]()
+                             {
+                                 float frame = 0.0f;
+                                 while (!stop.load(std::memory_order_relaxed))
+                                 {
+                                     std::lock_guard<std::mutex> guard(shared.lock);
+                                     writeFrame(shared.data.data(), n, frame += 1.0f);
+                                 } });
+        size_t torn = 0, reads = 0;
+        runner.run("mutex/consumer_read" + suffix, double(n), [&]()
+                       {
+                           float checksum;
+                           std::lock_guard<std::mutex> guard(shared.lock);
+                           torn += readFrame(shared.data.data(), n, &checksum) ? 1 : 0;
+                           reads++;
+                           doNotOptimize(checksum); });
+        stop = true;
+        producer.join();
+        runner.record("mutex/consumer_read" + suffix + "/stats", {{"torn_frames", double(torn)}, {"reads", double(reads)}});
+    }
+    {
+        glmCS::TransformTripleBuffer transforms(n);
+        std::atomic<bool> stop(false);
+        std::thread producer([&]()
+                             {
+                                 float frame = 0.0f;
+                                 while (!stop.load(std::memory_order_relaxed))
+                                 {
+                                     writeFrame(transforms.writeBuffer(), n, frame += 1.0f);
+                                     transforms.publish();
+                                 } });
+        size_t torn = 0, reads = 0, fresh = 0;
+        uint64_t lastSequence = 0;
+        runner.run("triple_buffer/consumer_read" + suffix, double(n), [&]()
+                       {
+                           float checksum;
+                           torn += readFrame(transforms.read(), n, &checksum) ? 1 : 0;
+                           fresh += transforms.readSequence() != lastSequence ? 1 : 0;
+                           lastSequence = transforms.readSequence();
+                           reads++;
+                           doNotOptimize(checksum); });
+        stop = true;
+        producer.join();
+        runner.record("triple_buffer/consumer_read" + suffix + "/stats", {{"torn_frames", double(torn)}, {"reads", double(reads)}, {"new_frames_seen", double(fresh)}});
+    }
+
+    // ---------------------------------------------------------------- producer side (consumer on a background thread)
+    {
+        MutexTransforms shared;
+        shared.data.resize(n);
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> torn(0);
+        std::thread consumer([&]()
+                             {
+                                 float checksum = 0.0f;
+                                 while (!stop.load(std::memory_order_relaxed))
+                                 {
+                                     std::lock_guard<std::mutex> guard(shared.lock);
+                                     if (readFrame(shared.data.data(), n, &checksum))
+                                     {
+                                         torn++;
+                                     }
+                                 }
+                                 doNotOptimize(checksum); });
+        float frame = 0.0f;
+        runner.run("mutex/producer_publish" + suffix, double(n), [&]()
+                       {
+                           std::lock_guard<std::mutex> guard(shared.lock);
+                           writeFrame(shared.data.data(), n, frame += 1.0f); });
+        stop = true;
+        consumer.join();
+        runner.record("mutex/producer_publish" + suffix + "/stats", {{"torn_frames", double(torn.load())}});
+    }
+    {
+        glmCS::TransformTripleBuffer transforms(n);
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> torn(0);
+        std::thread consumer([&]()
+                             {
+                                 float checksum = 0.0f;
+                                 while (!stop.load(std::memory_order_relaxed))
+                                 {
+                                     if (readFrame(transforms.read(), n, &checksum))
+                                     {
+                                         torn++;
+                                     }
+                                 }
+                                 doNotOptimize(checksum); });
+        float frame = 0.0f;
+        runner.run("triple_buffer/producer_publish" + suffix, double(n), [&]()
+                       {
+                           writeFrame(transforms.writeBuffer(), n, frame += 1.0f);
+                           transforms.publish(); });
+        stop = true;
+        consumer.join();
+        runner.record("triple_buffer/producer_publish" + suffix + "/stats", {{"torn_frames", double(torn.load())}});
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/// @ref bench
+/// @file bench_truetype.cpp
+///
+/// @brief Benchmarks for truetype.hpp: shaping and rendering of typical overlay strings at several sizes.
+/// The font is taken from --font <file>, the GLMCS_BENCH_FONT environment variable, or a few common system paths.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "bench_utils.hpp"
+#include "truetype.hpp"
+
+using glmcs_bench::doNotOptimize;
+
+static std::string findFont(int argc, char **argv)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--font") == 0)
+        {
+            return argv[i + 1];
+        }
+    }
+    const char *env = getenv("GLMCS_BENCH_FONT");
+    if (env != NULL)
+    {
+        return env;
+    }
+    const char *candidates[] = {
+        "/system/bin/fonts/arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/TTF/DejaVuSans.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+        "/Library/Fonts/Arial.ttf",
+        "C:/Windows/Fonts/arial.ttf"};
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i)
+    {
+        std::ifstream f(candidates[i]);
+        if (f.good())
+        {
+            return candidates[i];
+        }
+    }
+    return std::string();
+}
+
+int main(int argc, char **argv)
+{
+    glmcs_bench::Runner runner("truetype", argc, argv);
+    std::string font = findFont(argc, argv);
+    if (font.empty())
+    {
+        printf("No font file found, pass --font <file.ttf> or set GLMCS_BENCH_FONT\n");
+        return 0;
+    }
+
+    // 典型的叠加层文本
+    const char *overlays[] = {"60 fps", "Frame 12345 | 16.67 ms", "GPU 87% CPU 43% MEM 1.2 GB"};
+    const float sizes[] = {16.0f, 32.0f, 64.0f};
+
+    TrueType truetype(1024, 128, font);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        for (size_t o = 0; o < sizeof(overlays) / sizeof(overlays[0]); ++o)
+        {
+            std::string text = overlays[o];
+            std::string suffix = "/" + std::to_string(int(sizes[s])) + "px/" + std::to_string(text.size()) + "chars";
+            // 整形结果命中缓存：每帧重复的标签
+            runner.run("processInput/cached" + suffix, double(text.size()), [&]()
+                       { truetype.processInput(text, sizes[s]); doNotOptimize(truetype.bitmap[0]); });
+            // 每帧变化的文本：整形 + 渲染
+            int counter = 0;
+            runner.run("processInput/uncached" + suffix, double(text.size()), [&]()
+                       {
+                           std::string varying = text + std::to_string(counter++ & 0xffff);
+                           truetype.processInput(varying, sizes[s]);
+                           doNotOptimize(truetype.bitmap[0]); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,270 @@
+/// @ref bench
+/// @file bench_utils.hpp
+///
+/// @brief Minimal benchmark harness shared by the bench_* programs.
+/// Each case is calibrated until one sample lasts at least --min-time seconds, sampled several times,
+/// and the median is reported. Results are printed as a table and optionally written as JSON:
+///
+///     ./bench_matrix --json bench_matrix.json --filter lookAt --min-time 0.05
+///
+/// JSON layout:
+///     {"suite": "...", "compiler": "...", "simd": "...", "results": [
+///         {"name": "...", "iterations": N, "ns_per_iter": x, "items_per_iter": k, "items_per_second": y, "counters": {...}}]}
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BENCH_UTILS_H__
+#define __BENCH_UTILS_H__
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace glmcs_bench
+{
+    // 阻止编译器将基准测试的结果优化掉
+    template <typename T>
+    inline void doNotOptimize(T const &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        volatile char sink = *reinterpret_cast<volatile const char *>(&value);
+        (void)sink;
+#endif
+    }
+
+    inline void clobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    // 单个基准用例的结果
+    struct Result
+    {
+        std::string name;
+        size_t iterations;
+        double nsPerIter;
+        double itemsPerIter;
+        std::map<std::string, double> counters; // 附加的数值（例如误差）
+    };
+
+    class Runner
+    {
+    private:
+        std::string suite;
+        std::string jsonPath;
+        std::string filter;
+        double minTime = 0.1; // 单次采样的最短时长（秒）
+        int samples = 5;
+        std::vector<Result> results;
+
+        static const char *simdName()
+        {
+#if defined(__AVX512F__)
+            return "avx512f";
+#elif defined(__AVX2__)
+            return "avx2";
+#elif defined(__AVX__)
+            return "avx";
+#elif defined(__SSE2__) || defined(_M_X64)
+            return "sse2";
+#elif defined(__ARM_NEON)
+            return "neon";
+#else
+            return "scalar";
+#endif
+        }
+
+        static std::string escape(const std::string &s)
+        {
+            std::string out;
+            for (size_t i = 0; i < s.size(); ++i)
+            {
+                if (s[i] == '"' || s[i] == '\\')
+                {
+                    out += '\\';
+                }
+                out += s[i];
+            }
+            return out;
+        }
+
+    public:
+        Runner(const std::string &suite, int argc, char **argv) : suite(suite)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+                {
+                    jsonPath = argv[++i];
+                }
+                else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+                {
+                    filter = argv[++i];
+                }
+                else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+                {
+                    minTime = atof(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+                {
+                    samples = std::max(1, atoi(argv[++i]));
+                }
+            }
+            printf("%-56s %14s %14s %16s\n", "benchmark", "iterations", "ns/iter", "items/s");
+        }
+
+        ~Runner() { writeJson(); }
+
+        bool enabled(const std::string &name) const
+        {
+            return filter.empty() || name.find(filter) != std::string::npos;
+        }
+
+        /// @brief 运行一个基准用例
+        /// @param name 用例名称
+        /// @param itemsPerIter 每次调用处理的元素数（用于计算吞吐量）
+        /// @param fn 被测函数，每次迭代调用一次
+        /// @return 结果的副本（之后的 run/record 会使内部数组扩容）；被 --filter 跳过时 iterations 为 0
+        template <typename F>
+        Result run(const std::string &name, double itemsPerIter, F &&fn)
+        {
+            if (!enabled(name))
+            {
+                Result skipped;
+                skipped.name = name;
+                skipped.iterations = 0;
+                skipped.nsPerIter = 0.0;
+                skipped.itemsPerIter = itemsPerIter;
+                return skipped;
+            }
+            typedef std::chrono::steady_clock Clock;
+            // 标定迭代次数
+            size_t iters = 1;
+            for (;;)
+            {
+                Clock::time_point t0 = Clock::now();
+                for (size_t i = 0; i < iters; ++i)
+                {
+                    fn();
+                }
+                double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+                if (sec >= minTime || iters >= (size_t(1) << 40))
+                {
+                    break;
+                }
+                double grow = sec > 0.0 ? (minTime * 1.2) / sec : 16.0;
+                iters = size_t(iters * std::min(std::max(grow, 2.0), 16.0)) + 1;
+            }
+            std::vector<double> ns;
+            for (int s = 0; s < samples; ++s)
+            {
+                Clock::time_point t0 = Clock::now();
+                for (size_t i = 0; i < iters; ++i)
+                {
+                    fn();
+                }
+                ns.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(iters));
+            }
+            std::sort(ns.begin(), ns.end());
+            Result r;
+            r.name = name;
+            r.iterations = iters;
+            r.nsPerIter = ns[ns.size() / 2];
+            r.itemsPerIter = itemsPerIter;
+            results.push_back(r);
+            printf("%-56s %14zu %14.2f %16.4g\n", name.c_str(), iters, r.nsPerIter, itemsPerIter * 1e9 / r.nsPerIter);
+            fflush(stdout);
+            return r;
+        }
+
+        /// @brief 记录一个不计时的数值结果（例如精度表）
+        void record(const std::string &name, const std::map<std::string, double> &counters)
+        {
+            if (!enabled(name))
+            {
+                return;
+            }
+            Result r;
+            r.name = name;
+            r.iterations = 0;
+            r.nsPerIter = 0.0;
+            r.itemsPerIter = 0.0;
+            r.counters = counters;
+            results.push_back(r);
+            printf("%-56s", name.c_str());
+            for (std::map<std::string, double>::const_iterator it = counters.begin(); it != counters.end(); ++it)
+            {
+                printf(" %s=%.6g", it->first.c_str(), it->second);
+            }
+            printf("\n");
+        }
+
+        void writeJson() const
+        {
+            if (jsonPath.empty())
+            {
+                return;
+            }
+            FILE *f = jsonPath == "-" ? stdout : fopen(jsonPath.c_str(), "w");
+            if (f == NULL)
+            {
+                fprintf(stderr, "[%s:%i]Can not open json output:%s\n", __FILE__, __LINE__, jsonPath.c_str());
+                return;
+            }
+#if defined(__clang__)
+            const char *compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+            const char *compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            const char *compiler = "msvc";
+#else
+            const char *compiler = "unknown";
+#endif
+            fprintf(f, "{\n  \"suite\": \"%s\",\n  \"compiler\": \"%s\",\n  \"simd\": \"%s\",\n  \"timestamp\": %lld,\n  \"results\": [\n",
+                    escape(suite).c_str(), escape(compiler).c_str(), simdName(),
+                    (long long)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const Result &r = results[i];
+                fprintf(f, "    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_iter\": %.4f, \"items_per_iter\": %.1f, \"items_per_second\": %.6g",
+                        escape(r.name).c_str(), r.iterations, r.nsPerIter, r.itemsPerIter,
+                        r.nsPerIter > 0.0 ? r.itemsPerIter * 1e9 / r.nsPerIter : 0.0);
+                if (!r.counters.empty())
+                {
+                    fprintf(f, ", \"counters\": {");
+                    for (std::map<std::string, double>::const_iterator it = r.counters.begin(); it != r.counters.end(); ++it)
+                    {
+                        // JSON 没有 NaN / Infinity，写为 null
+                        fprintf(f, "%s\"%s\": ", it == r.counters.begin() ? "" : ", ", escape(it->first).c_str());
+                        if (isfinite(it->second))
+                        {
+                            fprintf(f, "%.9g", it->second);
+                        }
+                        else
+                        {
+                            fprintf(f, "null");
+                        }
+                    }
+                    fprintf(f, "}");
+                }
+                fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+            }
+            fprintf(f, "  ]\n}\n");
+            if (f != stdout)
+            {
+                fclose(f);
+            }
+        }
+    };
+} // namespace glmcs_bench
+
+#endif // __BENCH_UTILS_H__
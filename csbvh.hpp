@@ -0,0 +1,791 @@
+/// @ref core
+/// @file csbvh.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Bounding volume hierarchy for CPU-side spatial queries (picking, occlusion rays, collision).
+/// The tree is built over axis-aligned boxes (the AABBArraysSoA of csfrustum_utils) with a binned surface area
+/// heuristic, one tree level at a time: nodes of a level are split in parallel, and very large nodes bin their
+/// primitives in parallel. Nodes are 32 bytes and 32-byte aligned; they are stored depth-first with siblings
+/// adjacent, so both children of a node are fetched together and subtrees stay contiguous. Queries use a short
+/// fixed-size stack (depth is capped at build time). After objects move (translateMatrix / rotate), refit()
+/// updates all bounds bottom-up, and refitPrimitives() walks up only from the moved primitives, so the
+/// per-frame cost follows the motion.
+///
+/// glmCS::BVH bvh;
+/// bvh.build(boxes, count, 4);
+/// glmCS::RayHit hit;
+/// glmCS::intersectRayTriangles(bvh, ray, tris, FLT_MAX, &hit);
+/// glmCS::transformAABBs(models, localBoxes, count, worldBoxes); // 物体移动后
+/// bvh.refit(worldBoxes.arrays());
+///
+
+#ifndef __CSBVH_H__
+#define __CSBVH_H__
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "csfrustum_utils.hpp"
+#include "cspicking.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    // 持有 SoA 包围盒数据（中心 + 半边长）
+    struct AABBSoABuffer
+    {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> extentX, extentY, extentZ;
+
+        void resize(size_t count)
+        {
+            centerX.resize(count);
+            centerY.resize(count);
+            centerZ.resize(count);
+            extentX.resize(count);
+            extentY.resize(count);
+            extentZ.resize(count);
+        }
+
+        AABBArraysSoA arrays() const
+        {
+            AABBArraysSoA b = {centerX.data(), centerY.data(), centerZ.data(), extentX.data(), extentY.data(), extentZ.data()};
+            return b;
+        }
+    };
+
+    /// @brief 批量变换包围盒（Arvo）：中心按点变换，半边长乘以矩阵 3x3 部分的绝对值
+    /// @param matrices 每个包围盒的模型矩阵
+    /// @param local 物体空间包围盒
+    /// @param count 包围盒个数
+    /// @param world 输出的世界空间包围盒
+    inline void transformAABBs(const Matrix<float, 4, 4> *matrices, const AABBArraysSoA &local, size_t count, AABBSoABuffer &world)
+    {
+        world.resize(count);
+        float *center[3] = {world.centerX.data(), world.centerY.data(), world.centerZ.data()};
+        float *extent[3] = {world.extentX.data(), world.extentY.data(), world.extentZ.data()};
+        for (size_t i = 0; i < count; i++)
+        {
+            const float(*m)[4] = matrices[i].mat;
+            float cx = local.centerX[i], cy = local.centerY[i], cz = local.centerZ[i];
+            float ex = local.extentX[i], ey = local.extentY[i], ez = local.extentZ[i];
+            for (size_t j = 0; j < 3; j++)
+            {
+                center[j][i] = m[0][j] * cx + m[1][j] * cy + m[2][j] * cz + m[3][j];
+                extent[j][i] = fabsf(m[0][j]) * ex + fabsf(m[1][j]) * ey + fabsf(m[2][j]) * ez;
+            }
+        }
+    }
+
+    // 计算三角形的包围盒
+    inline void triangleBounds(const TriangleArraysSoA &tris, size_t count, AABBSoABuffer &bounds)
+    {
+        bounds.resize(count);
+        const float *v0[3] = {tris.v0x, tris.v0y, tris.v0z};
+        const float *e1[3] = {tris.e1x, tris.e1y, tris.e1z};
+        const float *e2[3] = {tris.e2x, tris.e2y, tris.e2z};
+        float *center[3] = {bounds.centerX.data(), bounds.centerY.data(), bounds.centerZ.data()};
+        float *extent[3] = {bounds.extentX.data(), bounds.extentY.data(), bounds.extentZ.data()};
+        for (size_t i = 0; i < count; i++)
+        {
+            for (size_t a = 0; a < 3; a++)
+            {
+                float lo = std::min(0.0f, std::min(e1[a][i], e2[a][i]));
+                float hi = std::max(0.0f, std::max(e1[a][i], e2[a][i]));
+                center[a][i] = v0[a][i] + 0.5f * (lo + hi);
+                extent[a][i] = 0.5f * (hi - lo);
+            }
+        }
+    }
+
+    // BVH 节点：count == 0 时为内部节点，子节点为 leftFirst 与 leftFirst + 1；否则为叶节点，图元为 primitives[leftFirst, leftFirst + count)
+    struct alignas(32) BVHNode
+    {
+        float boundsMin[3];
+        uint32_t leftFirst;
+        float boundsMax[3];
+        uint32_t count;
+    };
+
+    class BVH
+    {
+    public:
+        static constexpr uint32_t npos = 0xFFFFFFFFu;
+        static constexpr uint32_t maxDepth = 64; // 遍历栈的大小
+        static constexpr uint32_t binCount = 16;
+
+    private:
+        // 第 4 个分量只用于 SIMD 对齐，不参与计算
+        struct alignas(16) Bounds
+        {
+            float lo[4], hi[4];
+
+            void reset()
+            {
+                for (size_t a = 0; a < 4; a++)
+                {
+                    lo[a] = FLT_MAX;
+                    hi[a] = -FLT_MAX;
+                }
+            }
+            // 合并 [l, h]，l 与 h 须可读 4 个 float 且 16 字节对齐
+            void grow(const float *l, const float *h)
+            {
+#if defined(GLMCS_HAS_SSE2)
+                _mm_store_ps(lo, _mm_min_ps(_mm_load_ps(lo), _mm_load_ps(l)));
+                _mm_store_ps(hi, _mm_max_ps(_mm_load_ps(hi), _mm_load_ps(h)));
+#else
+                for (size_t a = 0; a < 3; a++)
+                {
+                    lo[a] = std::min(lo[a], l[a]);
+                    hi[a] = std::max(hi[a], h[a]);
+                }
+#endif
+            }
+            void grow(const Bounds &b) { grow(b.lo, b.hi); }
+            float area() const
+            {
+                float dx = hi[0] - lo[0], dy = hi[1] - lo[1], dz = hi[2] - lo[2];
+                return (dx < 0.0f || dy < 0.0f || dz < 0.0f) ? 0.0f : dx * dy + dy * dz + dz * dx;
+            }
+        };
+
+        struct Bin
+        {
+            Bounds bounds;
+            uint32_t count;
+        };
+
+        struct BuildTask
+        {
+            uint32_t node, begin, end, depth;
+        };
+
+        // 构建时的图元记录（32 字节，与 BVHNode 布局相同），划分时直接移动记录，分桶只做连续访问
+        struct alignas(32) BuildRef
+        {
+            float lo[3];
+            uint32_t index;
+            float hi[3];
+            float pad;
+
+            float center(size_t axis) const { return 0.5f * (lo[axis] + hi[axis]); }
+        };
+
+        std::vector<BVHNode> nodes;
+        std::vector<uint32_t> primitives; // 叶节点引用的图元下标
+        std::vector<uint32_t> parents;    // 节点的父节点，根为 npos
+        std::vector<uint32_t> primLeaf;   // 图元所在的叶节点
+        std::vector<BuildRef> refs;       // 仅在构建期间使用
+        uint32_t maxLeafSize = 4;
+
+        static void primitiveBounds(const AABBArraysSoA &b, uint32_t i, float lo[3], float hi[3])
+        {
+            const float c[3] = {b.centerX[i], b.centerY[i], b.centerZ[i]};
+            const float e[3] = {b.extentX[i], b.extentY[i], b.extentZ[i]};
+            for (size_t a = 0; a < 3; a++)
+            {
+                lo[a] = c[a] - e[a];
+                hi[a] = c[a] + e[a];
+            }
+        }
+
+        // 计算区间的包围盒、质心包围盒与三个轴上的 binUsed 个桶（bins 为空时只算包围盒）；threads > 1 时分块并行后合并
+        void binRange(uint32_t begin, uint32_t end, unsigned threads, uint32_t binUsed, Bounds &bounds, Bounds &centroids, Bin bins[3][binCount]) const
+        {
+            const BuildRef *r = refs.data();
+#if defined(GLMCS_HAS_SSE2)
+            // 记录的第 4 个分量是图元下标（按 float 解释为非规格化数），参与加法前清零
+            const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+#endif
+            auto boundsPass = [&](size_t from, size_t to, Bounds &bb, Bounds &cb)
+            {
+                bb.reset();
+                cb.reset();
+                for (size_t k = from; k < to; k++)
+                {
+                    bb.grow(r[k].lo, r[k].hi);
+#if defined(GLMCS_HAS_SSE2)
+                    __m128 c = _mm_mul_ps(_mm_add_ps(_mm_and_ps(_mm_load_ps(r[k].lo), xyz), _mm_and_ps(_mm_load_ps(r[k].hi), xyz)), _mm_set1_ps(0.5f));
+                    _mm_store_ps(cb.lo, _mm_min_ps(_mm_load_ps(cb.lo), c));
+                    _mm_store_ps(cb.hi, _mm_max_ps(_mm_load_ps(cb.hi), c));
+#else
+                    const float c[3] = {r[k].center(0), r[k].center(1), r[k].center(2)};
+                    cb.grow(c, c);
+#endif
+                }
+            };
+            auto binPass = [&](size_t from, size_t to, const Bounds &cb, Bin out[3][binCount])
+            {
+                for (size_t a = 0; a < 3; a++)
+                {
+                    for (size_t i = 0; i < binUsed; i++)
+                    {
+                        out[a][i].bounds.reset();
+                        out[a][i].count = 0;
+                    }
+                }
+                alignas(16) float scale[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (size_t a = 0; a < 3; a++)
+                {
+                    float extent = cb.hi[a] - cb.lo[a];
+                    scale[a] = extent > 0.0f ? float(binUsed) / extent : 0.0f;
+                }
+#if defined(GLMCS_HAS_SSE2)
+                // 三个轴的桶下标一次算出：min((c - lo) * scale, binUsed - 1)
+                const __m128 origin = _mm_load_ps(cb.lo), scale4 = _mm_load_ps(scale), last = _mm_set1_ps(float(binUsed - 1));
+                for (size_t k = from; k < to; k++)
+                {
+                    __m128 c = _mm_mul_ps(_mm_add_ps(_mm_and_ps(_mm_load_ps(r[k].lo), xyz), _mm_and_ps(_mm_load_ps(r[k].hi), xyz)), _mm_set1_ps(0.5f));
+                    alignas(16) int32_t bin[4];
+                    _mm_store_si128(reinterpret_cast<__m128i *>(bin), _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(c, origin), scale4), last)));
+                    for (size_t a = 0; a < 3; a++)
+                    {
+                        out[a][bin[a]].bounds.grow(r[k].lo, r[k].hi);
+                        out[a][bin[a]].count++;
+                    }
+                }
+#else
+                for (size_t k = from; k < to; k++)
+                {
+                    for (size_t a = 0; a < 3; a++)
+                    {
+                        uint32_t i = std::min(binUsed - 1, uint32_t((r[k].center(a) - cb.lo[a]) * scale[a]));
+                        out[a][i].bounds.grow(r[k].lo, r[k].hi);
+                        out[a][i].count++;
+                    }
+                }
+#endif
+            };
+
+            size_t count = end - begin;
+            if (threads <= 1 || count < 65536)
+            {
+                boundsPass(begin, end, bounds, centroids);
+                if (bins != nullptr)
+                {
+                    binPass(begin, end, centroids, bins);
+                }
+                return;
+            }
+            std::vector<Bounds> partBounds(threads), partCentroids(threads);
+            parallelFor(threads, threads, [&](size_t from, size_t to)
+                        {
+                            for (size_t t = from; t < to; t++)
+                            {
+                                boundsPass(begin + count * t / threads, begin + count * (t + 1) / threads, partBounds[t], partCentroids[t]);
+                            } });
+            bounds.reset();
+            centroids.reset();
+            for (unsigned t = 0; t < threads; t++)
+            {
+                bounds.grow(partBounds[t]);
+                centroids.grow(partCentroids[t]);
+            }
+            if (bins == nullptr)
+            {
+                return;
+            }
+            std::vector<Bin> partBins(size_t(threads) * 3 * binCount);
+            parallelFor(threads, threads, [&](size_t from, size_t to)
+                        {
+                            for (size_t t = from; t < to; t++)
+                            {
+                                binPass(begin + count * t / threads, begin + count * (t + 1) / threads, centroids,
+                                        reinterpret_cast<Bin(*)[binCount]>(&partBins[t * 3 * binCount]));
+                            } });
+            for (size_t a = 0; a < 3; a++)
+            {
+                for (size_t i = 0; i < binUsed; i++)
+                {
+                    bins[a][i].bounds.reset();
+                    bins[a][i].count = 0;
+                    for (unsigned t = 0; t < threads; t++)
+                    {
+                        const Bin &pb = partBins[(t * 3 + a) * binCount + i];
+                        bins[a][i].bounds.grow(pb.bounds);
+                        bins[a][i].count += pb.count;
+                    }
+                }
+            }
+        }
+
+        // 处理一个节点：写入包围盒，返回划分位置（npos 表示作为叶节点）
+        uint32_t splitNode(const BuildTask &task, unsigned threads)
+        {
+            uint32_t count = task.end - task.begin;
+            bool leaf = count <= maxLeafSize || task.depth + 1 >= maxDepth;
+            // 小节点用较少的桶，避免固定开销占主导
+            uint32_t binUsed = std::min(binCount, std::max<uint32_t>(4, count / 4));
+            Bounds bounds, centroids;
+            Bin bins[3][binCount];
+            binRange(task.begin, task.end, threads, binUsed, bounds, centroids, leaf ? nullptr : bins);
+            BVHNode &node = nodes[task.node];
+            for (size_t a = 0; a < 3; a++)
+            {
+                node.boundsMin[a] = bounds.lo[a];
+                node.boundsMax[a] = bounds.hi[a];
+            }
+            if (leaf)
+            {
+                return npos;
+            }
+
+            // SAH：cost = A(L) * N(L) + A(R) * N(R)，与不划分的 A * N 比较
+            float bestCost = FLT_MAX;
+            size_t bestAxis = 0, bestBin = 0;
+            for (size_t a = 0; a < 3; a++)
+            {
+                if (!(centroids.hi[a] > centroids.lo[a]))
+                {
+                    continue;
+                }
+                float rightArea[binCount];
+                uint32_t rightCount[binCount];
+                Bounds acc;
+                acc.reset();
+                uint32_t n = 0;
+                for (size_t i = binUsed - 1; i > 0; i--)
+                {
+                    acc.grow(bins[a][i].bounds);
+                    n += bins[a][i].count;
+                    rightArea[i] = acc.area();
+                    rightCount[i] = n;
+                }
+                acc.reset();
+                n = 0;
+                for (size_t i = 0; i + 1 < binUsed; i++)
+                {
+                    acc.grow(bins[a][i].bounds);
+                    n += bins[a][i].count;
+                    if (n == 0 || rightCount[i + 1] == 0)
+                    {
+                        continue;
+                    }
+                    float cost = acc.area() * float(n) + rightArea[i + 1] * float(rightCount[i + 1]);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = a;
+                        bestBin = i;
+                    }
+                }
+            }
+
+            BuildRef *first = refs.data() + task.begin;
+            BuildRef *last = refs.data() + task.end;
+            BuildRef *mid = nullptr;
+            if (bestCost < FLT_MAX)
+            {
+                // 划分不比叶节点更优且图元足够少时停止
+                if (bestCost >= bounds.area() * float(count) && count <= 4 * maxLeafSize)
+                {
+                    return npos;
+                }
+                float lo = centroids.lo[bestAxis];
+                float scale = float(binUsed) / (centroids.hi[bestAxis] - lo);
+                mid = std::partition(first, last, [&](const BuildRef &r)
+                                     { return std::min(binUsed - 1, uint32_t((r.center(bestAxis) - lo) * scale)) <= bestBin; });
+            }
+            if (mid == nullptr || mid == first || mid == last)
+            {
+                // 质心重合：按数量对半划分，保证树的深度有界
+                mid = first + count / 2;
+            }
+            return uint32_t(mid - refs.data());
+        }
+
+        static bool rayNode(const BVHNode &n, const RayInverse &r, float tMax, float *tNear)
+        {
+            float t0 = 0.0f, t1 = tMax;
+            for (size_t a = 0; a < 3; a++)
+            {
+                float ta = (n.boundsMin[a] - r.origin[a]) * r.invDirection[a];
+                float tb = (n.boundsMax[a] - r.origin[a]) * r.invDirection[a];
+                // 比较写成累计值在 false 分支：0 * inf 产生的 NaN 不影响结果（不用 fminf，避免函数调用）
+                float lo = tb < ta ? tb : ta, hi = tb > ta ? tb : ta;
+                t0 = lo > t0 ? lo : t0;
+                t1 = hi < t1 ? hi : t1;
+            }
+            *tNear = t0;
+            return t0 <= t1;
+        }
+
+        void setLeafBounds(const AABBArraysSoA &b, BVHNode &n) const
+        {
+            Bounds bounds;
+            bounds.reset();
+            for (uint32_t k = 0; k < n.count; k++)
+            {
+                Bounds pb;
+                pb.reset();
+                primitiveBounds(b, primitives[n.leftFirst + k], pb.lo, pb.hi);
+                bounds.grow(pb);
+            }
+            for (size_t a = 0; a < 3; a++)
+            {
+                n.boundsMin[a] = bounds.lo[a];
+                n.boundsMax[a] = bounds.hi[a];
+            }
+        }
+
+        // 由两个子节点重新计算内部节点，返回包围盒是否变化
+        bool setInnerBounds(BVHNode &n)
+        {
+            const BVHNode &l = nodes[n.leftFirst], &r = nodes[n.leftFirst + 1];
+            bool changed = false;
+            for (size_t a = 0; a < 3; a++)
+            {
+                float lo = std::min(l.boundsMin[a], r.boundsMin[a]);
+                float hi = std::max(l.boundsMax[a], r.boundsMax[a]);
+                changed |= lo != n.boundsMin[a] || hi != n.boundsMax[a];
+                n.boundsMin[a] = lo;
+                n.boundsMax[a] = hi;
+            }
+            return changed;
+        }
+
+        // 按层构建的节点改为深度优先顺序：兄弟节点仍然相邻，子树连续存放，遍历时下降到的节点多在附近的缓存行；
+        // 子节点的下标仍大于父节点，refit() 依赖这一点
+        void reorderDepthFirst()
+        {
+            std::vector<BVHNode> ordered;
+            ordered.reserve(nodes.size());
+            ordered.push_back(nodes[0]);
+            parents.assign(nodes.size(), npos);
+            std::vector<uint32_t> stack(1, 0); // ordered 中待展开的节点
+            while (!stack.empty())
+            {
+                uint32_t n = stack.back();
+                stack.pop_back();
+                if (ordered[n].count > 0)
+                {
+                    continue;
+                }
+                uint32_t oldLeft = ordered[n].leftFirst;
+                uint32_t left = uint32_t(ordered.size());
+                ordered.push_back(nodes[oldLeft]);
+                ordered.push_back(nodes[oldLeft + 1]);
+                ordered[n].leftFirst = left;
+                parents[left] = n;
+                parents[left + 1] = n;
+                stack.push_back(left + 1);
+                stack.push_back(left);
+            }
+            nodes.swap(ordered);
+        }
+
+    public:
+        BVH() {}
+
+        /// @brief 构建 BVH
+        /// @param boxes 图元的包围盒
+        /// @param count 图元个数
+        /// @param threads 线程数，1 表示在调用线程上完成
+        /// @param leafSize 叶节点最多包含的图元个数（达到深度上限时可能更多）
+        void build(const AABBArraysSoA &boxes, size_t count, unsigned threads = 1, uint32_t leafSize = 4)
+        {
+            if (threads == 0)
+            {
+                threads = hardwareThreads();
+            }
+            maxLeafSize = std::max<uint32_t>(leafSize, 1);
+            nodes.clear();
+            primitives.clear();
+            parents.clear();
+            primLeaf.clear();
+            if (count == 0)
+            {
+                return;
+            }
+            refs.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                primitiveBounds(boxes, uint32_t(i), refs[i].lo, refs[i].hi);
+                refs[i].index = uint32_t(i);
+                refs[i].pad = 0.0f;
+            }
+            nodes.reserve(2 * count);
+            nodes.push_back(BVHNode());
+
+            std::vector<BuildTask> level(1), next;
+            level[0].node = 0;
+            level[0].begin = 0;
+            level[0].end = uint32_t(count);
+            level[0].depth = 0;
+            std::vector<uint32_t> splits;
+            while (!level.empty())
+            {
+                splits.resize(level.size());
+                // 节点少时在节点内部并行分桶，节点多时每个线程处理不同节点
+                if (level.size() * 2 <= threads)
+                {
+                    for (size_t t = 0; t < level.size(); t++)
+                    {
+                        splits[t] = splitNode(level[t], threads);
+                    }
+                }
+                else
+                {
+                    parallelForEach(level.size(), threads, [&](size_t t)
+                                    { splits[t] = splitNode(level[t], 1); });
+                }
+                // 按层分配子节点，兄弟节点相邻
+                next.clear();
+                for (size_t t = 0; t < level.size(); t++)
+                {
+                    const BuildTask &task = level[t];
+                    BVHNode &node = nodes[task.node];
+                    if (splits[t] == npos)
+                    {
+                        node.leftFirst = task.begin;
+                        node.count = task.end - task.begin;
+                        continue;
+                    }
+                    uint32_t left = uint32_t(nodes.size());
+                    node.leftFirst = left;
+                    node.count = 0;
+                    nodes.push_back(BVHNode());
+                    nodes.push_back(BVHNode());
+                    BuildTask l = {left, task.begin, splits[t], task.depth + 1};
+                    BuildTask r = {left + 1, splits[t], task.end, task.depth + 1};
+                    next.push_back(l);
+                    next.push_back(r);
+                }
+                level.swap(next);
+            }
+            reorderDepthFirst();
+
+            primitives.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                primitives[i] = refs[i].index;
+            }
+            std::vector<BuildRef>().swap(refs);
+            primLeaf.resize(count);
+            for (uint32_t n = 0; n < nodes.size(); n++)
+            {
+                for (uint32_t k = 0; k < nodes[n].count; k++)
+                {
+                    primLeaf[primitives[nodes[n].leftFirst + k]] = n;
+                }
+            }
+        }
+
+        /// @brief 图元移动后自底向上更新全部节点的包围盒，不改变树结构
+        /// @param boxes 更新后的图元包围盒（图元个数与构建时相同）
+        /// @param threads 叶节点的更新线程数
+        void refit(const AABBArraysSoA &boxes, unsigned threads = 1)
+        {
+            parallelFor(nodes.size(), threads, [&](size_t begin, size_t end)
+                        {
+                            for (size_t n = begin; n < end; n++)
+                            {
+                                if (nodes[n].count > 0)
+                                {
+                                    setLeafBounds(boxes, nodes[n]);
+                                }
+                            } });
+            // 节点按深度优先存储，子节点总在父节点之后追加，下标一定大于父节点；逆序遍历即可保证先算完子节点
+            for (size_t n = nodes.size(); n-- > 0;)
+            {
+                if (nodes[n].count == 0)
+                {
+                    setInnerBounds(nodes[n]);
+                }
+            }
+        }
+
+        /// @brief 只更新移动过的图元所在的叶节点及其祖先，包围盒不再变化时提前停止
+        /// @param boxes 更新后的图元包围盒
+        /// @param moved 移动过的图元下标
+        /// @param movedCount 移动过的图元个数
+        void refitPrimitives(const AABBArraysSoA &boxes, const uint32_t *moved, size_t movedCount)
+        {
+            for (size_t i = 0; i < movedCount; i++)
+            {
+                uint32_t n = primLeaf[moved[i]];
+                setLeafBounds(boxes, nodes[n]);
+                for (n = parents[n]; n != npos; n = parents[n])
+                {
+                    if (!setInnerBounds(nodes[n]))
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        /// @brief 射线遍历：按由近到远的顺序访问与射线相交的叶节点
+        /// @param ray 射线
+        /// @param tMax 最大距离
+        /// @param leafFn 回调 float leafFn(uint32_t primitive, float tMax)，返回新的 tMax（最近命中）；返回值 <= 0 时结束遍历（任意命中）
+        template <typename F>
+        void traverseRay(const Ray &ray, float tMax, F &&leafFn) const
+        {
+            if (nodes.empty() || primitives.empty())
+            {
+                return;
+            }
+            RayInverse r = rayInverse(ray);
+            float tNear;
+            if (!rayNode(nodes[0], r, tMax, &tNear))
+            {
+                return;
+            }
+            struct Entry
+            {
+                uint32_t node;
+                float tNear;
+            } stack[maxDepth];
+            uint32_t sp = 0;
+            uint32_t current = 0;
+            for (;;)
+            {
+                const BVHNode &n = nodes[current];
+                if (n.count > 0)
+                {
+                    for (uint32_t k = 0; k < n.count; k++)
+                    {
+                        tMax = leafFn(primitives[n.leftFirst + k], tMax);
+                        if (tMax <= 0.0f)
+                        {
+                            return;
+                        }
+                    }
+                }
+                else
+                {
+                    float tl, tr;
+                    bool hl = rayNode(nodes[n.leftFirst], r, tMax, &tl);
+                    bool hr = rayNode(nodes[n.leftFirst + 1], r, tMax, &tr);
+                    if (hl && hr)
+                    {
+                        // 先访问较近的子节点，较远的入栈
+                        uint32_t nearNode = tl <= tr ? n.leftFirst : n.leftFirst + 1;
+                        stack[sp].node = nearNode == n.leftFirst ? n.leftFirst + 1 : n.leftFirst;
+                        stack[sp].tNear = tl <= tr ? tr : tl;
+                        sp++;
+                        current = nearNode;
+                        continue;
+                    }
+                    if (hl || hr)
+                    {
+                        current = hl ? n.leftFirst : n.leftFirst + 1;
+                        continue;
+                    }
+                }
+                // 出栈，跳过已经比最近命中更远的节点
+                for (;;)
+                {
+                    if (sp == 0)
+                    {
+                        return;
+                    }
+                    sp--;
+                    if (stack[sp].tNear <= tMax)
+                    {
+                        current = stack[sp].node;
+                        break;
+                    }
+                }
+            }
+        }
+
+        /// @brief 包围盒重叠查询（碰撞检测的粗测阶段）
+        /// @param boundsMin,boundsMax 查询包围盒
+        /// @param fn 回调 fn(uint32_t primitive)，对每个与查询包围盒重叠的叶节点中的图元调用
+        template <typename F>
+        void queryAABB(const float boundsMin[3], const float boundsMax[3], F &&fn) const
+        {
+            if (nodes.empty() || primitives.empty())
+            {
+                return;
+            }
+            auto overlaps = [&](const BVHNode &n)
+            {
+                return n.boundsMin[0] <= boundsMax[0] && n.boundsMax[0] >= boundsMin[0] &&
+                       n.boundsMin[1] <= boundsMax[1] && n.boundsMax[1] >= boundsMin[1] &&
+                       n.boundsMin[2] <= boundsMax[2] && n.boundsMax[2] >= boundsMin[2];
+            };
+            if (!overlaps(nodes[0]))
+            {
+                return;
+            }
+            uint32_t stack[maxDepth];
+            uint32_t sp = 0;
+            stack[sp++] = 0;
+            while (sp > 0)
+            {
+                const BVHNode &n = nodes[stack[--sp]];
+                if (n.count > 0)
+                {
+                    for (uint32_t k = 0; k < n.count; k++)
+                    {
+                        fn(primitives[n.leftFirst + k]);
+                    }
+                    continue;
+                }
+                for (uint32_t c = 0; c < 2; c++)
+                {
+                    if (overlaps(nodes[n.leftFirst + c]))
+                    {
+                        stack[sp++] = n.leftFirst + c;
+                    }
+                }
+            }
+        }
+
+        size_t nodeCount() const { return nodes.size(); }
+        const BVHNode *nodeData() const { return nodes.data(); }
+        const uint32_t *primitiveIndices() const { return primitives.data(); }
+    };
+
+    /// @brief 用 BVH 加速的射线与三角形最近交点
+    /// @param bvh 由 triangleBounds() 的结果构建的 BVH
+    /// @param tMax 只接受 t < tMax 的命中
+    /// @param hit 命中时写入最近交点
+    /// @return 是否命中
+    inline bool intersectRayTriangles(const BVH &bvh, const Ray &ray, const TriangleArraysSoA &tris, float tMax, RayHit *hit)
+    {
+        bool found = false;
+        bvh.traverseRay(ray, tMax, [&](uint32_t i, float t)
+                        {
+                            const float v0[3] = {tris.v0x[i], tris.v0y[i], tris.v0z[i]};
+                            const float e1[3] = {tris.e1x[i], tris.e1y[i], tris.e1z[i]};
+                            const float e2[3] = {tris.e2x[i], tris.e2y[i], tris.e2z[i]};
+                            float tt, u, v;
+                            if (intersectRayTriangle(ray, v0, e1, e2, t, &tt, &u, &v))
+                            {
+                                hit->t = tt;
+                                hit->u = u;
+                                hit->v = v;
+                                hit->index = i;
+                                found = true;
+                                return tt;
+                            }
+                            return t; });
+        return found;
+    }
+
+    /// @brief 遮挡查询：射线在 tMax 之前是否与任意三角形相交
+    inline bool occludedRayTriangles(const BVH &bvh, const Ray &ray, const TriangleArraysSoA &tris, float tMax)
+    {
+        bool occluded = false;
+        bvh.traverseRay(ray, tMax, [&](uint32_t i, float t)
+                        {
+                            const float v0[3] = {tris.v0x[i], tris.v0y[i], tris.v0z[i]};
+                            const float e1[3] = {tris.e1x[i], tris.e1y[i], tris.e1z[i]};
+                            const float e2[3] = {tris.e2x[i], tris.e2y[i], tris.e2z[i]};
+                            float tt, u, v;
+                            occluded = intersectRayTriangle(ray, v0, e1, e2, t, &tt, &u, &v);
+                            return occluded ? 0.0f : t; });
+        return occluded;
+    }
+} // namespace glmCS
+
+#endif // __CSBVH_H__
@@ -0,0 +1,278 @@
+/// @ref core
+/// @file cscamera.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Perspective camera with lazily cached matrices.
+/// Camera stores eye, target, up, field of view, aspect ratio, clip planes and depth convention. Derived data is
+/// computed on first use after a change and then served from the cache. That data is the view matrix and its
+/// inverse, the projection and its analytic inverse, view-projection, inverse view-projection, and the frustum
+/// planes. Each item has its own dirty bit, so moving the camera never recomputes the projection (no tan) and
+/// resizing the window never recomputes the view. Setters that receive the current value change nothing.
+/// version() increases whenever a parameter really changes, so other systems can cache their own results
+/// (culling lists, shadow splits) against it.
+///
+/// The getters are const but fill the cache, so concurrent readers must not race on a dirty camera: call
+/// update() once per frame on the owning thread, after which every getter is a plain read.
+///
+/// glmCS::Camera camera;
+/// camera.setPerspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+/// camera.setLookAt(glmCS::vec3(0, 2, 5), glmCS::vec3(0, 0, 0), glmCS::vec3(0, 1, 0));
+/// camera.update();
+/// glUniformMatrix4fv(loc, 1, GL_FALSE, glmCS::valuePtr(camera.viewProjection()));
+/// glmCS::cullAABBs(camera.frustum(), boxes, count, visible);
+///
+
+#ifndef __CSCAMERA_H__
+#define __CSCAMERA_H__
+
+#include <math.h>
+#include <stdint.h>
+#include "csmatrix_utils.hpp"
+#include "csprojection_utils.hpp"
+#include "csfrustum_utils.hpp"
+
+namespace glmCS
+{
+    // 投影的深度约定
+    enum CameraDepthMode
+    {
+        GLMCS_depth_negative_one_to_one = 0, // OpenGL 默认 [-1,1]
+        GLMCS_depth_zero_to_one,             // Vulkan / D3D / glClipControl(GL_ZERO_TO_ONE)
+        GLMCS_depth_reverse_z                // [0,1]，近平面为 1、远平面为 0
+    };
+
+    class Camera
+    {
+    public:
+        Camera()
+        {
+            eyePos = vec3(0.0f, 0.0f, 0.0f);
+            targetPos = vec3(0.0f, 0.0f, -1.0f);
+            upDir = vec3(0.0f, 1.0f, 0.0f);
+        }
+
+        // ---------------------------------------------------------------- 参数
+
+        void setLookAt(const Vector3 &eye, const Vector3 &target, const Vector3 &up)
+        {
+            if (!equal(eyePos, eye) || !equal(targetPos, target) || !equal(upDir, up))
+            {
+                eyePos = eye;
+                targetPos = target;
+                upDir = up;
+                changed(dirtyView);
+            }
+        }
+
+        void setPosition(const Vector3 &eye) { setLookAt(eye, targetPos, upDir); }
+        void setTarget(const Vector3 &target) { setLookAt(eyePos, target, upDir); }
+        void setUp(const Vector3 &up) { setLookAt(eyePos, targetPos, up); }
+
+        /// @brief 设置透视投影
+        /// @param fov 垂直视野角度（弧度）
+        /// @param aspectRatio 纵横比
+        /// @param nearPlane,farPlane 近、远平面距离，farPlane 为 INFINITY 时使用无穷远投影
+        void setPerspective(float fov, float aspectRatio, float nearPlane, float farPlane)
+        {
+            if (fovY != fov || aspect != aspectRatio || zNear != nearPlane || zFar != farPlane)
+            {
+                fovY = fov;
+                aspect = aspectRatio;
+                zNear = nearPlane;
+                zFar = farPlane;
+                changed(dirtyProjection);
+            }
+        }
+
+        void setFov(float fov) { setPerspective(fov, aspect, zNear, zFar); }
+        void setAspectRatio(float aspectRatio) { setPerspective(fovY, aspectRatio, zNear, zFar); }
+        void setClipPlanes(float nearPlane, float farPlane) { setPerspective(fovY, aspect, nearPlane, farPlane); }
+
+        void setDepthMode(CameraDepthMode mode)
+        {
+            if (depth != mode)
+            {
+                depth = mode;
+                changed(dirtyProjection);
+            }
+        }
+
+        const Vector3 &position() const { return eyePos; }
+        const Vector3 &target() const { return targetPos; }
+        const Vector3 &up() const { return upDir; }
+        float fov() const { return fovY; }
+        float aspectRatio() const { return aspect; }
+        float nearPlane() const { return zNear; }
+        float farPlane() const { return zFar; }
+        CameraDepthMode depthMode() const { return depth; }
+
+        // 参数每次实际改变时递增
+        uint32_t version() const { return changeCount; }
+
+        // ---------------------------------------------------------------- 派生数据（按需计算并缓存）
+
+        // 观察矩阵，与 lookAt(eye, target, up) 相同
+        const Matrix<float, 4, 4> &view() const
+        {
+            if (dirty & dirtyView)
+            {
+                updateView();
+            }
+            return viewMat;
+        }
+
+        // 观察矩阵的逆（相机的世界矩阵）
+        const Matrix<float, 4, 4> &inverseView() const
+        {
+            if (dirty & dirtyView)
+            {
+                updateView();
+            }
+            return inverseViewMat;
+        }
+
+        const Matrix<float, 4, 4> &projection() const
+        {
+            if (dirty & dirtyProjection)
+            {
+                updateProjection();
+            }
+            return proj.matrix;
+        }
+
+        const Matrix<float, 4, 4> &inverseProjection() const
+        {
+            if (dirty & dirtyProjection)
+            {
+                updateProjection();
+            }
+            return proj.inverse;
+        }
+
+        // matrixMultiply(view, projection)，与 GLSL 的 projection * view 相同
+        const Matrix<float, 4, 4> &viewProjection() const
+        {
+            if (dirty & dirtyViewProjection)
+            {
+                viewProjectionMat = matrixMultiply(view(), projection().mat);
+                dirty &= ~uint32_t(dirtyViewProjection);
+            }
+            return viewProjectionMat;
+        }
+
+        // 由两个解析逆矩阵相乘得到，无需通用 4x4 求逆
+        const Matrix<float, 4, 4> &inverseViewProjection() const
+        {
+            if (dirty & dirtyInverseViewProjection)
+            {
+                inverseViewProjectionMat = matrixMultiply(inverseProjection(), inverseView().mat);
+                dirty &= ~uint32_t(dirtyInverseViewProjection);
+            }
+            return inverseViewProjectionMat;
+        }
+
+        const Frustum &frustum() const
+        {
+            if (dirty & dirtyFrustum)
+            {
+                frustumPlanes = extractFrustum(viewProjection(), depth != GLMCS_depth_negative_one_to_one);
+                dirty &= ~uint32_t(dirtyFrustum);
+            }
+            return frustumPlanes;
+        }
+
+        // 计算全部过期的派生数据，之后各个 getter 只读不写，可供多个线程同时读取
+        void update() const
+        {
+            if (dirty != 0)
+            {
+                inverseViewProjection();
+                frustum();
+            }
+        }
+
+    private:
+        enum
+        {
+            dirtyView = 1u << 0,
+            dirtyProjection = 1u << 1,
+            dirtyViewProjection = 1u << 2,
+            dirtyInverseViewProjection = 1u << 3,
+            dirtyFrustum = 1u << 4,
+            dirtyAll = (1u << 5) - 1u
+        };
+
+        Vector3 eyePos, targetPos, upDir;
+        float fovY = 1.0f;
+        float aspect = 1.0f;
+        float zNear = 0.1f;
+        float zFar = 1000.0f;
+        CameraDepthMode depth = GLMCS_depth_negative_one_to_one;
+        uint32_t changeCount = 0;
+
+        mutable uint32_t dirty = dirtyAll;
+        mutable Matrix<float, 4, 4> viewMat, inverseViewMat;
+        mutable Projection<float> proj;
+        mutable Matrix<float, 4, 4> viewProjectionMat, inverseViewProjectionMat;
+        mutable Frustum frustumPlanes;
+
+        static bool equal(const Vector3 &a, const Vector3 &b)
+        {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        }
+
+        // source 改变后，所有依赖它的派生数据都过期
+        void changed(uint32_t source)
+        {
+            dirty |= source | dirtyViewProjection | dirtyInverseViewProjection | dirtyFrustum;
+            changeCount++;
+        }
+
+        void updateView() const
+        {
+            viewMat = lookAt(eyePos, targetPos, upDir);
+            // 旋转部分正交：逆矩阵为转置，平移为相机位置
+            inverseViewMat = initIdentityMatrix<float, 4>();
+            for (size_t c = 0; c < 3; c++)
+            {
+                for (size_t r = 0; r < 3; r++)
+                {
+                    inverseViewMat.mat[c][r] = viewMat.mat[r][c];
+                }
+            }
+            inverseViewMat.mat[3][0] = eyePos.x;
+            inverseViewMat.mat[3][1] = eyePos.y;
+            inverseViewMat.mat[3][2] = eyePos.z;
+            dirty &= ~uint32_t(dirtyView);
+        }
+
+        void updateProjection() const
+        {
+            bool infinite = isinf(zFar) != 0;
+            switch (depth)
+            {
+            case GLMCS_depth_zero_to_one:
+                if (infinite)
+                {
+                    float f = 1.0f / tanf(fovY * 0.5f);
+                    proj = perspectiveFromTerms<float>(f / aspect, f, -1.0f, -zNear);
+                }
+                else
+                {
+                    proj = perspectiveZO<float>(fovY, aspect, zNear, zFar);
+                }
+                break;
+            case GLMCS_depth_reverse_z:
+                proj = infinite ? perspectiveInfiniteReverseZ<float>(fovY, aspect, zNear) : perspectiveReverseZ<float>(fovY, aspect, zNear, zFar);
+                break;
+            default:
+                proj = infinite ? perspectiveInfinite<float>(fovY, aspect, zNear) : perspectiveWithInverse<float>(fovY, aspect, zNear, zFar);
+                break;
+            }
+            dirty &= ~uint32_t(dirtyProjection);
+        }
+    };
+} // namespace glmCS
+
+#endif // __CSCAMERA_H__
@@ -0,0 +1,155 @@
+/// @ref core
+/// @file cserror_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Error channel for the glmCS math functions, without any I/O on the hot paths.
+/// A failed check returns a status code from the function itself (GLMCS_false / GLMCS_not_rotate), bumps a
+/// thread-local per-code counter and, if one is installed, calls a user callback. The reporting function is
+/// marked cold and out of line, so the checked paths stay a single predictable branch.
+/// Defining GLMCS_NO_CHECKS (CMake option GLMCS_NO_CHECKS) removes the math checks (GLMCS_CHECK) entirely:
+/// a zero-length normalize() then gives IEEE results (inf / NaN) and the hot paths compile to straight-line math.
+/// Guards whose failure would rotate about the wrong axis or read out of bounds (GLMCS_GUARD: the rotate() axis
+/// test, triangle index ranges) stay compiled in; only their reporting is removed.
+///
+/// glmCS::setErrorCallback(glmCS::logErrorToStderr);           // 恢复以前的 stderr 输出
+/// if (glmCS::normalize(&v) != GLMCS_ok) { ... }                // 返回码
+/// uint32_t n = glmCS::errorCount(GLMCS_error_zero_length);     // 本线程累计次数
+///
+
+#ifndef __CSERROR_UTILS_H__
+#define __CSERROR_UTILS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+enum
+{
+    GLMCS_false = -1,
+    GLMCS_not_rotate = 0,
+    GLMCS_ok = 1
+};
+
+// 错误码（回调与计数器使用）
+enum
+{
+    GLMCS_error_none = 0,
+    GLMCS_error_zero_length,        // normalize() 的向量长度为 0
+    GLMCS_error_invalid_axis,       // rotate() 的 x,y,z 不是恰好一个为 1
+    GLMCS_error_singular_matrix,    // decomposeTRS() 的 3x3 部分奇异（某一轴缩放为 0）
+    GLMCS_error_index_out_of_range, // 三角形索引超出顶点个数
+    GLMCS_error_count
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GLMCS_LIKELY(x) __builtin_expect(!!(x), 1)
+#define GLMCS_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define GLMCS_LIKELY(x) (x)
+#define GLMCS_COLD __declspec(noinline)
+#else
+#define GLMCS_LIKELY(x) (x)
+#define GLMCS_COLD
+#endif
+
+// GLMCS_CHECK：条件成立时为 true；不成立时上报错误并为 false。GLMCS_NO_CHECKS 下恒为 true，检查被完全移除
+// GLMCS_GUARD：同上，但 GLMCS_NO_CHECKS 下仍判断条件、只去掉上报，用于失败会越界访问或得到错误结果的检查
+#if defined(GLMCS_NO_CHECKS)
+#define GLMCS_CHECK(condition, code, function) (true)
+#define GLMCS_GUARD(condition, code, function) GLMCS_LIKELY(condition)
+#else
+#define GLMCS_CHECK(condition, code, function) \
+    (GLMCS_LIKELY(condition) || (::glmCS::reportError((code), (function), __FILE__, __LINE__), false))
+#define GLMCS_GUARD(condition, code, function) GLMCS_CHECK(condition, code, function)
+#endif
+
+namespace glmCS
+{
+    /// @brief 错误回调
+    /// @param code 错误码 GLMCS_error_*
+    /// @param function 出错的函数名
+    /// @param file,line 检查所在的位置
+    /// @param user setErrorCallback() 传入的用户数据
+    typedef void (*ErrorCallback)(int code, const char *function, const char *file, int line, void *user);
+
+    struct ErrorHandler
+    {
+        ErrorCallback callback;
+        void *user;
+    };
+
+    // 全局回调，应在启动工作线程之前设置
+    inline ErrorHandler &errorHandler()
+    {
+        static ErrorHandler handler = {nullptr, nullptr};
+        return handler;
+    }
+
+    // 本线程各错误码的累计次数
+    inline uint32_t *threadErrorCounters()
+    {
+        static thread_local uint32_t counters[GLMCS_error_count] = {};
+        return counters;
+    }
+
+    inline void setErrorCallback(ErrorCallback callback, void *user = nullptr)
+    {
+        errorHandler().callback = callback;
+        errorHandler().user = user;
+    }
+
+    inline uint32_t errorCount(int code)
+    {
+        return (code > GLMCS_error_none && code < GLMCS_error_count) ? threadErrorCounters()[code] : 0;
+    }
+
+    inline void resetErrorCounters()
+    {
+        uint32_t *counters = threadErrorCounters();
+        for (int i = 0; i < GLMCS_error_count; i++)
+        {
+            counters[i] = 0;
+        }
+    }
+
+    inline const char *errorName(int code)
+    {
+        switch (code)
+        {
+        case GLMCS_error_none:
+            return "none";
+        case GLMCS_error_zero_length:
+            return "zero-length vector";
+        case GLMCS_error_invalid_axis:
+            return "rotation axis must have exactly one of x, y, z set";
+        case GLMCS_error_singular_matrix:
+            return "singular matrix";
+        case GLMCS_error_index_out_of_range:
+            return "index out of range";
+        default:
+            return "unknown error";
+        }
+    }
+
+    // 失败路径：计数并调用回调，不内联
+    GLMCS_COLD inline void reportError(int code, const char *function, const char *file, int line)
+    {
+        if (code > GLMCS_error_none && code < GLMCS_error_count)
+        {
+            threadErrorCounters()[code]++;
+        }
+        const ErrorHandler &handler = errorHandler();
+        if (handler.callback)
+        {
+            handler.callback(code, function, file, line, handler.user);
+        }
+    }
+
+    // 可选的回调：打印到 stderr（调试用）
+    inline void logErrorToStderr(int code, const char *function, const char *file, int line, void *)
+    {
+        fprintf(stderr, "[%s:%i] [%s error] %s\n", file, line, function, errorName(code));
+    }
+} // namespace glmCS
+
+#endif // __CSERROR_UTILS_H__
@@ -0,0 +1,215 @@
+/// @ref core
+/// @file csframe_arena.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Per-frame linear arena for transient glmCS data (matrix / vector arrays, scratch buffers).
+/// Allocation bumps a pointer inside one block; nothing is freed individually. reset() releases everything at once
+/// at the end of the frame. Every allocation is 32-byte aligned by default, so AVX code can use aligned loads on
+/// matrix arrays. If a frame needs more than the block holds, extra blocks are chained for the rest of that frame.
+/// The next reset() then replaces them with one block large enough for the peak, so in steady state all transient
+/// transform data lives in a single cache-warm block. The arena does not run destructors: allocateArray() only
+/// accepts trivially destructible types, and containers built on FrameAllocator must be gone before reset().
+/// An arena is not thread-safe; give each worker thread its own.
+///
+/// glmCS::FrameArena arena(1 << 20);
+/// glmCS::Matrix<float, 4, 4> *mvp = arena.allocateArray<glmCS::Matrix<float, 4, 4>>(count);
+/// glmCS::FrameVector<glmCS::Vector3> points{glmCS::FrameAllocator<glmCS::Vector3>(arena)};
+/// ...
+/// arena.reset(); // 每帧结束时
+///
+
+#ifndef __CSFRAME_ARENA_H__
+#define __CSFRAME_ARENA_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace glmCS
+{
+    class FrameArena
+    {
+    public:
+        static constexpr size_t defaultAlignment = 32; // AVX 寄存器宽度
+        static constexpr size_t blockAlignment = 64;   // 块首地址按缓存行对齐
+
+        /// @param capacity 初始块的字节数
+        explicit FrameArena(size_t capacity = size_t(1) << 20)
+        {
+            addBlock(capacity > 0 ? capacity : blockAlignment);
+        }
+
+        ~FrameArena()
+        {
+            releaseBlocks();
+        }
+
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        /// @brief 分配 bytes 字节，内容未初始化
+        /// @param alignment 2 的幂
+        void *allocate(size_t bytes, size_t alignment = defaultAlignment)
+        {
+            Block &block = blocks.back();
+            uintptr_t begin = reinterpret_cast<uintptr_t>(block.data);
+            uintptr_t aligned = (begin + top + alignment - 1) & ~uintptr_t(alignment - 1);
+            size_t offset = size_t(aligned - begin);
+            if (offset <= block.size && bytes <= block.size - offset)
+            {
+                frameUsed += offset + bytes - top;
+                top = offset + bytes;
+                peak = frameUsed > peak ? frameUsed : peak;
+                return block.data + offset;
+            }
+            return allocateOverflow(bytes, alignment);
+        }
+
+        /// @brief 释放最近一次的分配（例如分配后立即销毁的临时容器），其他情况不做任何事；
+        /// std::vector 扩容时新缓冲区先于旧缓冲区分配，旧缓冲区不是最近一次分配，无法回收
+        void deallocate(void *p, size_t bytes)
+        {
+            unsigned char *end = static_cast<unsigned char *>(p) + bytes;
+            Block &block = blocks.back();
+            if (end == block.data + top)
+            {
+                size_t offset = size_t(static_cast<unsigned char *>(p) - block.data);
+                frameUsed -= top - offset;
+                top = offset;
+            }
+        }
+
+        /// @brief 分配 count 个 T 的数组（未初始化），按 max(alignof(T), defaultAlignment) 对齐
+        template <typename T>
+        T *allocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "FrameArena does not run destructors");
+            if (count > size_t(-1) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(allocate(count * sizeof(T), alignof(T) > defaultAlignment ? alignof(T) : defaultAlignment));
+        }
+
+        /// @brief 释放本帧的全部分配。本帧溢出到额外的块时，合并为一个能容纳峰值用量的块
+        void reset()
+        {
+            if (blocks.size() > 1)
+            {
+                size_t capacity = blocks[0].size;
+                while (capacity < peak)
+                {
+                    capacity *= 2;
+                }
+                releaseBlocks();
+                addBlock(capacity);
+            }
+            top = 0;
+            frameUsed = 0;
+        }
+
+        // 本帧已使用的字节数（含对齐填充）
+        size_t used() const { return frameUsed; }
+        // 当前各块的总字节数
+        size_t capacity() const
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < blocks.size(); i++)
+            {
+                total += blocks[i].size;
+            }
+            return total;
+        }
+        // 自创建以来单帧用量的峰值
+        size_t peakUsed() const { return peak; }
+
+    private:
+        struct Block
+        {
+            unsigned char *data;
+            size_t size;
+        };
+
+        std::vector<Block> blocks; // blocks.back() 为当前分配的块
+        size_t top = 0;            // 当前块内已用的字节数
+        size_t frameUsed = 0;
+        size_t peak = 0;
+
+        void addBlock(size_t size)
+        {
+            blocks.reserve(blocks.size() + 1);
+            Block block = {static_cast<unsigned char *>(::operator new(size, std::align_val_t(blockAlignment))), size};
+            blocks.push_back(block);
+        }
+
+        void releaseBlocks()
+        {
+            for (size_t i = 0; i < blocks.size(); i++)
+            {
+                ::operator delete(blocks[i].data, std::align_val_t(blockAlignment));
+            }
+            blocks.clear();
+        }
+
+        // 当前块放不下：新建一个至少与初始块一样大的块，仅在本帧内使用
+        void *allocateOverflow(size_t bytes, size_t alignment)
+        {
+            size_t padding = alignment > blockAlignment ? alignment : 0;
+            if (bytes > size_t(-1) - padding)
+            {
+                throw std::bad_alloc();
+            }
+            size_t size = bytes + padding > blocks[0].size ? bytes + padding : blocks[0].size;
+            frameUsed += blocks.back().size - top; // 旧块剩余部分计入用量，使 reset() 后的单块足够大
+            addBlock(size);
+            top = 0;
+            return allocate(bytes, alignment);
+        }
+    };
+
+    /// @brief 从 FrameArena 分配的 STL 分配器，deallocate 只回收最近一次分配
+    template <typename T>
+    class FrameAllocator
+    {
+    public:
+        typedef T value_type;
+
+        explicit FrameAllocator(FrameArena &arena) noexcept : arena(&arena) {}
+        template <typename U>
+        FrameAllocator(const FrameAllocator<U> &other) noexcept : arena(other.arena) {}
+
+        T *allocate(size_t count)
+        {
+            if (count > size_t(-1) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T) > FrameArena::defaultAlignment ? alignof(T) : FrameArena::defaultAlignment));
+        }
+
+        void deallocate(T *p, size_t count) noexcept
+        {
+            arena->deallocate(p, count * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const FrameAllocator<U> &other) const noexcept { return arena == other.arena; }
+        template <typename U>
+        bool operator!=(const FrameAllocator<U> &other) const noexcept { return arena != other.arena; }
+
+    private:
+        template <typename U>
+        friend class FrameAllocator;
+
+        FrameArena *arena;
+    };
+
+    // 分配在帧内存上的 std::vector，须在 FrameArena::reset() 之前销毁
+    template <typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+} // namespace glmCS
+
+#endif // __CSFRAME_ARENA_H__
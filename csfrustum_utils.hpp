@@ -0,0 +1,327 @@
+/// @ref core
+/// @file csfrustum_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Frustum planes from glmCS matrices and batched frustum culling.
+/// extractFrustum() turns any view-projection matrix (e.g. the product of lookAt and perspective) into six
+/// normalized planes. The batch functions test structure-of-arrays bounding volumes 8 at a time with AVX
+/// (4 at a time with NEON, scalar elsewhere) and write a visibility bitmask (bit i of word i / 32) or a compact
+/// index list. Large batches can be split across threads.
+///
+/// glmCS::Matrix<float, 4, 4> vp = glmCS::matrixMultiply(view, projection.mat);
+/// glmCS::Frustum frustum = glmCS::extractFrustum(vp);
+/// glmCS::AABBArraysSoA boxes = {cx, cy, cz, ex, ey, ez};
+/// size_t visible = glmCS::cullAABBsToIndices(frustum, boxes, count, indices, 4);
+///
+
+#ifndef __CSFRUSTUM_UTILS_H__
+#define __CSFRUSTUM_UTILS_H__
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    enum FrustumPlane
+    {
+        GLMCS_plane_left = 0,
+        GLMCS_plane_right,
+        GLMCS_plane_bottom,
+        GLMCS_plane_top,
+        GLMCS_plane_near,
+        GLMCS_plane_far
+    };
+
+    // 视锥体：6 个平面 (a, b, c, d)，法线指向内部，a*x + b*y + c*z + d >= 0 为内侧
+    struct Frustum
+    {
+        float planes[6][4];
+    };
+
+    // SoA 排列的轴对齐包围盒（中心 + 半边长）
+    struct AABBArraysSoA
+    {
+        const float *centerX, *centerY, *centerZ;
+        const float *extentX, *extentY, *extentZ;
+    };
+
+    // SoA 排列的包围球
+    struct SphereArraysSoA
+    {
+        const float *centerX, *centerY, *centerZ;
+        const float *radius;
+    };
+
+    /// @brief 从观察投影矩阵中提取视锥体平面（Gribb-Hartmann）
+    /// @param viewProjection 观察投影矩阵（matrixMultiply(view, projection)，与 GLSL 的 projection * view 相同）
+    /// @param zeroToOneDepth 投影矩阵的深度范围是否为 [0,1]（默认为 OpenGL 的 [-1,1]）
+    /// @return 归一化的视锥体平面；无限远平面退化为恒为内侧的平面
+    inline Frustum extractFrustum(const Matrix<float, 4, 4> &viewProjection, bool zeroToOneDepth = false)
+    {
+        // GLSL 意义下的第 r 行为 (mat[0][r], mat[1][r], mat[2][r], mat[3][r])
+        float row[4][4];
+        for (size_t r = 0; r < 4; r++)
+        {
+            for (size_t c = 0; c < 4; c++)
+            {
+                row[r][c] = viewProjection.mat[c][r];
+            }
+        }
+        Frustum f;
+        for (size_t c = 0; c < 4; c++)
+        {
+            f.planes[GLMCS_plane_left][c] = row[3][c] + row[0][c];
+            f.planes[GLMCS_plane_right][c] = row[3][c] - row[0][c];
+            f.planes[GLMCS_plane_bottom][c] = row[3][c] + row[1][c];
+            f.planes[GLMCS_plane_top][c] = row[3][c] - row[1][c];
+            f.planes[GLMCS_plane_near][c] = zeroToOneDepth ? row[2][c] : row[3][c] + row[2][c];
+            f.planes[GLMCS_plane_far][c] = row[3][c] - row[2][c];
+        }
+        for (size_t p = 0; p < 6; p++)
+        {
+            float *pl = f.planes[p];
+            float len = sqrtf(pl[0] * pl[0] + pl[1] * pl[1] + pl[2] * pl[2]);
+            if (len > 0.0f)
+            {
+                float inv = 1.0f / len;
+                pl[0] *= inv;
+                pl[1] *= inv;
+                pl[2] *= inv;
+                pl[3] *= inv;
+            }
+            else
+            {
+                pl[0] = pl[1] = pl[2] = 0.0f;
+                pl[3] = 1.0f;
+            }
+        }
+        return f;
+    }
+
+    // 单个包围盒是否与视锥体相交
+    inline bool intersectAABB(const Frustum &f, float cx, float cy, float cz, float ex, float ey, float ez)
+    {
+        for (size_t p = 0; p < 6; p++)
+        {
+            const float *pl = f.planes[p];
+            float d = pl[0] * cx + pl[1] * cy + pl[2] * cz + pl[3];
+            float r = fabsf(pl[0]) * ex + fabsf(pl[1]) * ey + fabsf(pl[2]) * ez;
+            if (d + r < 0.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 单个包围球是否与视锥体相交
+    inline bool intersectSphere(const Frustum &f, float cx, float cy, float cz, float radius)
+    {
+        for (size_t p = 0; p < 6; p++)
+        {
+            const float *pl = f.planes[p];
+            if (pl[0] * cx + pl[1] * cy + pl[2] * cz + pl[3] < -radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 将 [begin, end) 的可见性写入位掩码，begin 必须是 32 的倍数
+    inline void cullAABBsRange(const Frustum &f, const AABBArraysSoA &b, size_t begin, size_t end, uint32_t *mask)
+    {
+        memset(mask + begin / 32, 0, ((end - begin) + 31) / 32 * sizeof(uint32_t));
+        size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+        __m256 px[6], py[6], pz[6], pw[6], ax[6], ay[6], az[6];
+        for (size_t p = 0; p < 6; p++)
+        {
+            px[p] = _mm256_set1_ps(f.planes[p][0]);
+            py[p] = _mm256_set1_ps(f.planes[p][1]);
+            pz[p] = _mm256_set1_ps(f.planes[p][2]);
+            pw[p] = _mm256_set1_ps(f.planes[p][3]);
+            ax[p] = _mm256_set1_ps(fabsf(f.planes[p][0]));
+            ay[p] = _mm256_set1_ps(fabsf(f.planes[p][1]));
+            az[p] = _mm256_set1_ps(fabsf(f.planes[p][2]));
+        }
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(b.centerX + i), cy = _mm256_loadu_ps(b.centerY + i), cz = _mm256_loadu_ps(b.centerZ + i);
+            __m256 ex = _mm256_loadu_ps(b.extentX + i), ey = _mm256_loadu_ps(b.extentY + i), ez = _mm256_loadu_ps(b.extentZ + i);
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (size_t p = 0; p < 6; p++)
+            {
+                // d + r = n.c + w + |n|.e >= 0
+                __m256 d = simd::madd(px[p], cx, pw[p]);
+                d = simd::madd(py[p], cy, d);
+                d = simd::madd(pz[p], cz, d);
+                d = simd::madd(ax[p], ex, d);
+                d = simd::madd(ay[p], ey, d);
+                d = simd::madd(az[p], ez, d);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            mask[i / 32] |= uint32_t(_mm256_movemask_ps(inside)) << (i % 32);
+        }
+#elif defined(GLMCS_HAS_NEON)
+        for (; i + 4 <= end; i += 4)
+        {
+            float32x4_t cx = vld1q_f32(b.centerX + i), cy = vld1q_f32(b.centerY + i), cz = vld1q_f32(b.centerZ + i);
+            float32x4_t ex = vld1q_f32(b.extentX + i), ey = vld1q_f32(b.extentY + i), ez = vld1q_f32(b.extentZ + i);
+            uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+            for (size_t p = 0; p < 6; p++)
+            {
+                const float *pl = f.planes[p];
+                float32x4_t d = vmlaq_n_f32(vdupq_n_f32(pl[3]), cx, pl[0]);
+                d = vmlaq_n_f32(d, cy, pl[1]);
+                d = vmlaq_n_f32(d, cz, pl[2]);
+                d = vmlaq_n_f32(d, ex, fabsf(pl[0]));
+                d = vmlaq_n_f32(d, ey, fabsf(pl[1]));
+                d = vmlaq_n_f32(d, ez, fabsf(pl[2]));
+                inside = vandq_u32(inside, vcgeq_f32(d, vdupq_n_f32(0.0f)));
+            }
+            const uint32x4_t bits = {1u, 2u, 4u, 8u};
+            mask[i / 32] |= vaddvq_u32(vandq_u32(inside, bits)) << (i % 32);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            if (intersectAABB(f, b.centerX[i], b.centerY[i], b.centerZ[i], b.extentX[i], b.extentY[i], b.extentZ[i]))
+            {
+                mask[i / 32] |= 1u << (i % 32);
+            }
+        }
+    }
+
+    // 将 [begin, end) 的可见性写入位掩码，begin 必须是 32 的倍数
+    inline void cullSpheresRange(const Frustum &f, const SphereArraysSoA &s, size_t begin, size_t end, uint32_t *mask)
+    {
+        memset(mask + begin / 32, 0, ((end - begin) + 31) / 32 * sizeof(uint32_t));
+        size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+        __m256 px[6], py[6], pz[6], pw[6];
+        for (size_t p = 0; p < 6; p++)
+        {
+            px[p] = _mm256_set1_ps(f.planes[p][0]);
+            py[p] = _mm256_set1_ps(f.planes[p][1]);
+            pz[p] = _mm256_set1_ps(f.planes[p][2]);
+            pw[p] = _mm256_set1_ps(f.planes[p][3]);
+        }
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(s.centerX + i), cy = _mm256_loadu_ps(s.centerY + i), cz = _mm256_loadu_ps(s.centerZ + i);
+            __m256 r = _mm256_loadu_ps(s.radius + i);
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (size_t p = 0; p < 6; p++)
+            {
+                __m256 d = simd::madd(px[p], cx, _mm256_add_ps(pw[p], r));
+                d = simd::madd(py[p], cy, d);
+                d = simd::madd(pz[p], cz, d);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            mask[i / 32] |= uint32_t(_mm256_movemask_ps(inside)) << (i % 32);
+        }
+#elif defined(GLMCS_HAS_NEON)
+        for (; i + 4 <= end; i += 4)
+        {
+            float32x4_t cx = vld1q_f32(s.centerX + i), cy = vld1q_f32(s.centerY + i), cz = vld1q_f32(s.centerZ + i);
+            float32x4_t r = vld1q_f32(s.radius + i);
+            uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+            for (size_t p = 0; p < 6; p++)
+            {
+                const float *pl = f.planes[p];
+                float32x4_t d = vmlaq_n_f32(vaddq_f32(vdupq_n_f32(pl[3]), r), cx, pl[0]);
+                d = vmlaq_n_f32(d, cy, pl[1]);
+                d = vmlaq_n_f32(d, cz, pl[2]);
+                inside = vandq_u32(inside, vcgeq_f32(d, vdupq_n_f32(0.0f)));
+            }
+            const uint32x4_t bits = {1u, 2u, 4u, 8u};
+            mask[i / 32] |= vaddvq_u32(vandq_u32(inside, bits)) << (i % 32);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            if (intersectSphere(f, s.centerX[i], s.centerY[i], s.centerZ[i], s.radius[i]))
+            {
+                mask[i / 32] |= 1u << (i % 32);
+            }
+        }
+    }
+
+    /// @brief 批量视锥体剔除包围盒
+    /// @param f 视锥体
+    /// @param boxes SoA 包围盒数组
+    /// @param count 包围盒个数
+    /// @param visibleMask 输出位掩码，至少 (count + 31) / 32 个 uint32_t
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void cullAABBs(const Frustum &f, const AABBArraysSoA &boxes, size_t count, uint32_t *visibleMask, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { cullAABBsRange(f, boxes, begin, end, visibleMask); }, 32);
+    }
+
+    /// @brief 批量视锥体剔除包围球
+    /// @param f 视锥体
+    /// @param spheres SoA 包围球数组
+    /// @param count 包围球个数
+    /// @param visibleMask 输出位掩码，至少 (count + 31) / 32 个 uint32_t
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void cullSpheres(const Frustum &f, const SphereArraysSoA &spheres, size_t count, uint32_t *visibleMask, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { cullSpheresRange(f, spheres, begin, end, visibleMask); }, 32);
+    }
+
+    /// @brief 将位掩码转换为紧凑的下标列表
+    /// @return 可见元素个数
+    inline size_t maskToIndices(const uint32_t *mask, size_t count, uint32_t *indices)
+    {
+        size_t n = 0;
+        for (size_t w = 0; w < (count + 31) / 32; w++)
+        {
+            uint32_t bits = mask[w];
+            while (bits != 0)
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                uint32_t b = uint32_t(__builtin_ctz(bits));
+#else
+                uint32_t b = 0;
+                while (((bits >> b) & 1u) == 0)
+                {
+                    b++;
+                }
+#endif
+                indices[n++] = uint32_t(w * 32 + b);
+                bits &= bits - 1;
+            }
+        }
+        return n;
+    }
+
+    /// @brief 批量视锥体剔除包围盒，输出可见包围盒的下标
+    /// @param indices 输出下标，至少 count 个
+    /// @return 可见包围盒个数
+    inline size_t cullAABBsToIndices(const Frustum &f, const AABBArraysSoA &boxes, size_t count, uint32_t *indices, unsigned threads = 1)
+    {
+        std::vector<uint32_t> mask((count + 31) / 32);
+        cullAABBs(f, boxes, count, mask.data(), threads);
+        return maskToIndices(mask.data(), count, indices);
+    }
+
+    /// @brief 批量视锥体剔除包围球，输出可见包围球的下标
+    /// @param indices 输出下标，至少 count 个
+    /// @return 可见包围球个数
+    inline size_t cullSpheresToIndices(const Frustum &f, const SphereArraysSoA &spheres, size_t count, uint32_t *indices, unsigned threads = 1)
+    {
+        std::vector<uint32_t> mask((count + 31) / 32);
+        cullSpheres(f, spheres, count, mask.data(), threads);
+        return maskToIndices(mask.data(), count, indices);
+    }
+} // namespace glmCS
+
+#endif // __CSFRUSTUM_UTILS_H__
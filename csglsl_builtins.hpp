@@ -0,0 +1,1008 @@
+/// @ref core
+/// @file csglsl_builtins.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief GLSL built-in functions for scalars, Vector<T, N> and SIMD lanes, for CPU ports of shaders.
+/// Lane<T, W> holds W invocations of one scalar variable (one per pixel / vertex), in the style of SPMD shading.
+/// float lanes are stored in native registers: 8 per AVX register and 4 per SSE / NEON register. Lane<float, 16>
+/// uses two AVX registers or four SSE registers. Other widths and double use a plain array that the compiler may
+/// vectorize. Comparisons return LaneMask<T, W>, the bvec of a lane. Branches become select(mask, a, b) or
+/// mix(a, b, mask), and any(mask) / all(mask) decide whether a whole group can skip a branch.
+///
+/// Everything lives in glmCS::glsl. The names (floor, min, sqrt ...) would otherwise hide the C library functions
+/// inside glmCS. Vector<T, N> overloads work component-wise. float vec3 / vec4 use one Lane<float, 4>, and the
+/// padding lane of a vec3 stays 0. Vector<Lane<float, 8>, 3> is a vec3 of 8 invocations, and the existing dot /
+/// cross / length work on it unchanged.
+///
+/// using namespace glmCS::glsl;
+/// typedef glmCS::Vector<Lane8, 3> Vec3x8;
+/// Lane8 u = Lane8::ramp(x0 + 0.5f, 1.0f) * invWidth;            // 8 pixels of one row
+/// Lane8 edge = smoothstep(0.45f, 0.55f, fract(u * 8.0f));
+/// Vec3x8 n = normalize(Vec3x8(nx, ny, nz));
+/// Vec3x8 r = reflect(viewDir, n);
+/// Lane8 spec = pow(max(dot(r, lightDir), 0.0f), 32.0f);
+/// select(spec > 0.5f, Lane8(1.0f), edge).store(out);
+///
+/// Precision follows GLSL 4.60 section 4.7.1. a + b, a - b, a * b, a / b and sqrt are correctly rounded
+/// (GLSL allows 2.5 ULP for division). inversesqrt is 1 / sqrt (the limit is 2 ULP), so rsqrt estimates are
+/// not used. min / max / clamp / mix / step / smoothstep / fract / mod / reflect / refract / faceforward use
+/// the defining formula of the specification in the same order, so they "inherit" their precision exactly as
+/// GLSL requires: mix(x, y, a) = x * (1 - a) + y * a, mod(x, y) = x - y * floor(x / y), and so on. sin / cos on
+/// float lanes use the FastMath polynomials of csfast_math.hpp (absolute error below 1e-7 on [-8192, 8192],
+/// where the Vulkan environment asks for 2^-11 on [-pi, pi]). exp / exp2 / log / log2 / pow call the C library
+/// once per element, because they are the slow path and GLSL bounds them only loosely.
+///
+/// Largest error over 1M samples against the same formula in double (bench_glsl_builtins "precision/*"; SSE2 and
+/// -mavx2 -mfma builds give the same figures):
+///
+///   function                 GLSL limit        scalar          Lane<float, 8>
+///   a / b                    2.5 ULP           0.5 ULP         0.5 ULP
+///   sqrt                     inherited         0.5 ULP         0.5 ULP
+///   inversesqrt              2 ULP             1.47 ULP        1.47 ULP
+///   mix (x, y in [1, 8])     inherited         1.25 ULP        1.38 ULP
+///   smoothstep               inherited         7.6e-08 abs     7.6e-08 abs
+///   normalize (x component)  inherited         2.5e-07 abs     1.5e-07 abs
+///   sin [-pi, pi]            2^-11 abs         3.2e-08 abs     8.4e-08 abs
+///   cos [-8192, 8192]        2^-11 abs         3.3e-08 abs     9.1e-08 abs
+///
+/// Throughput on one x86-64 core, GCC 12 -O3 -mavx2 -mfma, 4096 elements (ns per element). The scalar loops of
+/// the simple functions are already vectorized by GCC, so lanes pay off where the scalar code calls libm or branches:
+///
+///   function        scalar    Lane4    Lane8    Lane16
+///   min / step      0.08      0.15     0.11     0.08
+///   floor           1.18      0.12     0.09     0.08
+///   smoothstep      1.95      0.35     0.19     0.19
+///   inversesqrt     2.62      0.66     0.62     0.61
+///   sin / cos       7.1       1.8      1.0      1.3
+///   exp2 (libm)     4.7       5.8      4.5      4.3
+///
+///   vec3 function   Vec3 AoS  Lane4x3  Lane8x3  Lane16x3
+///   normalize       2.0       0.94     0.97     0.89
+///   reflect         3.0       1.24     1.31     1.19
+///   refract         4.5       1.45     1.12     2.76 (register spills)
+///
+
+#ifndef __CSGLSL_BUILTINS_H__
+#define __CSGLSL_BUILTINS_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "csvector_utils.hpp"
+#include "csfast_math.hpp"
+
+namespace glmCS
+{
+    namespace glsl
+    {
+        namespace lane
+        {
+            // 每个寄存器容纳的元素个数：float 优先使用 AVX（8）再使用 SSE / NEON（4），其余按标量存储
+            template <typename T, size_t W>
+            struct RegisterWidth
+            {
+                static constexpr size_t value = 1;
+            };
+            template <size_t W>
+            struct RegisterWidth<float, W>
+            {
+#if defined(GLMCS_HAS_AVX)
+                static constexpr size_t value = W % 8 == 0 ? 8 : (W % 4 == 0 ? 4 : 1);
+#elif defined(GLMCS_HAS_SSE2) || defined(GLMCS_HAS_NEON)
+                static constexpr size_t value = W % 4 == 0 ? 4 : 1;
+#else
+                static constexpr size_t value = 1;
+#endif
+            };
+
+            // 单个寄存器上的运算，K 为寄存器的元素个数。标量实现（K = 1）的掩码为 bool。
+            // min / max 与 GLSL 的定义一致：min(a, b) = a < b ? a : b（SSE 的 minps 语义相同）
+            template <typename T, size_t K>
+            struct Ops;
+
+            template <typename T>
+            struct Ops<T, 1>
+            {
+                typedef T Reg;
+                typedef bool Mask;
+                static constexpr size_t width = 1;
+
+                static Reg load(const T *p) { return *p; }
+                static void store(T *p, Reg a) { *p = a; }
+                static Reg broadcast(T s) { return s; }
+                static Reg add(Reg a, Reg b) { return a + b; }
+                static Reg sub(Reg a, Reg b) { return a - b; }
+                static Reg mul(Reg a, Reg b) { return a * b; }
+                static Reg div(Reg a, Reg b) { return a / b; }
+                static Reg madd(Reg a, Reg b, Reg c) { return a * b + c; }
+                static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+                static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+                static Reg neg(Reg a) { return -a; }
+                static Reg abs(Reg a) { return ::fabs(a); }
+                static Reg sqrt(Reg a) { return ::sqrt(a); }
+                static Reg floor(Reg a) { return ::floor(a); }
+                static Reg ceil(Reg a) { return ::ceil(a); }
+                static Reg trunc(Reg a) { return ::trunc(a); }
+                static Reg roundEven(Reg a) { return ::nearbyint(a); } // 默认舍入模式为就近取偶
+                static Mask lt(Reg a, Reg b) { return a < b; }
+                static Mask le(Reg a, Reg b) { return a <= b; }
+                static Mask eq(Reg a, Reg b) { return a == b; }
+                static Mask ne(Reg a, Reg b) { return a != b; }
+                static Reg select(Mask m, Reg t, Reg f) { return m ? t : f; }
+                static Mask maskAnd(Mask a, Mask b) { return a && b; }
+                static Mask maskOr(Mask a, Mask b) { return a || b; }
+                static Mask maskXor(Mask a, Mask b) { return a != b; }
+                static Mask maskNot(Mask a) { return !a; }
+                static Mask maskAll(bool b) { return b; }
+                static uint32_t bits(Mask m) { return m ? 1u : 0u; }
+            };
+
+#if defined(GLMCS_HAS_SSE2)
+            template <>
+            struct Ops<float, 4>
+            {
+                typedef __m128 Reg;
+                typedef __m128 Mask;
+                static constexpr size_t width = 4;
+
+                static Reg load(const float *p) { return _mm_loadu_ps(p); }
+                static void store(float *p, Reg a) { _mm_storeu_ps(p, a); }
+                static Reg broadcast(float s) { return _mm_set1_ps(s); }
+                static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+                static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+                static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+                static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+                static Reg madd(Reg a, Reg b, Reg c) { return simd::madd(a, b, c); }
+                static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+                static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+                static Reg neg(Reg a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+                static Reg abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static Reg sqrt(Reg a) { return _mm_sqrt_ps(a); }
+#if defined(GLMCS_HAS_SSE41)
+                static Reg floor(Reg a) { return _mm_floor_ps(a); }
+                static Reg ceil(Reg a) { return _mm_ceil_ps(a); }
+                static Reg trunc(Reg a) { return _mm_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+                static Reg roundEven(Reg a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+#else
+                // |a| >= 2^23（以及 inf / nan）已经是整数，其余经 int32 截断并保留符号位（trunc(-0.5) = -0）
+                static Reg trunc(Reg a)
+                {
+                    Mask integral = _mm_cmpnlt_ps(abs(a), _mm_set1_ps(8388608.0f));
+                    Reg t = _mm_or_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(a)), _mm_and_ps(a, _mm_set1_ps(-0.0f)));
+                    return select(integral, a, t);
+                }
+                static Reg floor(Reg a)
+                {
+                    Reg t = trunc(a);
+                    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+                }
+                static Reg ceil(Reg a)
+                {
+                    // 负数的结果不大于 0，补回符号位（ceil(-0.5) = -0）
+                    Reg t = trunc(a);
+                    Reg r = _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, a), _mm_set1_ps(1.0f)));
+                    return _mm_or_ps(r, _mm_and_ps(a, _mm_set1_ps(-0.0f)));
+                }
+                // 加减带符号的 2^23，由硬件完成就近取偶；最后恢复符号位（-0.3 -> -0）
+                static Reg roundEven(Reg a)
+                {
+                    Reg sign = _mm_and_ps(a, _mm_set1_ps(-0.0f));
+                    Reg magic = _mm_or_ps(sign, _mm_set1_ps(8388608.0f));
+                    Reg r = _mm_or_ps(_mm_sub_ps(_mm_add_ps(a, magic), magic), sign);
+                    return select(_mm_cmpnlt_ps(abs(a), _mm_set1_ps(8388608.0f)), a, r);
+                }
+#endif
+                static Mask lt(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+                static Mask le(Reg a, Reg b) { return _mm_cmple_ps(a, b); }
+                static Mask eq(Reg a, Reg b) { return _mm_cmpeq_ps(a, b); }
+                static Mask ne(Reg a, Reg b) { return _mm_cmpneq_ps(a, b); }
+                static Reg select(Mask m, Reg t, Reg f)
+                {
+#if defined(GLMCS_HAS_SSE41)
+                    return _mm_blendv_ps(f, t, m);
+#else
+                    return _mm_or_ps(_mm_and_ps(m, t), _mm_andnot_ps(m, f));
+#endif
+                }
+                static Mask maskAnd(Mask a, Mask b) { return _mm_and_ps(a, b); }
+                static Mask maskOr(Mask a, Mask b) { return _mm_or_ps(a, b); }
+                static Mask maskXor(Mask a, Mask b) { return _mm_xor_ps(a, b); }
+                static Mask maskNot(Mask a) { return _mm_xor_ps(a, maskAll(true)); }
+                static Mask maskAll(bool b) { return _mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0)); }
+                static uint32_t bits(Mask m) { return uint32_t(_mm_movemask_ps(m)); }
+            };
+#elif defined(GLMCS_HAS_NEON)
+            template <>
+            struct Ops<float, 4>
+            {
+                typedef float32x4_t Reg;
+                typedef uint32x4_t Mask;
+                static constexpr size_t width = 4;
+
+                static Reg load(const float *p) { return vld1q_f32(p); }
+                static void store(float *p, Reg a) { vst1q_f32(p, a); }
+                static Reg broadcast(float s) { return vdupq_n_f32(s); }
+                static Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+                static Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+                static Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+                static Reg div(Reg a, Reg b) { return vdivq_f32(a, b); }
+                static Reg madd(Reg a, Reg b, Reg c) { return simd::madd(a, b, c); }
+                // vminq / vmaxq 对 NaN 的处理与 GLSL 的定义不同，改用比较加选择
+                static Reg min(Reg a, Reg b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+                static Reg max(Reg a, Reg b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+                static Reg neg(Reg a) { return vnegq_f32(a); }
+                static Reg abs(Reg a) { return vabsq_f32(a); }
+                static Reg sqrt(Reg a) { return vsqrtq_f32(a); }
+                static Reg floor(Reg a) { return vrndmq_f32(a); }
+                static Reg ceil(Reg a) { return vrndpq_f32(a); }
+                static Reg trunc(Reg a) { return vrndq_f32(a); }
+                static Reg roundEven(Reg a) { return vrndnq_f32(a); }
+                static Mask lt(Reg a, Reg b) { return vcltq_f32(a, b); }
+                static Mask le(Reg a, Reg b) { return vcleq_f32(a, b); }
+                static Mask eq(Reg a, Reg b) { return vceqq_f32(a, b); }
+                static Mask ne(Reg a, Reg b) { return vmvnq_u32(vceqq_f32(a, b)); }
+                static Reg select(Mask m, Reg t, Reg f) { return vbslq_f32(m, t, f); }
+                static Mask maskAnd(Mask a, Mask b) { return vandq_u32(a, b); }
+                static Mask maskOr(Mask a, Mask b) { return vorrq_u32(a, b); }
+                static Mask maskXor(Mask a, Mask b) { return veorq_u32(a, b); }
+                static Mask maskNot(Mask a) { return vmvnq_u32(a); }
+                static Mask maskAll(bool b) { return vdupq_n_u32(b ? 0xFFFFFFFFu : 0u); }
+                static uint32_t bits(Mask m)
+                {
+                    const uint32_t weights[4] = {1, 2, 4, 8};
+                    return vaddvq_u32(vandq_u32(m, vld1q_u32(weights)));
+                }
+            };
+#endif
+
+#if defined(GLMCS_HAS_AVX)
+            template <>
+            struct Ops<float, 8>
+            {
+                typedef __m256 Reg;
+                typedef __m256 Mask;
+                static constexpr size_t width = 8;
+
+                static Reg load(const float *p) { return _mm256_loadu_ps(p); }
+                static void store(float *p, Reg a) { _mm256_storeu_ps(p, a); }
+                static Reg broadcast(float s) { return _mm256_set1_ps(s); }
+                static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+                static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+                static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+                static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+                static Reg madd(Reg a, Reg b, Reg c) { return simd::madd(a, b, c); }
+                static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+                static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+                static Reg neg(Reg a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+                static Reg abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static Reg sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+                static Reg floor(Reg a) { return _mm256_floor_ps(a); }
+                static Reg ceil(Reg a) { return _mm256_ceil_ps(a); }
+                static Reg trunc(Reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+                static Reg roundEven(Reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+                static Mask lt(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+                static Mask le(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+                static Mask eq(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+                static Mask ne(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+                static Reg select(Mask m, Reg t, Reg f) { return _mm256_blendv_ps(f, t, m); }
+                static Mask maskAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+                static Mask maskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+                static Mask maskXor(Mask a, Mask b) { return _mm256_xor_ps(a, b); }
+                static Mask maskNot(Mask a) { return _mm256_xor_ps(a, maskAll(true)); }
+                static Mask maskAll(bool b) { return _mm256_castsi256_ps(_mm256_set1_epi32(b ? -1 : 0)); }
+                static uint32_t bits(Mask m) { return uint32_t(_mm256_movemask_ps(m)); }
+            };
+#endif
+        } // namespace lane
+
+        // W 个调用的 bool（GLSL 的 bvec），由 Lane 的比较运算得到
+        template <typename T, size_t W>
+        struct LaneMask
+        {
+            typedef lane::Ops<T, lane::RegisterWidth<T, W>::value> ops;
+            static constexpr size_t width = W;
+            static constexpr size_t registers = W / ops::width;
+
+            typename ops::Mask m[registers];
+
+            LaneMask() : LaneMask(false) {}
+            LaneMask(bool b)
+            {
+                for (size_t k = 0; k < registers; k++)
+                {
+                    m[k] = ops::maskAll(b);
+                }
+            }
+
+            // 第 i 位为第 i 个调用的值
+            uint64_t bits() const
+            {
+                uint64_t r = 0;
+                for (size_t k = 0; k < registers; k++)
+                {
+                    r |= uint64_t(ops::bits(m[k])) << (k * ops::width);
+                }
+                return r;
+            }
+            bool operator[](size_t i) const { return ((bits() >> i) & 1u) != 0; }
+        };
+
+        /// @brief W 个调用的同一个标量变量（SPMD 的一个“寄存器”），T 为 float 或 double，W 不超过 64。
+        /// 默认构造为 0，可由标量隐式构造（广播）。
+        template <typename T, size_t W>
+        struct Lane
+        {
+            static_assert(std::is_floating_point<T>::value, "glmCS::glsl::Lane needs float or double");
+            static_assert(W >= 1 && W <= 64, "glmCS::glsl::Lane supports 1 to 64 invocations");
+            typedef lane::Ops<T, lane::RegisterWidth<T, W>::value> ops;
+            typedef typename ops::Reg Reg;
+            typedef T value_type;
+            typedef LaneMask<T, W> Mask;
+            static constexpr size_t width = W;
+            static constexpr size_t registers = W / ops::width;
+
+            Reg r[registers];
+
+            Lane() : Lane(T(0)) {}
+            Lane(T s)
+            {
+                for (size_t k = 0; k < registers; k++)
+                {
+                    r[k] = ops::broadcast(s);
+                }
+            }
+
+            // 读取 / 写入 W 个连续元素（无对齐要求）
+            static Lane load(const T *p)
+            {
+                Lane a;
+                for (size_t k = 0; k < registers; k++)
+                {
+                    a.r[k] = ops::load(p + k * ops::width);
+                }
+                return a;
+            }
+            void store(T *p) const
+            {
+                for (size_t k = 0; k < registers; k++)
+                {
+                    ops::store(p + k * ops::width, r[k]);
+                }
+            }
+
+            // start, start + step, start + 2 * step ...，例如一行 W 个像素的坐标
+            static Lane ramp(T start, T step)
+            {
+                T v[W];
+                for (size_t i = 0; i < W; i++)
+                {
+                    v[i] = start + T(i) * step;
+                }
+                return load(v);
+            }
+
+            T operator[](size_t i) const
+            {
+                T v[W];
+                store(v);
+                return v[i];
+            }
+        };
+
+        typedef Lane<float, 4> Lane4;
+        typedef Lane<float, 8> Lane8;
+        typedef Lane<float, 16> Lane16;
+        typedef Lane<double, 4> DLane4;
+
+        namespace lane
+        {
+            // 逐寄存器调用 f
+            template <typename T, size_t W, typename F>
+            inline Lane<T, W> apply(F f, const Lane<T, W> &a)
+            {
+                Lane<T, W> out;
+                for (size_t k = 0; k < Lane<T, W>::registers; k++)
+                {
+                    out.r[k] = f(a.r[k]);
+                }
+                return out;
+            }
+            template <typename T, size_t W, typename F>
+            inline Lane<T, W> apply(F f, const Lane<T, W> &a, const Lane<T, W> &b)
+            {
+                Lane<T, W> out;
+                for (size_t k = 0; k < Lane<T, W>::registers; k++)
+                {
+                    out.r[k] = f(a.r[k], b.r[k]);
+                }
+                return out;
+            }
+            template <typename T, size_t W, typename F>
+            inline LaneMask<T, W> compare(F f, const Lane<T, W> &a, const Lane<T, W> &b)
+            {
+                LaneMask<T, W> out;
+                for (size_t k = 0; k < Lane<T, W>::registers; k++)
+                {
+                    out.m[k] = f(a.r[k], b.r[k]);
+                }
+                return out;
+            }
+            template <typename T, size_t W, typename F>
+            inline LaneMask<T, W> combine(F f, const LaneMask<T, W> &a, const LaneMask<T, W> &b)
+            {
+                LaneMask<T, W> out;
+                for (size_t k = 0; k < LaneMask<T, W>::registers; k++)
+                {
+                    out.m[k] = f(a.m[k], b.m[k]);
+                }
+                return out;
+            }
+
+            // 没有向量实现的函数逐元素调用 C 库
+            template <typename T, size_t W, typename F>
+            inline Lane<T, W> perElement(F f, const Lane<T, W> &a)
+            {
+                T v[W];
+                a.store(v);
+                for (size_t i = 0; i < W; i++)
+                {
+                    v[i] = T(f(v[i]));
+                }
+                return Lane<T, W>::load(v);
+            }
+            template <typename T, size_t W, typename F>
+            inline Lane<T, W> perElement(F f, const Lane<T, W> &a, const Lane<T, W> &b)
+            {
+                T va[W], vb[W];
+                a.store(va);
+                b.store(vb);
+                for (size_t i = 0; i < W; i++)
+                {
+                    va[i] = T(f(va[i], vb[i]));
+                }
+                return Lane<T, W>::load(va);
+            }
+        } // namespace lane
+
+        // -------------------------------------------------------------------
+        // Lane 运算符：Lane 与 Lane、Lane 与标量（标量参数不参与推导，因此 x * 2、0.5f - x 均可）
+#define GLMCS_LANE_ARITHMETIC(OP, FN)                                                                               \
+    template <typename T, size_t W>                                                                                 \
+    inline Lane<T, W> operator OP(const Lane<T, W> &a, const Lane<T, W> &b)                                         \
+    {                                                                                                               \
+        return lane::apply([](typename Lane<T, W>::Reg x, typename Lane<T, W>::Reg y)                               \
+                           { return Lane<T, W>::ops::FN(x, y); },                                                   \
+                           a, b);                                                                                   \
+    }                                                                                                               \
+    template <typename T, size_t W>                                                                                 \
+    inline Lane<T, W> operator OP(const Lane<T, W> &a, typename Lane<T, W>::value_type s) { return a OP Lane<T, W>(s); } \
+    template <typename T, size_t W>                                                                                 \
+    inline Lane<T, W> operator OP(typename Lane<T, W>::value_type s, const Lane<T, W> &a) { return Lane<T, W>(s) OP a; } \
+    template <typename T, size_t W>                                                                                 \
+    inline Lane<T, W> &operator OP##=(Lane<T, W> &a, const Lane<T, W> &b) { return a = a OP b; }                     \
+    template <typename T, size_t W>                                                                                 \
+    inline Lane<T, W> &operator OP##=(Lane<T, W> &a, typename Lane<T, W>::value_type s) { return a = a OP Lane<T, W>(s); }
+
+        GLMCS_LANE_ARITHMETIC(+, add)
+        GLMCS_LANE_ARITHMETIC(-, sub)
+        GLMCS_LANE_ARITHMETIC(*, mul)
+        GLMCS_LANE_ARITHMETIC(/, div)
+#undef GLMCS_LANE_ARITHMETIC
+
+        template <typename T, size_t W>
+        inline Lane<T, W> operator-(const Lane<T, W> &a)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg x)
+                               { return Lane<T, W>::ops::neg(x); },
+                               a);
+        }
+
+        // a > b 写作 b < a，a != b 对 NaN 为 true（与 GLSL 的 notEqual 一致）
+#define GLMCS_LANE_COMPARE(OP, FN, A, B)                                                                            \
+    template <typename T, size_t W>                                                                                 \
+    inline LaneMask<T, W> operator OP(const Lane<T, W> &a, const Lane<T, W> &b)                                     \
+    {                                                                                                               \
+        return lane::compare([](typename Lane<T, W>::Reg x, typename Lane<T, W>::Reg y)                             \
+                             { return Lane<T, W>::ops::FN(x, y); },                                                 \
+                             A, B);                                                                                 \
+    }                                                                                                               \
+    template <typename T, size_t W>                                                                                 \
+    inline LaneMask<T, W> operator OP(const Lane<T, W> &a, typename Lane<T, W>::value_type s) { return a OP Lane<T, W>(s); } \
+    template <typename T, size_t W>                                                                                 \
+    inline LaneMask<T, W> operator OP(typename Lane<T, W>::value_type s, const Lane<T, W> &a) { return Lane<T, W>(s) OP a; }
+
+        GLMCS_LANE_COMPARE(<, lt, a, b)
+        GLMCS_LANE_COMPARE(<=, le, a, b)
+        GLMCS_LANE_COMPARE(>, lt, b, a)
+        GLMCS_LANE_COMPARE(>=, le, b, a)
+        GLMCS_LANE_COMPARE(==, eq, a, b)
+        GLMCS_LANE_COMPARE(!=, ne, a, b)
+#undef GLMCS_LANE_COMPARE
+
+        template <typename T, size_t W>
+        inline LaneMask<T, W> operator&(const LaneMask<T, W> &a, const LaneMask<T, W> &b)
+        {
+            return lane::combine([](typename LaneMask<T, W>::ops::Mask x, typename LaneMask<T, W>::ops::Mask y)
+                                 { return LaneMask<T, W>::ops::maskAnd(x, y); },
+                                 a, b);
+        }
+        template <typename T, size_t W>
+        inline LaneMask<T, W> operator|(const LaneMask<T, W> &a, const LaneMask<T, W> &b)
+        {
+            return lane::combine([](typename LaneMask<T, W>::ops::Mask x, typename LaneMask<T, W>::ops::Mask y)
+                                 { return LaneMask<T, W>::ops::maskOr(x, y); },
+                                 a, b);
+        }
+        template <typename T, size_t W>
+        inline LaneMask<T, W> operator^(const LaneMask<T, W> &a, const LaneMask<T, W> &b)
+        {
+            return lane::combine([](typename LaneMask<T, W>::ops::Mask x, typename LaneMask<T, W>::ops::Mask y)
+                                 { return LaneMask<T, W>::ops::maskXor(x, y); },
+                                 a, b);
+        }
+        template <typename T, size_t W>
+        inline LaneMask<T, W> operator!(const LaneMask<T, W> &a)
+        {
+            LaneMask<T, W> out;
+            for (size_t k = 0; k < LaneMask<T, W>::registers; k++)
+            {
+                out.m[k] = LaneMask<T, W>::ops::maskNot(a.m[k]);
+            }
+            return out;
+        }
+
+        // GLSL 的 any / all：整组调用都不进入分支时可以跳过分支
+        template <typename T, size_t W>
+        inline bool any(const LaneMask<T, W> &a) { return a.bits() != 0; }
+        template <typename T, size_t W>
+        inline bool all(const LaneMask<T, W> &a) { return a.bits() == (~uint64_t(0) >> (64 - W)); }
+        inline bool any(bool a) { return a; }
+        inline bool all(bool a) { return a; }
+
+        /// @brief 按掩码选择：m 为 true 的调用取 t，否则取 f（分支的 SPMD 写法）
+        template <typename T, size_t W>
+        inline Lane<T, W> select(const LaneMask<T, W> &m, const Lane<T, W> &t, const Lane<T, W> &f)
+        {
+            Lane<T, W> out;
+            for (size_t k = 0; k < Lane<T, W>::registers; k++)
+            {
+                out.r[k] = Lane<T, W>::ops::select(m.m[k], t.r[k], f.r[k]);
+            }
+            return out;
+        }
+        template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+        inline T select(bool m, T t, T f) { return m ? t : f; }
+        // 向量的所有分量共用同一个条件
+        template <typename M, typename T, size_t N>
+        inline Vector<T, N> select(const M &m, const Vector<T, N> &t, const Vector<T, N> &f)
+        {
+            Vector<T, N> r;
+            for (size_t i = 0; i < N; i++)
+            {
+                r.v[i] = select(m, t.v[i], f.v[i]);
+            }
+            return r;
+        }
+
+        namespace lane
+        {
+            /// @brief 对 Vector 逐分量调用 f（f 为泛型 lambda，参数依次取各个向量的同一分量）。
+            /// float vec3 / vec4 的四个分量作为一个 Lane<float, 4> 计算，vec3 的填充分量重新置 0。
+            template <typename T, size_t N, typename F, typename... V>
+            inline Vector<T, N> mapComponents(F f, const Vector<T, N> &a, const V &...rest)
+            {
+                Vector<T, N> r;
+#if defined(GLMCS_VECTOR_SIMD)
+                if constexpr (VectorStorage<T, N>::simd)
+                {
+                    Lane<float, 4> x = f(Lane<float, 4>::load(a.v), Lane<float, 4>::load(rest.v)...);
+                    storeVector(r, maskPadding(x.r[0], N));
+                    return r;
+                }
+#endif
+                for (size_t i = 0; i < N; i++)
+                {
+                    r.v[i] = f(a.v[i], rest.v[i]...);
+                }
+                return r;
+            }
+        } // namespace lane
+
+        // -------------------------------------------------------------------
+        // 以下每个函数依次提供标量、Lane、Vector 三种重载。标量版本显式调用 C 库（::floor 等），
+        // 因为在本命名空间内直接写 floor 会找到这里的同名函数。
+
+        // GLSL 通用函数的标量重载只接受算术类型，避免与 Lane / Vector 重载产生歧义
+#define GLMCS_GLSL_SCALAR template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+
+        // ---------------------------------------------------------------- 角度与三角函数
+        GLMCS_GLSL_SCALAR inline T radians(T degrees) { return degrees * T(M_PI / 180.0); }
+        GLMCS_GLSL_SCALAR inline T degrees(T radians) { return radians * T(180.0 / M_PI); }
+        GLMCS_GLSL_SCALAR inline T sin(T x) { return ::sin(x); }
+        GLMCS_GLSL_SCALAR inline T cos(T x) { return ::cos(x); }
+
+        template <typename T, size_t W>
+        inline Lane<T, W> radians(const Lane<T, W> &degrees) { return degrees * T(M_PI / 180.0); }
+        template <typename T, size_t W>
+        inline Lane<T, W> degrees(const Lane<T, W> &radians) { return radians * T(180.0 / M_PI); }
+
+        // ---------------------------------------------------------------- 通用函数（Lane）
+        template <typename T, size_t W>
+        inline Lane<T, W> abs(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::abs(a); },
+                               x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> floor(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::floor(a); },
+                               x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> ceil(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::ceil(a); },
+                               x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> trunc(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::trunc(a); },
+                               x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> roundEven(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::roundEven(a); },
+                               x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> sqrt(const Lane<T, W> &x)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a)
+                               { return Lane<T, W>::ops::sqrt(a); },
+                               x);
+        }
+        // GLSL 允许 2 ULP；rsqrt 估计值加一次牛顿迭代达不到，因此使用正确舍入的 sqrt 与除法
+        template <typename T, size_t W>
+        inline Lane<T, W> inversesqrt(const Lane<T, W> &x) { return T(1) / sqrt(x); }
+        // min(x, y) = y < x ? y : x，max(x, y) = x < y ? y : x
+        template <typename T, size_t W>
+        inline Lane<T, W> min(const Lane<T, W> &x, const Lane<T, W> &y)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a, typename Lane<T, W>::Reg b)
+                               { return Lane<T, W>::ops::min(a, b); },
+                               y, x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> max(const Lane<T, W> &x, const Lane<T, W> &y)
+        {
+            return lane::apply([](typename Lane<T, W>::Reg a, typename Lane<T, W>::Reg b)
+                               { return Lane<T, W>::ops::max(a, b); },
+                               y, x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> min(const Lane<T, W> &x, typename Lane<T, W>::value_type y) { return min(x, Lane<T, W>(y)); }
+        template <typename T, size_t W>
+        inline Lane<T, W> max(const Lane<T, W> &x, typename Lane<T, W>::value_type y) { return max(x, Lane<T, W>(y)); }
+        template <typename T, size_t W>
+        inline Lane<T, W> fma(const Lane<T, W> &a, const Lane<T, W> &b, const Lane<T, W> &c)
+        {
+            Lane<T, W> out;
+            for (size_t k = 0; k < Lane<T, W>::registers; k++)
+            {
+                out.r[k] = Lane<T, W>::ops::madd(a.r[k], b.r[k], c.r[k]);
+            }
+            return out;
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> sign(const Lane<T, W> &x)
+        {
+            return select(x > T(0), Lane<T, W>(T(1)), select(x < T(0), Lane<T, W>(T(-1)), Lane<T, W>(T(0))));
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> fract(const Lane<T, W> &x) { return x - floor(x); }
+        template <typename T, size_t W>
+        inline Lane<T, W> mod(const Lane<T, W> &x, const Lane<T, W> &y) { return x - y * floor(x / y); }
+        template <typename T, size_t W>
+        inline Lane<T, W> mod(const Lane<T, W> &x, typename Lane<T, W>::value_type y) { return mod(x, Lane<T, W>(y)); }
+        template <typename T, size_t W>
+        inline Lane<T, W> clamp(const Lane<T, W> &x, const Lane<T, W> &minVal, const Lane<T, W> &maxVal) { return min(max(x, minVal), maxVal); }
+        template <typename T, size_t W>
+        inline Lane<T, W> clamp(const Lane<T, W> &x, typename Lane<T, W>::value_type minVal, typename Lane<T, W>::value_type maxVal)
+        {
+            return min(max(x, Lane<T, W>(minVal)), Lane<T, W>(maxVal));
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> mix(const Lane<T, W> &x, const Lane<T, W> &y, const Lane<T, W> &a) { return x * (T(1) - a) + y * a; }
+        template <typename T, size_t W>
+        inline Lane<T, W> mix(const Lane<T, W> &x, const Lane<T, W> &y, typename Lane<T, W>::value_type a) { return x * (T(1) - a) + y * a; }
+        template <typename T, size_t W>
+        inline Lane<T, W> mix(const Lane<T, W> &x, const Lane<T, W> &y, const LaneMask<T, W> &a) { return select(a, y, x); }
+        template <typename T, size_t W>
+        inline Lane<T, W> step(const Lane<T, W> &edge, const Lane<T, W> &x) { return select(x < edge, Lane<T, W>(T(0)), Lane<T, W>(T(1))); }
+        template <typename T, size_t W>
+        inline Lane<T, W> step(typename Lane<T, W>::value_type edge, const Lane<T, W> &x) { return step(Lane<T, W>(edge), x); }
+        // edge0 >= edge1 时结果未定义（与 GLSL 相同）
+        template <typename T, size_t W>
+        inline Lane<T, W> smoothstep(const Lane<T, W> &edge0, const Lane<T, W> &edge1, const Lane<T, W> &x)
+        {
+            Lane<T, W> t = clamp((x - edge0) / (edge1 - edge0), T(0), T(1));
+            return t * t * (T(3) - T(2) * t);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> smoothstep(typename Lane<T, W>::value_type edge0, typename Lane<T, W>::value_type edge1, const Lane<T, W> &x)
+        {
+            return smoothstep(Lane<T, W>(edge0), Lane<T, W>(edge1), x);
+        }
+
+        // ---------------------------------------------------------------- 指数、三角函数（Lane）
+        namespace lane
+        {
+            /// @brief float 调用 FastMath 的多项式（见 csfast_math.hpp 的误差表），double 逐元素调用 C 库
+            template <typename T, size_t W>
+            inline void sincos(const Lane<T, W> &x, Lane<T, W> *s, Lane<T, W> *c)
+            {
+                if constexpr (std::is_same<T, float>::value)
+                {
+                    typedef Lane<float, W> L;
+                    // 约化到 [-pi/4, pi/4]，j 为象限
+                    L j = roundEven(x * fastmath::twoOverPi);
+                    L r = ((x - j * fastmath::pio2P1) - j * fastmath::pio2P2) - j * fastmath::pio2P3;
+                    L z = r * r;
+                    L sr = r + r * z * (fastmath::sinC1 + z * (fastmath::sinC2 + z * fastmath::sinC3));
+                    L cr = 1.0f - 0.5f * z + z * z * (fastmath::cosC1 + z * (fastmath::cosC2 + z * fastmath::cosC3));
+                    // q = j mod 4：奇数象限交换 sin / cos，再按象限决定符号
+                    L q = j - 4.0f * floor(j * 0.25f);
+                    LaneMask<float, W> odd = (q == 1.0f) | (q == 3.0f);
+                    L sv = select(odd, cr, sr), cv = select(odd, sr, cr);
+                    *s = select(q >= 2.0f, -sv, sv);
+                    *c = select((q == 1.0f) | (q == 2.0f), -cv, cv);
+                }
+                else
+                {
+                    *s = perElement([](T a)
+                                    { return ::sin(a); },
+                                    x);
+                    *c = perElement([](T a)
+                                    { return ::cos(a); },
+                                    x);
+                }
+            }
+        } // namespace lane
+
+        template <typename T, size_t W>
+        inline Lane<T, W> sin(const Lane<T, W> &x)
+        {
+            Lane<T, W> s, c;
+            lane::sincos(x, &s, &c);
+            return s;
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> cos(const Lane<T, W> &x)
+        {
+            Lane<T, W> s, c;
+            lane::sincos(x, &s, &c);
+            return c;
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> exp(const Lane<T, W> &x)
+        {
+            return lane::perElement([](T a)
+                                    { return ::exp(a); },
+                                    x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> exp2(const Lane<T, W> &x)
+        {
+            return lane::perElement([](T a)
+                                    { return ::exp2(a); },
+                                    x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> log(const Lane<T, W> &x)
+        {
+            return lane::perElement([](T a)
+                                    { return ::log(a); },
+                                    x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> log2(const Lane<T, W> &x)
+        {
+            return lane::perElement([](T a)
+                                    { return ::log2(a); },
+                                    x);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> pow(const Lane<T, W> &x, const Lane<T, W> &y)
+        {
+            return lane::perElement([](T a, T b)
+                                    { return ::pow(a, b); },
+                                    x, y);
+        }
+        template <typename T, size_t W>
+        inline Lane<T, W> pow(const Lane<T, W> &x, typename Lane<T, W>::value_type y) { return pow(x, Lane<T, W>(y)); }
+
+        // ---------------------------------------------------------------- 通用函数（标量）
+        GLMCS_GLSL_SCALAR inline T abs(T x) { return x < T(0) ? -x : x; }
+        GLMCS_GLSL_SCALAR inline T sign(T x) { return x > T(0) ? T(1) : (x < T(0) ? T(-1) : T(0)); }
+        GLMCS_GLSL_SCALAR inline T floor(T x) { return T(::floor(x)); }
+        GLMCS_GLSL_SCALAR inline T ceil(T x) { return T(::ceil(x)); }
+        GLMCS_GLSL_SCALAR inline T trunc(T x) { return T(::trunc(x)); }
+        GLMCS_GLSL_SCALAR inline T roundEven(T x) { return T(::nearbyint(x)); }
+        GLMCS_GLSL_SCALAR inline T sqrt(T x) { return T(::sqrt(x)); }
+        GLMCS_GLSL_SCALAR inline T inversesqrt(T x) { return T(1) / T(::sqrt(x)); }
+        GLMCS_GLSL_SCALAR inline T min(T x, T y) { return y < x ? y : x; }
+        GLMCS_GLSL_SCALAR inline T max(T x, T y) { return x < y ? y : x; }
+        GLMCS_GLSL_SCALAR inline T fma(T a, T b, T c) { return T(::fma(a, b, c)); }
+        GLMCS_GLSL_SCALAR inline T fract(T x) { return x - floor(x); }
+        GLMCS_GLSL_SCALAR inline T mod(T x, T y) { return x - y * floor(x / y); }
+        GLMCS_GLSL_SCALAR inline T clamp(T x, T minVal, T maxVal) { return min(max(x, minVal), maxVal); }
+        GLMCS_GLSL_SCALAR inline T mix(T x, T y, T a) { return x * (T(1) - a) + y * a; }
+        GLMCS_GLSL_SCALAR inline T mix(T x, T y, bool a) { return a ? y : x; }
+        GLMCS_GLSL_SCALAR inline T step(T edge, T x) { return x < edge ? T(0) : T(1); }
+        GLMCS_GLSL_SCALAR inline T smoothstep(T edge0, T edge1, T x)
+        {
+            T t = clamp((x - edge0) / (edge1 - edge0), T(0), T(1));
+            return t * t * (T(3) - T(2) * t);
+        }
+        GLMCS_GLSL_SCALAR inline T exp(T x) { return T(::exp(x)); }
+        GLMCS_GLSL_SCALAR inline T exp2(T x) { return T(::exp2(x)); }
+        GLMCS_GLSL_SCALAR inline T log(T x) { return T(::log(x)); }
+        GLMCS_GLSL_SCALAR inline T log2(T x) { return T(::log2(x)); }
+        GLMCS_GLSL_SCALAR inline T pow(T x, T y) { return T(::pow(x, y)); }
+
+        // ---------------------------------------------------------------- 通用函数（Vector，逐分量）
+#define GLMCS_GLSL_VECTOR1(FN)                                                      \
+    template <typename T, size_t N>                                                 \
+    inline Vector<T, N> FN(const Vector<T, N> &x)                                   \
+    {                                                                               \
+        return lane::mapComponents([](const auto &a) { return FN(a); }, x);         \
+    }
+#define GLMCS_GLSL_VECTOR2(FN)                                                              \
+    template <typename T, size_t N>                                                         \
+    inline Vector<T, N> FN(const Vector<T, N> &x, const Vector<T, N> &y)                    \
+    {                                                                                       \
+        return lane::mapComponents([](const auto &a, const auto &b) { return FN(a, b); }, x, y); \
+    }
+
+        GLMCS_GLSL_VECTOR1(radians)
+        GLMCS_GLSL_VECTOR1(degrees)
+        GLMCS_GLSL_VECTOR1(sin)
+        GLMCS_GLSL_VECTOR1(cos)
+        GLMCS_GLSL_VECTOR1(exp)
+        GLMCS_GLSL_VECTOR1(exp2)
+        GLMCS_GLSL_VECTOR1(log)
+        GLMCS_GLSL_VECTOR1(log2)
+        GLMCS_GLSL_VECTOR1(abs)
+        GLMCS_GLSL_VECTOR1(sign)
+        GLMCS_GLSL_VECTOR1(floor)
+        GLMCS_GLSL_VECTOR1(ceil)
+        GLMCS_GLSL_VECTOR1(trunc)
+        GLMCS_GLSL_VECTOR1(roundEven)
+        GLMCS_GLSL_VECTOR1(fract)
+        GLMCS_GLSL_VECTOR1(sqrt)
+        GLMCS_GLSL_VECTOR1(inversesqrt)
+        GLMCS_GLSL_VECTOR2(pow)
+        GLMCS_GLSL_VECTOR2(min)
+        GLMCS_GLSL_VECTOR2(max)
+        GLMCS_GLSL_VECTOR2(mod)
+        GLMCS_GLSL_VECTOR2(step)
+#undef GLMCS_GLSL_VECTOR2
+#undef GLMCS_GLSL_VECTOR1
+
+        // GLSL 中第二个参数为 float 的形式：min(vec, float)、mod(vec, float)、step(float, vec) ...
+        // 标量参数的类型为分量类型（Lane 向量时可直接传 float）
+        template <typename T, size_t N>
+        inline Vector<T, N> min(const Vector<T, N> &x, typename Vector<T, N>::value_type y) { return min(x, Vector<T, N>(y)); }
+        template <typename T, size_t N>
+        inline Vector<T, N> max(const Vector<T, N> &x, typename Vector<T, N>::value_type y) { return max(x, Vector<T, N>(y)); }
+        template <typename T, size_t N>
+        inline Vector<T, N> mod(const Vector<T, N> &x, typename Vector<T, N>::value_type y) { return mod(x, Vector<T, N>(y)); }
+        template <typename T, size_t N>
+        inline Vector<T, N> step(typename Vector<T, N>::value_type edge, const Vector<T, N> &x) { return step(Vector<T, N>(edge), x); }
+        template <typename T, size_t N>
+        inline Vector<T, N> fma(const Vector<T, N> &a, const Vector<T, N> &b, const Vector<T, N> &c)
+        {
+            return lane::mapComponents([](const auto &x, const auto &y, const auto &z)
+                                       { return fma(x, y, z); },
+                                       a, b, c);
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> clamp(const Vector<T, N> &x, const Vector<T, N> &minVal, const Vector<T, N> &maxVal)
+        {
+            return lane::mapComponents([](const auto &a, const auto &lo, const auto &hi)
+                                       { return clamp(a, lo, hi); },
+                                       x, minVal, maxVal);
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> clamp(const Vector<T, N> &x, typename Vector<T, N>::value_type minVal, typename Vector<T, N>::value_type maxVal)
+        {
+            return clamp(x, Vector<T, N>(minVal), Vector<T, N>(maxVal));
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> mix(const Vector<T, N> &x, const Vector<T, N> &y, const Vector<T, N> &a)
+        {
+            return lane::mapComponents([](const auto &p, const auto &q, const auto &t)
+                                       { return mix(p, q, t); },
+                                       x, y, a);
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> mix(const Vector<T, N> &x, const Vector<T, N> &y, typename Vector<T, N>::value_type a)
+        {
+            return mix(x, y, Vector<T, N>(a));
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> smoothstep(const Vector<T, N> &edge0, const Vector<T, N> &edge1, const Vector<T, N> &x)
+        {
+            return lane::mapComponents([](const auto &e0, const auto &e1, const auto &a)
+                                       { return smoothstep(e0, e1, a); },
+                                       edge0, edge1, x);
+        }
+        template <typename T, size_t N>
+        inline Vector<T, N> smoothstep(typename Vector<T, N>::value_type edge0, typename Vector<T, N>::value_type edge1, const Vector<T, N> &x)
+        {
+            return smoothstep(Vector<T, N>(edge0), Vector<T, N>(edge1), x);
+        }
+
+        // ---------------------------------------------------------------- 几何函数
+        // dot / cross / length 的 Vector 版本见 csvector_utils.hpp，同样适用于 Vector<Lane, N>
+        GLMCS_GLSL_SCALAR inline T dot(T x, T y) { return x * y; }
+        GLMCS_GLSL_SCALAR inline T length(T x) { return abs(x); }
+        GLMCS_GLSL_SCALAR inline T distance(T p0, T p1) { return abs(p0 - p1); }
+        GLMCS_GLSL_SCALAR inline T normalize(T x) { return x / abs(x); }
+        template <typename T, size_t W>
+        inline Lane<T, W> dot(const Lane<T, W> &x, const Lane<T, W> &y) { return x * y; }
+        template <typename T, size_t W>
+        inline Lane<T, W> length(const Lane<T, W> &x) { return abs(x); }
+        template <typename T, size_t W>
+        inline Lane<T, W> distance(const Lane<T, W> &p0, const Lane<T, W> &p1) { return abs(p0 - p1); }
+
+        template <typename T, size_t N>
+        inline T distance(const Vector<T, N> &p0, const Vector<T, N> &p1) { return length(p0 - p1); }
+
+        /// @brief W 个调用的单位向量：x * inversesqrt(dot(x, x))。零向量返回零向量（与 glmCS::normalize 一致）
+        template <typename T, size_t W, size_t N>
+        inline Vector<Lane<T, W>, N> normalize(const Vector<Lane<T, W>, N> &x)
+        {
+            Lane<T, W> d = dot(x, x);
+            return x * select(d > T(0), inversesqrt(d), Lane<T, W>(T(0)));
+        }
+
+        // dot(Nref, I) < 0 ? N : -N
+        template <typename T, size_t N>
+        inline Vector<T, N> faceforward(const Vector<T, N> &n, const Vector<T, N> &i, const Vector<T, N> &nref)
+        {
+            return select(dot(nref, i) < T(0), n, -n);
+        }
+
+        // I - 2 * dot(N, I) * N，N 须为单位向量
+        template <typename T, size_t N>
+        inline Vector<T, N> reflect(const Vector<T, N> &i, const Vector<T, N> &n)
+        {
+            return i - n * (T(2) * dot(n, i));
+        }
+
+        /// @brief 折射方向，I、N 须为单位向量，eta 为折射率之比；全反射（k < 0）时返回零向量
+        template <typename T, size_t N>
+        inline Vector<T, N> refract(const Vector<T, N> &i, const Vector<T, N> &n, typename Vector<T, N>::value_type eta)
+        {
+            T d = dot(n, i);
+            T k = T(1) - eta * eta * (T(1) - d * d);
+            Vector<T, N> r = i * eta - n * (eta * d + sqrt(max(k, T(0))));
+            return select(k < T(0), Vector<T, N>(), r);
+        }
+
+#undef GLMCS_GLSL_SCALAR
+    } // namespace glsl
+} // namespace glmCS
+
+#endif // __CSGLSL_BUILTINS_H__
@@ -0,0 +1,75 @@
+/// @ref core
+/// @file csmatrix_palette.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Bulk matrix-palette builder for skinning and instancing.
+/// Computes palette[i] = matrixMultiply(inverseBind[i], bonePose[i]) for whole arrays with the SSE / AVX
+/// matrixMultiply, writing straight into the caller's upload buffer (column-major, 16 floats per matrix, ready
+/// for a UBO/SSBO/texture buffer). Large palettes can be split across threads.
+///
+/// std::vector<float> palette(boneCount * 16);
+/// glmCS::buildMatrixPalette(inverseBind.data(), bonePose.data(), boneCount, palette.data(), 4);
+///
+
+#ifndef __CSMATRIX_PALETTE_H__
+#define __CSMATRIX_PALETTE_H__
+
+#include <stddef.h>
+#include <string.h>
+#include "csmatrix_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    /// @brief 逐元素相乘 [begin, end) 范围内的两个矩阵数组
+    /// @param a 左矩阵数组（例如逆绑定矩阵）
+    /// @param b 右矩阵数组（例如骨骼姿态矩阵）
+    /// @param out 输出缓冲区，每个矩阵 16 个 float
+    inline void multiplyMatrixArraysRange(const Matrix<float, 4, 4> *a, const Matrix<float, 4, 4> *b, size_t begin, size_t end, float *out)
+    {
+        // 逐个矩阵相乘（与 SSE 版 matrixMultiply 相同），结果列直接写入 out，不经过临时矩阵；
+        // 8 个矩阵一组的 SoA 转置（loadMatrices8 / storeMatrices8）的 shuffle 开销超过了省下的广播，实测更慢
+        for (size_t n = begin; n < end; n++)
+        {
+            float *dst = out + n * 16;
+#if defined(GLMCS_HAS_SSE2)
+            __m128 b0 = _mm_loadu_ps(b[n].mat[0]);
+            __m128 b1 = _mm_loadu_ps(b[n].mat[1]);
+            __m128 b2 = _mm_loadu_ps(b[n].mat[2]);
+            __m128 b3 = _mm_loadu_ps(b[n].mat[3]);
+            for (size_t i = 0; i < 4; i++)
+            {
+                __m128 r = _mm_mul_ps(_mm_set1_ps(a[n].mat[i][0]), b0);
+                r = simd::madd(_mm_set1_ps(a[n].mat[i][1]), b1, r);
+                r = simd::madd(_mm_set1_ps(a[n].mat[i][2]), b2, r);
+                r = simd::madd(_mm_set1_ps(a[n].mat[i][3]), b3, r);
+                _mm_storeu_ps(dst + i * 4, r);
+            }
+#else
+            Matrix<float, 4, 4> m = matrixMultiply(a[n], b[n].mat);
+            memcpy(dst, valuePtr(m), sizeof(m));
+#endif
+        }
+    }
+
+    /// @brief 构建矩阵调色板：palette[i] = inverseBind[i] * bonePose[i]（与 matrixMultiply 的顺序相同）
+    /// @param inverseBind 逆绑定矩阵数组
+    /// @param bonePose 骨骼姿态矩阵数组
+    /// @param count 骨骼个数
+    /// @param upload 输出的上传缓冲区，至少 count * 16 个 float，列主序
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void buildMatrixPalette(const Matrix<float, 4, 4> *inverseBind, const Matrix<float, 4, 4> *bonePose, size_t count, float *upload, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { multiplyMatrixArraysRange(inverseBind, bonePose, begin, end, upload); }, 8);
+    }
+
+    // 输出为矩阵数组的重载
+    inline void buildMatrixPalette(const Matrix<float, 4, 4> *inverseBind, const Matrix<float, 4, 4> *bonePose, size_t count, Matrix<float, 4, 4> *palette, unsigned threads = 1)
+    {
+        buildMatrixPalette(inverseBind, bonePose, count, reinterpret_cast<float *>(palette), threads);
+    }
+} // namespace glmCS
+
+#endif // __CSMATRIX_PALETTE_H__
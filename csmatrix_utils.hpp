@@ -12,12 +12,30 @@
 /// mat4x4 = glmCS::rotate(270, mat4x4, 1, 0, 0);
 /// glmCS::printMatrix<float, 4, 4>(&mat4x4);
 ///
+/// All builders are generic over T; large-world scenes keep double world matrices and convert them to float
+/// camera-relative matrices right before upload:
+///
+/// glmCS::Matrix<double, 4, 4> world = glmCS::translateMatrix<double>(glmCS::initIdentityMatrix<double, 4>(), 1e7, 0, 2e7);
+/// glmCS::Matrix<float, 4, 4> model = glmCS::cameraRelativeMatrix(world, glmCS::dvec3(1e7, 2.0, 2e7));
+///
+/// Storage layout is a compile-time policy. The default ColumnMajor stores mat[i] as the i-th GLSL column (the
+/// translation lives in mat[3]), which is exactly what glUniformMatrix4fv(..., GL_FALSE, ...) expects:
+///
+/// glUniformMatrix4fv(loc, 1, GL_FALSE, glmCS::valuePtr(mat4x4));
+/// glmCS::copyMatricesForUpload(matrices, count, mappedBuffer); // 一次 memcpy
+///
 
 #ifndef __CSMATRIX_UTILS_H__
 #define __CSMATRIX_UTILS_H__
 
 #include <stdio.h>
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+#include "cssimd_utils.hpp"
+#include "csfast_math.hpp"
+#include "cserror_utils.hpp"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -26,27 +44,50 @@
 typedef unsigned char glmcs_uc;
 typedef unsigned short glmcs_us;
 
-enum
-{
-    GLMCS_false = -1,
-    GLMCS_not_rotate = 0,
-    GLMCS_ok = 1
-};
-
 namespace glmCS
 {
-    // 定义一个 MxN 的二维矩阵结构
+    // 存储布局：mat[i] 为 GLSL 的第 i 列（平移位于 mat[3]），与 glUniformMatrix*fv(..., GL_FALSE, ...) 一致。
+    // 所有构造函数（translateMatrix / rotate / lookAt / perspective ...）都按此布局生成矩阵。
+    struct ColumnMajor
+    {
+        static const bool transposeOnUpload = false;
+    };
+    // 存储布局：mat[i] 为数学意义上的第 i 行，上传时需要 GL_TRUE 或先转换为 ColumnMajor
+    struct RowMajor
+    {
+        static const bool transposeOnUpload = true;
+    };
+
+    // 元素总字节数为 16 的倍数时按 16 字节对齐，保证 SIMD 对齐读写且数组元素之间没有填充
     template <typename T, size_t rows, size_t cols>
-    struct Matrix
+    struct MatrixAlignment
+    {
+        static const size_t value = (sizeof(T) * rows * cols) % 16 == 0 ? 16 : alignof(T);
+    };
+
+    // 定义一个 MxN 的二维矩阵结构，Layout 为存储布局策略
+    template <typename T, size_t rows, size_t cols, typename Layout = ColumnMajor>
+    struct alignas(MatrixAlignment<T, rows, cols>::value) Matrix
     {
+        typedef Layout layout;
         T mat[rows][cols];
     };
 
     // 定义一个 vec3 的向量
-    typedef struct Vector3
+    template <typename T>
+    struct Vector3T
     {
-        float x, y, z;
-    } Vector3;
+        T x, y, z;
+    };
+    typedef Vector3T<float> Vector3;
+    typedef Vector3T<double> DVector3;
+
+    // 使参数不参与模板推导（例如 rotate(270, mat4x4, ...) 中的角度由矩阵类型决定）
+    template <typename T>
+    struct NonDeduced
+    {
+        typedef T type;
+    };
 
     // -------------------------------------------------------------------
     // 初始化单位矩阵
@@ -75,13 +116,23 @@ namespace glmCS
         return v;
     }
 
-    // 获取vec3单位向量
-    static int normalize(Vector3 *v)
+    // 初始化双精度vec3向量
+    inline DVector3 dvec3(double x, double y, double z)
     {
-        float length = sqrt(v->x * v->x + v->y * v->y + v->z * v->z);
-        if (0 == length)
+        DVector3 v;
+        v.x = x;
+        v.y = y;
+        v.z = z;
+        return v;
+    }
+
+    // 获取vec3单位向量；长度为 0 时返回 GLMCS_false 并上报 GLMCS_error_zero_length，向量保持不变（GLMCS_NO_CHECKS 下不检查）
+    template <typename T>
+    inline int normalize(Vector3T<T> *v)
+    {
+        T length = sqrt(v->x * v->x + v->y * v->y + v->z * v->z);
+        if (!GLMCS_CHECK(length != T(0), GLMCS_error_zero_length, "normalize"))
         {
-            printf("[%s:%i]lookAt()::normalize() ZeroDivisionError: division by zero!\n", __FILE__, __LINE__);
             return GLMCS_false;
         }
         v->x /= length;
@@ -91,7 +142,8 @@ namespace glmCS
     }
 
     // 获取vec3叉乘向量
-    static void cross(Vector3 *result, const Vector3 *v1, const Vector3 *v2)
+    template <typename T>
+    inline void cross(Vector3T<T> *result, const Vector3T<T> *v1, const Vector3T<T> *v2)
     {
         result->x = v1->y * v2->z - v1->z * v2->y;
         result->y = v1->z * v2->x - v1->x * v2->z;
@@ -99,13 +151,15 @@ namespace glmCS
     }
 
     // 获取vec3向量内积
-    static float dot(const Vector3 *v1, const Vector3 *v2)
+    template <typename T>
+    inline T dot(const Vector3T<T> *v1, const Vector3T<T> *v2)
     {
         return v1->x * v2->x + v1->y * v2->y + v1->z * v2->z;
     }
 
     // 获取vec3相减向量
-    static void subtract(Vector3 *result, const Vector3 *v1, const Vector3 *v2)
+    template <typename T>
+    inline void subtract(Vector3T<T> *result, const Vector3T<T> *v1, const Vector3T<T> *v2)
     {
         result->x = v1->x - v2->x;
         result->y = v1->y - v2->y;
@@ -117,9 +171,10 @@ namespace glmCS
     /// @param target 目标位置的三维向量
     /// @param up 上方向的三维向量
     /// @return 返回一个观察矩阵
-    inline Matrix<float, 4, 4> lookAt(Vector3 eye, Vector3 target, Vector3 up)
+    template <typename T>
+    inline Matrix<T, 4, 4> lookAt(Vector3T<T> eye, Vector3T<T> target, Vector3T<T> up)
     {
-        Vector3 forward, right, upVec;
+        Vector3T<T> forward, right, upVec;
 
         subtract(&forward, &target, &eye);
         normalize(&forward);
@@ -130,27 +185,27 @@ namespace glmCS
         cross(&upVec, &right, &forward);
         normalize(&upVec);
 
-        Matrix<float, 4, 4> Matrix4;
+        Matrix<T, 4, 4> Matrix4;
 
         Matrix4.mat[0][0] = right.x;
         Matrix4.mat[0][1] = upVec.x;
         Matrix4.mat[0][2] = -forward.x;
-        Matrix4.mat[0][3] = 0.0f;
+        Matrix4.mat[0][3] = T(0);
 
         Matrix4.mat[1][0] = right.y;
         Matrix4.mat[1][1] = upVec.y;
         Matrix4.mat[1][2] = -forward.y;
-        Matrix4.mat[1][3] = 0.0f;
+        Matrix4.mat[1][3] = T(0);
 
         Matrix4.mat[2][0] = right.z;
         Matrix4.mat[2][1] = upVec.z;
         Matrix4.mat[2][2] = -forward.z;
-        Matrix4.mat[2][3] = 0.0f;
+        Matrix4.mat[2][3] = T(0);
 
         Matrix4.mat[3][0] = -dot(&right, &eye);
         Matrix4.mat[3][1] = -dot(&upVec, &eye);
         Matrix4.mat[3][2] = dot(&forward, &eye);
-        Matrix4.mat[3][3] = 1.0f;
+        Matrix4.mat[3][3] = T(1);
         return Matrix4;
     }
 
@@ -159,31 +214,35 @@ namespace glmCS
     /// @param aspectRatio 纵横比
     /// @param nearPlane 近平面距离
     /// @param farPlane 远平面距离
-    /// @return 生成的透视投影矩阵
-    inline Matrix<float, 4, 4> perspective(float fov, float aspectRatio, float nearPlane, float farPlane)
+    /// @return 生成的透视投影矩阵（默认float，perspective<double>(...) 生成双精度矩阵）
+    /// MathPolicy 为 PreciseMath（默认）或 FastMath，例如 perspective<float, FastMath>(...)
+    template <typename T = float, typename MathPolicy = PreciseMath>
+    inline Matrix<T, 4, 4> perspective(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                       typename NonDeduced<T>::type nearPlane, typename NonDeduced<T>::type farPlane)
     {
-        Matrix<float, 4, 4> Matrix4;
-        float f = 1.0f / tanf(fov * 0.5f);
+        Matrix<T, 4, 4> Matrix4;
+        T f = T(1) / MathPolicy::tan(fov * T(0.5));
+        T rangeInv = T(1) / (nearPlane - farPlane);
 
         Matrix4.mat[0][0] = f / aspectRatio;
-        Matrix4.mat[0][1] = 0.0f;
-        Matrix4.mat[0][2] = 0.0f;
-        Matrix4.mat[0][3] = 0.0f;
+        Matrix4.mat[0][1] = T(0);
+        Matrix4.mat[0][2] = T(0);
+        Matrix4.mat[0][3] = T(0);
 
-        Matrix4.mat[1][0] = 0.0f;
+        Matrix4.mat[1][0] = T(0);
         Matrix4.mat[1][1] = f;
-        Matrix4.mat[1][2] = 0.0f;
-        Matrix4.mat[1][3] = 0.0f;
-
-        Matrix4.mat[2][0] = 0.0f;
-        Matrix4.mat[2][1] = 0.0f;
-        Matrix4.mat[2][2] = (farPlane + nearPlane) / (nearPlane - farPlane);
-        Matrix4.mat[2][3] = -1.0f;
-
-        Matrix4.mat[3][0] = 0.0f;
-        Matrix4.mat[3][1] = 0.0f;
-        Matrix4.mat[3][2] = (2.0f * farPlane * nearPlane) / (nearPlane - farPlane);
-        Matrix4.mat[3][3] = 0.0f;
+        Matrix4.mat[1][2] = T(0);
+        Matrix4.mat[1][3] = T(0);
+
+        Matrix4.mat[2][0] = T(0);
+        Matrix4.mat[2][1] = T(0);
+        Matrix4.mat[2][2] = (farPlane + nearPlane) * rangeInv;
+        Matrix4.mat[2][3] = T(-1);
+
+        Matrix4.mat[3][0] = T(0);
+        Matrix4.mat[3][1] = T(0);
+        Matrix4.mat[3][2] = T(2) * farPlane * nearPlane * rangeInv;
+        Matrix4.mat[3][3] = T(0);
         return Matrix4;
     }
 
@@ -206,25 +265,84 @@ namespace glmCS
     template <typename T, size_t rows, size_t cols>
     Matrix<T, rows, cols> matrixMultiply(const Matrix<T, rows, cols> &matrix, const T b[cols][cols])
     {
+        // result 是新对象，不会与输入重叠，直接累加即可
         Matrix<T, rows, cols> result;
-        T temp[rows][cols];
         size_t i, j, k;
         for (i = 0; i < rows; i++)
         {
             for (j = 0; j < cols; j++)
             {
-                temp[i][j] = T(0);
+                T sum = T(0);
                 for (k = 0; k < cols; k++)
                 {
-                    temp[i][j] += matrix.mat[i][k] * b[k][j];
+                    sum += matrix.mat[i][k] * b[k][j];
                 }
+                result.mat[i][j] = sum;
             }
         }
+        return result;
+    }
+
+#if defined(GLMCS_HAS_SSE2)
+    // 4x4矩阵乘法（SSE）：结果的每一行为 b 的四行按 matrix 该行元素加权求和
+    inline Matrix<float, 4, 4> matrixMultiply(const Matrix<float, 4, 4> &matrix, const float b[4][4])
+    {
+        Matrix<float, 4, 4> result;
+        __m128 b0 = _mm_loadu_ps(b[0]);
+        __m128 b1 = _mm_loadu_ps(b[1]);
+        __m128 b2 = _mm_loadu_ps(b[2]);
+        __m128 b3 = _mm_loadu_ps(b[3]);
+        for (size_t i = 0; i < 4; i++)
+        {
+            __m128 r = _mm_mul_ps(_mm_set1_ps(matrix.mat[i][0]), b0);
+            r = simd::madd(_mm_set1_ps(matrix.mat[i][1]), b1, r);
+            r = simd::madd(_mm_set1_ps(matrix.mat[i][2]), b2, r);
+            r = simd::madd(_mm_set1_ps(matrix.mat[i][3]), b3, r);
+            _mm_storeu_ps(result.mat[i], r);
+        }
+        return result;
+    }
+#endif
+
+#if defined(GLMCS_HAS_AVX)
+    // 4x4双精度矩阵乘法（AVX）
+    inline Matrix<double, 4, 4> matrixMultiply(const Matrix<double, 4, 4> &matrix, const double b[4][4])
+    {
+        Matrix<double, 4, 4> result;
+        __m256d b0 = _mm256_loadu_pd(b[0]);
+        __m256d b1 = _mm256_loadu_pd(b[1]);
+        __m256d b2 = _mm256_loadu_pd(b[2]);
+        __m256d b3 = _mm256_loadu_pd(b[3]);
+        for (size_t i = 0; i < 4; i++)
+        {
+            __m256d r = _mm256_mul_pd(_mm256_set1_pd(matrix.mat[i][0]), b0);
+            r = simd::madd(_mm256_set1_pd(matrix.mat[i][1]), b1, r);
+            r = simd::madd(_mm256_set1_pd(matrix.mat[i][2]), b2, r);
+            r = simd::madd(_mm256_set1_pd(matrix.mat[i][3]), b3, r);
+            _mm256_storeu_pd(result.mat[i], r);
+        }
+        return result;
+    }
+#endif
+
+    // 两个矩阵相乘：matrix * b
+    template <typename T, size_t rows, size_t cols>
+    inline Matrix<T, rows, cols> matrixMultiply(const Matrix<T, rows, cols> &matrix, const Matrix<T, cols, cols> &b)
+    {
+        return matrixMultiply(matrix, b.mat);
+    }
+
+    // 矩阵元素类型转换（例如 double -> float）
+    template <typename U, typename T, size_t rows, size_t cols>
+    inline Matrix<U, rows, cols> convertMatrix(const Matrix<T, rows, cols> &matrix)
+    {
+        Matrix<U, rows, cols> result;
+        size_t i, j;
         for (i = 0; i < rows; i++)
         {
             for (j = 0; j < cols; j++)
             {
-                result.mat[i][j] = temp[i][j];
+                result.mat[i][j] = U(matrix.mat[i][j]);
             }
         }
         return result;
@@ -236,51 +354,141 @@ namespace glmCS
     /// @param x 旋转轴为x轴
     /// @param y 旋转轴为y轴
     /// @param z 旋转轴为z轴
-    /// @return
-    inline Matrix<float, 4, 4> rotate(float angle, const Matrix<float, 4, 4> &matrix, bool x, bool y, bool z)
+    /// @param status 可为 nullptr；写入 GLMCS_ok，或轴无效时写入 GLMCS_not_rotate（并上报 GLMCS_error_invalid_axis；GLMCS_NO_CHECKS 下仍检查，只是不上报）
+    /// @return 旋转后的矩阵，轴无效时返回原矩阵
+    /// MathPolicy 为 PreciseMath（默认）或 FastMath，例如 rotate<float, FastMath>(...)
+    template <typename T, typename MathPolicy = PreciseMath>
+    inline Matrix<T, 4, 4> rotate(typename NonDeduced<T>::type angle, const Matrix<T, 4, 4> &matrix, bool x, bool y, bool z, int *status = nullptr)
     {
-        Matrix<float, 4, 4> result = matrix;
+        Matrix<T, 4, 4> result = matrix;
         // 不旋转
-        if ((int)x + (int)y + (int)z != 1)
+        if (!GLMCS_GUARD((int)x + (int)y + (int)z == 1, GLMCS_error_invalid_axis, "rotate"))
         {
-            fprintf(stderr, "[%s:%i] [rotate error] Not rotated, make sure that the specified axis of rotation x,y,z has and only one is 1!\n", __FILE__, __LINE__);
-            if ((int)x + (int)y + (int)z == 0)
+            if (status)
             {
-                return result; // 返回未旋转的矩阵
+                *status = GLMCS_not_rotate;
             }
             return result; // 返回原始矩阵
         }
-        float radian = angle * M_PI / 180.0f;
+        if (status)
+        {
+            *status = GLMCS_ok;
+        }
+        T radian = T(angle * M_PI / 180.0);
+        T c, s;
+        MathPolicy::sincos(radian, &s, &c);
         if (x == 1)
         {
-            float rotationMatrix[4][4] = {
-                {1.0f, 0.0f, 0.0f, 0.0f},
-                {0.0f, cosf(radian), sinf(radian), 0.0f},
-                {0.0f, -sinf(radian), cosf(radian), 0.0f},
-                {0.0f, 0.0f, 0.0f, 1.0f}};
+            T rotationMatrix[4][4] = {
+                {T(1), T(0), T(0), T(0)},
+                {T(0), c, s, T(0)},
+                {T(0), -s, c, T(0)},
+                {T(0), T(0), T(0), T(1)}};
             result = matrixMultiply(matrix, rotationMatrix);
         }
         else if (y == 1)
         {
-            float rotationMatrix[4][4] = {
-                {cosf(radian), 0.0f, -sinf(radian), 0.0f},
-                {0.0f, 1.0f, 0.0f, 0.0f},
-                {sinf(radian), 0.0f, cosf(radian), 0.0f},
-                {0.0f, 0.0f, 0.0f, 1.0f}};
+            T rotationMatrix[4][4] = {
+                {c, T(0), -s, T(0)},
+                {T(0), T(1), T(0), T(0)},
+                {s, T(0), c, T(0)},
+                {T(0), T(0), T(0), T(1)}};
             result = matrixMultiply(matrix, rotationMatrix);
         }
         else if (z == 1)
         {
-            float rotationMatrix[4][4] = {
-                {cosf(radian), sinf(radian), 0.0f, 0.0f},
-                {-sinf(radian), cosf(radian), 0.0f, 0.0f},
-                {0.0f, 0.0f, 1.0f, 0.0f},
-                {0.0f, 0.0f, 0.0f, 1.0f}};
+            T rotationMatrix[4][4] = {
+                {c, s, T(0), T(0)},
+                {-s, c, T(0), T(0)},
+                {T(0), T(0), T(1), T(0)},
+                {T(0), T(0), T(0), T(1)}};
             result = matrixMultiply(matrix, rotationMatrix);
         }
         return result;
     }
 
+    /// @brief 将双精度世界矩阵转换为以相机为原点的单精度矩阵（相机相对渲染）。
+    /// 平移在双精度下减去相机位置后才转换为float，避免大坐标下的精度丢失；一次遍历完成，无中间矩阵。
+    /// 配合 lookAt(vec3(0,0,0), target - eye, up) 得到的无平移观察矩阵使用。
+    /// @param world 双精度世界矩阵
+    /// @param eye 相机位置（双精度世界坐标）
+    /// @return 相机相对的单精度模型矩阵
+    inline Matrix<float, 4, 4> cameraRelativeMatrix(const Matrix<double, 4, 4> &world, const DVector3 &eye)
+    {
+        Matrix<float, 4, 4> result;
+#if defined(GLMCS_HAS_AVX)
+        __m256d e = _mm256_set_pd(0.0, eye.z, eye.y, eye.x);
+        for (size_t i = 0; i < 4; i++)
+        {
+            // row - row.w * eye，仿射矩阵只影响平移行
+            __m256d r = _mm256_loadu_pd(world.mat[i]);
+            r = _mm256_sub_pd(r, _mm256_mul_pd(_mm256_set1_pd(world.mat[i][3]), e));
+            _mm_storeu_ps(result.mat[i], _mm256_cvtpd_ps(r));
+        }
+#else
+        for (size_t i = 0; i < 4; i++)
+        {
+            double w = world.mat[i][3];
+            result.mat[i][0] = float(world.mat[i][0] - w * eye.x);
+            result.mat[i][1] = float(world.mat[i][1] - w * eye.y);
+            result.mat[i][2] = float(world.mat[i][2] - w * eye.z);
+            result.mat[i][3] = float(w);
+        }
+#endif
+        return result;
+    }
+
+    /// @brief 批量转换相机相对矩阵
+    /// @param world 双精度世界矩阵数组
+    /// @param count 矩阵个数
+    /// @param eye 相机位置（双精度世界坐标）
+    /// @param result 输出的单精度矩阵数组
+    inline void cameraRelativeMatrices(const Matrix<double, 4, 4> *world, size_t count, const DVector3 &eye, Matrix<float, 4, 4> *result)
+    {
+        for (size_t n = 0; n < count; n++)
+        {
+            result[n] = cameraRelativeMatrix(world[n], eye);
+        }
+    }
+
+    /// @brief 双精度 world * view 相乘后直接输出单精度模型观察矩阵（乘法与类型转换合并为一次遍历）。
+    /// 大坐标的平移在双精度下相互抵消，结果只保留相机附近的小数值。
+    /// @param world 双精度世界矩阵
+    /// @param view 双精度观察矩阵
+    /// @return 单精度模型观察矩阵
+    inline Matrix<float, 4, 4> modelViewMatrix(const Matrix<double, 4, 4> &world, const Matrix<double, 4, 4> &view)
+    {
+        Matrix<float, 4, 4> result;
+#if defined(GLMCS_HAS_AVX)
+        __m256d b0 = _mm256_loadu_pd(view.mat[0]);
+        __m256d b1 = _mm256_loadu_pd(view.mat[1]);
+        __m256d b2 = _mm256_loadu_pd(view.mat[2]);
+        __m256d b3 = _mm256_loadu_pd(view.mat[3]);
+        for (size_t i = 0; i < 4; i++)
+        {
+            __m256d r = _mm256_mul_pd(_mm256_set1_pd(world.mat[i][0]), b0);
+            r = simd::madd(_mm256_set1_pd(world.mat[i][1]), b1, r);
+            r = simd::madd(_mm256_set1_pd(world.mat[i][2]), b2, r);
+            r = simd::madd(_mm256_set1_pd(world.mat[i][3]), b3, r);
+            _mm_storeu_ps(result.mat[i], _mm256_cvtpd_ps(r));
+        }
+#else
+        for (size_t i = 0; i < 4; i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+            {
+                double sum = 0.0;
+                for (size_t k = 0; k < 4; k++)
+                {
+                    sum += world.mat[i][k] * view.mat[k][j];
+                }
+                result.mat[i][j] = float(sum);
+            }
+        }
+#endif
+        return result;
+    }
+
     /// @brief 在给定的矩阵上进行缩放变换
     /// @param matrix 要进行缩放变换的矩阵
     /// @param x X轴方向上的缩放因子
@@ -304,6 +512,128 @@ namespace glmCS
         return result;
     }
 
+    // 转置矩阵（布局不变）
+    template <typename T, size_t rows, size_t cols, typename Layout>
+    inline Matrix<T, cols, rows, Layout> transpose(const Matrix<T, rows, cols, Layout> &matrix)
+    {
+        Matrix<T, cols, rows, Layout> result;
+        size_t i, j;
+        for (i = 0; i < rows; i++)
+        {
+            for (j = 0; j < cols; j++)
+            {
+                result.mat[j][i] = matrix.mat[i][j];
+            }
+        }
+        return result;
+    }
+
+    /// @brief 仿射矩阵（旋转/缩放/错切 + 平移，最后一行为 0 0 0 1）求逆，比通用 4x4 求逆少一半运算
+    /// @param matrix 可逆的仿射矩阵，例如 translateMatrix / rotate / scaleMatrix / lookAt 的结果
+    template <typename T>
+    inline Matrix<T, 4, 4> inverseAffine(const Matrix<T, 4, 4> &matrix)
+    {
+        // 存储的左上 3x3 是数学矩阵的转置，其逆矩阵即为逆矩阵的存储
+        const T(*a)[4] = matrix.mat;
+        Matrix<T, 4, 4> result;
+        result.mat[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+        result.mat[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+        result.mat[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+        result.mat[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+        result.mat[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+        result.mat[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+        result.mat[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+        result.mat[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+        result.mat[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        T invDet = T(1) / (a[0][0] * result.mat[0][0] + a[0][1] * result.mat[1][0] + a[0][2] * result.mat[2][0]);
+        size_t i, j;
+        for (i = 0; i < 3; i++)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                result.mat[i][j] *= invDet;
+            }
+            result.mat[i][3] = T(0);
+        }
+        // 平移：-R^-1 * t
+        for (j = 0; j < 3; j++)
+        {
+            result.mat[3][j] = -(a[3][0] * result.mat[0][j] + a[3][1] * result.mat[1][j] + a[3][2] * result.mat[2][j]);
+        }
+        result.mat[3][3] = T(1);
+        return result;
+    }
+
+    /// @brief 转换存储布局，表示的数学矩阵不变
+    /// @param matrix 输入矩阵
+    /// @return 以 ToLayout 存储的同一矩阵
+    template <typename ToLayout, typename T, size_t rows, size_t cols, typename Layout>
+    inline Matrix<T, cols, rows, ToLayout> convertLayout(const Matrix<T, rows, cols, Layout> &matrix)
+    {
+        static_assert(!std::is_same<ToLayout, Layout>::value || rows == cols, "use a plain copy to keep the same layout");
+        Matrix<T, cols, rows, ToLayout> result;
+        size_t i, j;
+        for (i = 0; i < rows; i++)
+        {
+            for (j = 0; j < cols; j++)
+            {
+                result.mat[j][i] = std::is_same<ToLayout, Layout>::value ? matrix.mat[j][i] : matrix.mat[i][j];
+            }
+        }
+        return result;
+    }
+
+    // 按数学意义的 (行, 列) 访问元素，与存储布局无关
+    template <typename T, size_t rows, size_t cols>
+    inline T &element(Matrix<T, rows, cols, ColumnMajor> &matrix, size_t row, size_t col) { return matrix.mat[col][row]; }
+    template <typename T, size_t rows, size_t cols>
+    inline T element(const Matrix<T, rows, cols, ColumnMajor> &matrix, size_t row, size_t col) { return matrix.mat[col][row]; }
+    template <typename T, size_t rows, size_t cols>
+    inline T &element(Matrix<T, rows, cols, RowMajor> &matrix, size_t row, size_t col) { return matrix.mat[row][col]; }
+    template <typename T, size_t rows, size_t cols>
+    inline T element(const Matrix<T, rows, cols, RowMajor> &matrix, size_t row, size_t col) { return matrix.mat[row][col]; }
+
+    /// @brief 获取连续存储的首地址，用于 glUniformMatrix*fv(location, count, Layout::transposeOnUpload, valuePtr(m))
+    template <typename T, size_t rows, size_t cols, typename Layout>
+    inline const T *valuePtr(const Matrix<T, rows, cols, Layout> &matrix)
+    {
+        static_assert(sizeof(Matrix<T, rows, cols, Layout>) == sizeof(T) * rows * cols, "matrix storage must be contiguous");
+        return &matrix.mat[0][0];
+    }
+    template <typename T, size_t rows, size_t cols, typename Layout>
+    inline T *valuePtr(Matrix<T, rows, cols, Layout> &matrix)
+    {
+        static_assert(sizeof(Matrix<T, rows, cols, Layout>) == sizeof(T) * rows * cols, "matrix storage must be contiguous");
+        return &matrix.mat[0][0];
+    }
+
+    /// @brief 将矩阵数组写入上传缓冲区（glUniformMatrix4fv(..., GL_FALSE, ...) / UBO / SSBO 的列主序布局）。
+    /// ColumnMajor 数组没有填充，整体只需一次 memcpy；RowMajor 数组逐个转置。
+    /// @param matrices 矩阵数组
+    /// @param count 矩阵个数
+    /// @param dst 上传缓冲区，至少 count * rows * cols 个元素
+    template <typename T, size_t rows, size_t cols, typename Layout>
+    inline void copyMatricesForUpload(const Matrix<T, rows, cols, Layout> *matrices, size_t count, T *dst)
+    {
+        static_assert(sizeof(Matrix<T, rows, cols, Layout>) == sizeof(T) * rows * cols, "matrix storage must be contiguous");
+        if (!Layout::transposeOnUpload)
+        {
+            memcpy(dst, matrices, count * sizeof(Matrix<T, rows, cols, Layout>));
+            return;
+        }
+        for (size_t n = 0; n < count; n++)
+        {
+            size_t i, j;
+            for (i = 0; i < rows; i++)
+            {
+                for (j = 0; j < cols; j++)
+                {
+                    dst[n * rows * cols + j * rows + i] = matrices[n].mat[i][j];
+                }
+            }
+        }
+    }
+
     // 打印矩阵
     template <typename T, size_t rows, size_t cols>
     inline void printMatrix(const Matrix<T, rows, cols> *matrix)
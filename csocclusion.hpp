@@ -0,0 +1,485 @@
+/// @ref core
+/// @file csocclusion.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Software occlusion culling on the CPU: rasterize a few large occluders into a small depth buffer, then
+/// test object bounding boxes against it before issuing draw calls.
+/// Occluder meshes are transformed by a glmCS model-view-projection matrix and clipped against the near plane.
+/// Each triangle is set up once in screen space and queued. rasterize() bins the queued triangles by tile row and
+/// fills the rows on several threads. Each row is taken from a shared counter, so rows with many triangles do not
+/// hold up the other threads. Every 8x8 tile stores its 64 depths contiguously, so a tile row is one AVX register.
+/// Each tile also keeps the farthest depth it contains. This is the coarse level of a two-level hierarchical depth
+/// buffer: a triangle that is entirely behind a tile's farthest depth skips that tile, and a box in front of it
+/// is visible without reading any pixel.
+///
+/// Depths are z / w in the projection's convention. With reverse-Z they are stored negated, so smaller always means
+/// nearer, and an empty pixel holds +INFINITY. Pixels are sampled at their centres, and row 0 is the bottom of the
+/// image, as with glReadPixels. The buffer size is rounded up to whole tiles and NDC maps onto the rounded size.
+///
+/// The box test is conservative. A box is reported visible if it crosses the near plane, or if its nearest corner
+/// depth is not behind the occluder depth at some pixel its screen rectangle touches. Boxes entirely outside the
+/// viewport are reported hidden, so run cullAABBs() first and pass its mask in. testAABBs() only clears the bits of
+/// boxes it proves hidden.
+///
+/// glmCS::OcclusionCuller culler(256, 128);
+/// culler.clear();
+/// culler.addOccluder(positions, vertexCount, indices, triangleCount, glmCS::matrixMultiply(model, viewProjection.mat));
+/// culler.rasterize(4);
+/// glmCS::cullAABBs(frustum, boxes, count, visible, 4);
+/// culler.testAABBs(boxes, count, viewProjection, visible, 4);
+///
+
+#ifndef __CSOCCLUSION_H__
+#define __CSOCCLUSION_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "cssimd_utils.hpp"
+#include "csfrustum_utils.hpp"
+#include "cscamera.hpp"
+#include "csparallel_utils.hpp"
+#include "cserror_utils.hpp"
+
+namespace glmCS
+{
+    namespace occlusion
+    {
+        const size_t tileSize = 8;
+        const size_t tilePixels = tileSize * tileSize;
+
+        // 屏幕空间中已完成建立的三角形
+        struct ScreenTriangle
+        {
+            float edgeX[3], edgeY[3]; // 各边起点
+            float edgeA[3], edgeB[3]; // 边函数 A * (x - edgeX) + B * (y - edgeY) >= 0 为内侧
+            float x0, y0, z0;         // 深度平面 z = z0 + dzdx * (x - x0) + dzdy * (y - y0)
+            float dzdx, dzdy;
+            float zMin;
+            uint32_t tileX0, tileY0, tileX1, tileY1; // 覆盖的 tile 范围（含两端）
+        };
+
+        // 到近平面的有向距离，>= 0 为近平面以内
+        inline float nearDistance(const float *clip, CameraDepthMode mode)
+        {
+            switch (mode)
+            {
+            case GLMCS_depth_zero_to_one:
+                return clip[2];
+            case GLMCS_depth_reverse_z:
+                return clip[3] - clip[2];
+            default:
+                return clip[2] + clip[3];
+            }
+        }
+
+        // 存储的深度：越小越近
+        inline float depthKey(float z, float invW, CameraDepthMode mode)
+        {
+            return mode == GLMCS_depth_reverse_z ? -z * invW : z * invW;
+        }
+
+        /// @brief 把三角形光栅化到一个 8x8 tile，逐像素取较近的深度
+        /// @return tile 中最远的深度
+        inline float rasterizeTile(const ScreenTriangle &t, float *tileDepth, size_t tileX, size_t tileY)
+        {
+            float baseX = float(tileX * tileSize) + 0.5f, baseY = float(tileY * tileSize) + 0.5f;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(baseX), lanes);
+            __m256 e0 = _mm256_mul_ps(_mm256_set1_ps(t.edgeA[0]), _mm256_sub_ps(px, _mm256_set1_ps(t.edgeX[0])));
+            __m256 e1 = _mm256_mul_ps(_mm256_set1_ps(t.edgeA[1]), _mm256_sub_ps(px, _mm256_set1_ps(t.edgeX[1])));
+            __m256 e2 = _mm256_mul_ps(_mm256_set1_ps(t.edgeA[2]), _mm256_sub_ps(px, _mm256_set1_ps(t.edgeX[2])));
+            __m256 zx = simd::madd(_mm256_set1_ps(t.dzdx), _mm256_sub_ps(px, _mm256_set1_ps(t.x0)), _mm256_set1_ps(t.z0));
+            __m256 farthest = _mm256_set1_ps(-INFINITY);
+            for (size_t r = 0; r < tileSize; r++)
+            {
+                float py = baseY + float(r);
+                __m256 inside = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(e0, _mm256_set1_ps(t.edgeB[0] * (py - t.edgeY[0]))), zero, _CMP_GE_OQ),
+                                              _mm256_cmp_ps(_mm256_add_ps(e1, _mm256_set1_ps(t.edgeB[1] * (py - t.edgeY[1]))), zero, _CMP_GE_OQ));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(e2, _mm256_set1_ps(t.edgeB[2] * (py - t.edgeY[2]))), zero, _CMP_GE_OQ));
+                __m256 z = _mm256_add_ps(zx, _mm256_set1_ps(t.dzdy * (py - t.y0)));
+                __m256 d = _mm256_loadu_ps(tileDepth + r * tileSize);
+                d = _mm256_blendv_ps(d, _mm256_min_ps(d, z), inside);
+                _mm256_storeu_ps(tileDepth + r * tileSize, d);
+                farthest = _mm256_max_ps(farthest, d);
+            }
+            __m128 m = _mm_max_ps(_mm256_castps256_ps128(farthest), _mm256_extractf128_ps(farthest, 1));
+            m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+            m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+            return _mm_cvtss_f32(m);
+#else
+            float farthest = -INFINITY;
+            for (size_t r = 0; r < tileSize; r++)
+            {
+                float py = baseY + float(r);
+                for (size_t c = 0; c < tileSize; c++)
+                {
+                    float px = baseX + float(c);
+                    float *d = tileDepth + r * tileSize + c;
+                    if (t.edgeA[0] * (px - t.edgeX[0]) + t.edgeB[0] * (py - t.edgeY[0]) >= 0.0f &&
+                        t.edgeA[1] * (px - t.edgeX[1]) + t.edgeB[1] * (py - t.edgeY[1]) >= 0.0f &&
+                        t.edgeA[2] * (px - t.edgeX[2]) + t.edgeB[2] * (py - t.edgeY[2]) >= 0.0f)
+                    {
+                        float z = t.z0 + t.dzdx * (px - t.x0) + t.dzdy * (py - t.y0);
+                        *d = z < *d ? z : *d;
+                    }
+                    farthest = *d > farthest ? *d : farthest;
+                }
+            }
+            return farthest;
+#endif
+        }
+    } // namespace occlusion
+
+    class OcclusionCuller
+    {
+    public:
+        /// @param width,height 深度缓冲的像素尺寸，向上取整到 8 的倍数
+        /// @param depthMode 遮挡物与包围盒所用投影矩阵的深度约定
+        OcclusionCuller(size_t width, size_t height, CameraDepthMode depthMode = GLMCS_depth_negative_one_to_one)
+            : mode(depthMode)
+        {
+            resize(width, height);
+        }
+
+        void resize(size_t width, size_t height)
+        {
+            tilesX = width > 0 ? (width + occlusion::tileSize - 1) / occlusion::tileSize : 1;
+            tilesY = height > 0 ? (height + occlusion::tileSize - 1) / occlusion::tileSize : 1;
+            depthBuffer.resize(tilesX * tilesY * occlusion::tilePixels);
+            tileMax.resize(tilesX * tilesY);
+            clear();
+        }
+
+        void setDepthMode(CameraDepthMode depthMode) { mode = depthMode; }
+        CameraDepthMode depthMode() const { return mode; }
+
+        size_t width() const { return tilesX * occlusion::tileSize; }
+        size_t height() const { return tilesY * occlusion::tileSize; }
+        size_t tileCountX() const { return tilesX; }
+        size_t tileCountY() const { return tilesY; }
+
+        // 清空深度缓冲与待光栅化的三角形，每帧开始时调用
+        void clear()
+        {
+            std::fill(depthBuffer.begin(), depthBuffer.end(), INFINITY);
+            std::fill(tileMax.begin(), tileMax.end(), INFINITY);
+            triangles.clear();
+        }
+
+        /// @brief 变换、裁剪遮挡物网格并加入待光栅化队列
+        /// @param positions 顶点位置 xyz 紧密排列
+        /// @param indices 每 3 个索引组成一个三角形，两种绕序都会绘制
+        /// @param modelViewProjection 模型到裁剪空间的矩阵
+        /// @return 加入队列的屏幕空间三角形个数
+        size_t addOccluder(const float *positions, size_t vertexCount, const uint32_t *indices, size_t triangleCount,
+                           const Matrix<float, 4, 4> &modelViewProjection)
+        {
+            const float(*m)[4] = modelViewProjection.mat;
+            clipVertices.resize(vertexCount * 4);
+            for (size_t i = 0; i < vertexCount; i++)
+            {
+                float x = positions[i * 3], y = positions[i * 3 + 1], z = positions[i * 3 + 2];
+                for (size_t r = 0; r < 4; r++)
+                {
+                    clipVertices[i * 4 + r] = m[0][r] * x + m[1][r] * y + m[2][r] * z + m[3][r];
+                }
+            }
+            size_t queued = triangles.size();
+            for (size_t t = 0; t < triangleCount; t++)
+            {
+                uint32_t i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+                if (!GLMCS_GUARD(i0 < vertexCount && i1 < vertexCount && i2 < vertexCount, GLMCS_error_index_out_of_range, "addOccluder"))
+                {
+                    continue;
+                }
+                const float *v[3] = {&clipVertices[i0 * 4], &clipVertices[i1 * 4], &clipVertices[i2 * 4]};
+                float d[3] = {occlusion::nearDistance(v[0], mode), occlusion::nearDistance(v[1], mode), occlusion::nearDistance(v[2], mode)};
+                if (d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f)
+                {
+                    setupTriangle(v[0], v[1], v[2]);
+                    continue;
+                }
+                // 与近平面相交：裁剪成 3 或 4 边形后按扇形拆分
+                float polygon[4][4];
+                size_t n = 0;
+                for (size_t k = 0; k < 3; k++)
+                {
+                    size_t next = (k + 1) % 3;
+                    if (d[k] >= 0.0f)
+                    {
+                        for (size_t c = 0; c < 4; c++)
+                        {
+                            polygon[n][c] = v[k][c];
+                        }
+                        n++;
+                    }
+                    if ((d[k] >= 0.0f) != (d[next] >= 0.0f))
+                    {
+                        float s = d[k] / (d[k] - d[next]);
+                        for (size_t c = 0; c < 4; c++)
+                        {
+                            polygon[n][c] = v[k][c] + (v[next][c] - v[k][c]) * s;
+                        }
+                        n++;
+                    }
+                }
+                for (size_t k = 2; k < n; k++)
+                {
+                    setupTriangle(polygon[0], polygon[k - 1], polygon[k]);
+                }
+            }
+            return triangles.size() - queued;
+        }
+
+        size_t queuedTriangles() const { return triangles.size(); }
+
+        /// @brief 光栅化队列中的全部三角形并清空队列
+        /// @param threads 线程数，按 tile 行动态分配
+        void rasterize(unsigned threads = 1)
+        {
+            // 按 tile 行分桶（计数排序），每行只遍历与之相交的三角形
+            rowStart.assign(tilesY + 1, 0);
+            for (size_t i = 0; i < triangles.size(); i++)
+            {
+                for (size_t ty = triangles[i].tileY0; ty <= triangles[i].tileY1; ty++)
+                {
+                    rowStart[ty + 1]++;
+                }
+            }
+            for (size_t ty = 0; ty < tilesY; ty++)
+            {
+                rowStart[ty + 1] += rowStart[ty];
+            }
+            rowTriangles.resize(rowStart[tilesY]);
+            std::vector<uint32_t> fill(rowStart.begin(), rowStart.end() - 1);
+            for (size_t i = 0; i < triangles.size(); i++)
+            {
+                for (size_t ty = triangles[i].tileY0; ty <= triangles[i].tileY1; ty++)
+                {
+                    rowTriangles[fill[ty]++] = uint32_t(i);
+                }
+            }
+            parallelForEach(tilesY, threads, [&](size_t ty)
+                            { rasterizeRow(ty); });
+            triangles.clear();
+        }
+
+        // 像素 (x, y) 的深度（越小越近，空像素为 +INFINITY）
+        float depth(size_t x, size_t y) const
+        {
+            size_t tile = (y / occlusion::tileSize) * tilesX + x / occlusion::tileSize;
+            return depthBuffer[tile * occlusion::tilePixels + (y % occlusion::tileSize) * occlusion::tileSize + x % occlusion::tileSize];
+        }
+
+        // tile (tileX, tileY) 中最远的深度
+        float tileMaxDepth(size_t tileX, size_t tileY) const { return tileMax[tileY * tilesX + tileX]; }
+
+        /// @brief 测试一个包围盒是否可能可见
+        /// @param viewProjection 与遮挡物使用同一相机的 view-projection 矩阵
+        bool testAABB(const Vector3 &center, const Vector3 &extent, const Matrix<float, 4, 4> &viewProjection) const
+        {
+            return testBox(center.x, center.y, center.z, extent.x, extent.y, extent.z, viewProjection);
+        }
+
+        /// @brief 批量测试包围盒，清除被完全遮挡的包围盒在 visibleMask 中的位
+        /// @param visibleMask 输入输出：第 i 位为 1 的包围盒才会测试（例如 cullAABBs() 的结果）
+        /// @param threads 线程数，1 表示在调用线程上完成
+        void testAABBs(const AABBArraysSoA &boxes, size_t count, const Matrix<float, 4, 4> &viewProjection, uint32_t *visibleMask,
+                       unsigned threads = 1) const
+        {
+            parallelFor(count, threads, [&](size_t begin, size_t end)
+                        {
+                            for (size_t i = begin; i < end; i++)
+                            {
+                                uint32_t bit = 1u << (i % 32);
+                                if ((visibleMask[i / 32] & bit) != 0 &&
+                                    !testBox(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i], boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i], viewProjection))
+                                {
+                                    visibleMask[i / 32] &= ~bit;
+                                }
+                            } }, 32);
+        }
+
+    private:
+        CameraDepthMode mode;
+        size_t tilesX = 0, tilesY = 0;
+        std::vector<float> depthBuffer; // 按 tile 排列，每个 tile 64 个深度（8 行 x 8 列）
+        std::vector<float> tileMax;     // 每个 tile 中最远的深度
+        std::vector<occlusion::ScreenTriangle> triangles;
+        std::vector<float> clipVertices;
+        std::vector<uint32_t> rowStart, rowTriangles;
+
+        // 透视除法、视口变换并计算边函数与深度平面，完全在屏幕外或退化的三角形被丢弃
+        void setupTriangle(const float *a, const float *b, const float *c)
+        {
+            const float *v[3] = {a, b, c};
+            float x[3], y[3], z[3];
+            float w = float(width()), h = float(height());
+            for (size_t k = 0; k < 3; k++)
+            {
+                if (!(v[k][3] > 0.0f))
+                {
+                    return;
+                }
+                float invW = 1.0f / v[k][3];
+                x[k] = (v[k][0] * invW * 0.5f + 0.5f) * w;
+                y[k] = (v[k][1] * invW * 0.5f + 0.5f) * h;
+                z[k] = occlusion::depthKey(v[k][2], invW, mode);
+            }
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+            if (!(area != 0.0f))
+            {
+                return;
+            }
+            if (area < 0.0f)
+            {
+                // 统一为逆时针，使内侧的边函数为正
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(z[1], z[2]);
+                area = -area;
+            }
+            // 覆盖的像素中心范围
+            float minX = std::min(x[0], std::min(x[1], x[2])), maxX = std::max(x[0], std::max(x[1], x[2]));
+            float minY = std::min(y[0], std::min(y[1], y[2])), maxY = std::max(y[0], std::max(y[1], y[2]));
+            float px0 = std::max(ceilf(minX - 0.5f), 0.0f), px1 = std::min(floorf(maxX - 0.5f), w - 1.0f);
+            float py0 = std::max(ceilf(minY - 0.5f), 0.0f), py1 = std::min(floorf(maxY - 0.5f), h - 1.0f);
+            if (!(px0 <= px1 && py0 <= py1))
+            {
+                return;
+            }
+            occlusion::ScreenTriangle t;
+            for (size_t e = 0; e < 3; e++)
+            {
+                size_t next = (e + 1) % 3;
+                t.edgeX[e] = x[e];
+                t.edgeY[e] = y[e];
+                t.edgeA[e] = y[e] - y[next];
+                t.edgeB[e] = x[next] - x[e];
+            }
+            t.x0 = x[0];
+            t.y0 = y[0];
+            t.z0 = z[0];
+            t.dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+            t.dzdy = ((x[1] - x[0]) * (z[2] - z[0]) - (x[2] - x[0]) * (z[1] - z[0])) / area;
+            t.zMin = std::min(z[0], std::min(z[1], z[2]));
+            t.tileX0 = uint32_t(px0) / occlusion::tileSize;
+            t.tileX1 = uint32_t(px1) / occlusion::tileSize;
+            t.tileY0 = uint32_t(py0) / occlusion::tileSize;
+            t.tileY1 = uint32_t(py1) / occlusion::tileSize;
+            triangles.push_back(t);
+        }
+
+        void rasterizeRow(size_t ty)
+        {
+            for (size_t k = rowStart[ty]; k < rowStart[ty + 1]; k++)
+            {
+                const occlusion::ScreenTriangle &t = triangles[rowTriangles[k]];
+                for (size_t tx = t.tileX0; tx <= t.tileX1; tx++)
+                {
+                    size_t tile = ty * tilesX + tx;
+                    // 三角形最近的深度也不比 tile 中最远的深度近：不会改变任何像素
+                    if (t.zMin >= tileMax[tile])
+                    {
+                        continue;
+                    }
+                    tileMax[tile] = occlusion::rasterizeTile(t, &depthBuffer[tile * occlusion::tilePixels], tx, ty);
+                }
+            }
+        }
+
+        bool testBox(float cx, float cy, float cz, float ex, float ey, float ez, const Matrix<float, 4, 4> &viewProjection) const
+        {
+            const float(*m)[4] = viewProjection.mat;
+            float center[4], axisX[4], axisY[4], axisZ[4];
+            for (size_t r = 0; r < 4; r++)
+            {
+                center[r] = m[0][r] * cx + m[1][r] * cy + m[2][r] * cz + m[3][r];
+                axisX[r] = m[0][r] * ex;
+                axisY[r] = m[1][r] * ey;
+                axisZ[r] = m[2][r] * ez;
+            }
+            float w = float(width()), h = float(height());
+            float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY, minZ = INFINITY;
+            for (size_t k = 0; k < 8; k++)
+            {
+                float sx = (k & 1) ? 1.0f : -1.0f, sy = (k & 2) ? 1.0f : -1.0f, sz = (k & 4) ? 1.0f : -1.0f;
+                float corner[4];
+                for (size_t r = 0; r < 4; r++)
+                {
+                    corner[r] = center[r] + sx * axisX[r] + sy * axisY[r] + sz * axisZ[r];
+                }
+                // 穿过近平面：无法得到可靠的屏幕范围，视为可见
+                if (!(occlusion::nearDistance(corner, mode) > 0.0f) || !(corner[3] > 0.0f))
+                {
+                    return true;
+                }
+                float invW = 1.0f / corner[3];
+                float x = (corner[0] * invW * 0.5f + 0.5f) * w, y = (corner[1] * invW * 0.5f + 0.5f) * h;
+                float z = occlusion::depthKey(corner[2], invW, mode);
+                minX = x < minX ? x : minX;
+                maxX = x > maxX ? x : maxX;
+                minY = y < minY ? y : minY;
+                maxY = y > maxY ? y : maxY;
+                minZ = z < minZ ? z : minZ;
+            }
+            // 屏幕矩形接触到的全部像素
+            if (!(maxX >= 0.0f && minX < w && maxY >= 0.0f && minY < h))
+            {
+                return false;
+            }
+            size_t px0 = size_t(std::max(minX, 0.0f)), px1 = size_t(std::min(maxX, w - 1.0f));
+            size_t py0 = size_t(std::max(minY, 0.0f)), py1 = size_t(std::min(maxY, h - 1.0f));
+            for (size_t ty = py0 / occlusion::tileSize; ty <= py1 / occlusion::tileSize; ty++)
+            {
+                size_t r0 = ty == py0 / occlusion::tileSize ? py0 % occlusion::tileSize : 0;
+                size_t r1 = ty == py1 / occlusion::tileSize ? py1 % occlusion::tileSize : occlusion::tileSize - 1;
+                for (size_t tx = px0 / occlusion::tileSize; tx <= px1 / occlusion::tileSize; tx++)
+                {
+                    size_t tile = ty * tilesX + tx;
+                    // 包围盒比 tile 中最远的深度还远：整个 tile 都遮挡了它
+                    if (minZ > tileMax[tile])
+                    {
+                        continue;
+                    }
+                    size_t c0 = tx == px0 / occlusion::tileSize ? px0 % occlusion::tileSize : 0;
+                    size_t c1 = tx == px1 / occlusion::tileSize ? px1 % occlusion::tileSize : occlusion::tileSize - 1;
+                    const float *tileDepth = &depthBuffer[tile * occlusion::tilePixels];
+#if defined(GLMCS_HAS_AVX)
+                    int columns = ((1 << (c1 + 1)) - 1) & ~((1 << c0) - 1);
+                    __m256 boxDepth = _mm256_set1_ps(minZ);
+                    for (size_t r = r0; r <= r1; r++)
+                    {
+                        __m256 nearer = _mm256_cmp_ps(boxDepth, _mm256_loadu_ps(tileDepth + r * occlusion::tileSize), _CMP_LE_OQ);
+                        if (_mm256_movemask_ps(nearer) & columns)
+                        {
+                            return true;
+                        }
+                    }
+#else
+                    for (size_t r = r0; r <= r1; r++)
+                    {
+                        for (size_t c = c0; c <= c1; c++)
+                        {
+                            if (minZ <= tileDepth[r * occlusion::tileSize + c])
+                            {
+                                return true;
+                            }
+                        }
+                    }
+#endif
+                }
+            }
+            return false;
+        }
+    };
+} // namespace glmCS
+
+#endif // __CSOCCLUSION_H__
@@ -0,0 +1,302 @@
+/// @ref core
+/// @file csorthonormalize.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Drift detection and re-orthonormalization for rotation matrices.
+/// A matrix that is rotated incrementally every frame (m = rotate(step, m, ...)) picks up rounding error in each
+/// multiply, so its 3x3 part slowly stops being orthonormal and starts to scale and shear the object.
+/// orthonormalDrift() measures this as max(|ci . ci - 1|, |ci . cj|) over the columns: six dot products and no
+/// square root. orthonormalizeMatrices() runs that test on 8 matrices per AVX iteration and only corrects (and
+/// writes back) the matrices whose drift exceeds the tolerance. Translation and the last row are left unchanged.
+///
+/// Two correction methods:
+///   GLMCS_orthonormalize_polar         two Newton-Schulz steps R = R * (3I - R^T R) / 2 toward the closest rotation
+///                                      (polar factor), with no square root or division, spreading the correction over
+///                                      all axes. A drift of 1e-2 drops to float round-off; larger drift (up to ~0.5)
+///                                      converges over repeated passes.
+///   GLMCS_orthonormalize_gram_schmidt  normalize c0, make c1 orthogonal to it, c2 = c0 x c1; works for any
+///                                      linearly independent columns, but keeps the direction of c0
+///
+/// Both remove any scale from the 3x3 part, so apply them only to pure rotation (+ translation) matrices.
+///
+/// if (glmCS::maxOrthonormalDrift(models, count) > 1e-5f) { ... }
+/// size_t fixed = glmCS::orthonormalizeMatrices(models, count, 1e-5f);
+/// model = glmCS::orthonormalize(model, GLMCS_orthonormalize_gram_schmidt);
+///
+
+#ifndef __CSORTHONORMALIZE_H__
+#define __CSORTHONORMALIZE_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <atomic>
+#include "csmatrix_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    enum OrthonormalizeMethod
+    {
+        GLMCS_orthonormalize_polar = 0,
+        GLMCS_orthonormalize_gram_schmidt
+    };
+
+    /// @brief 3x3 部分偏离正交矩阵的程度：max(|ci . ci - 1|, |ci . cj|)，ci 为第 i 列
+    template <typename T>
+    inline T orthonormalDrift(const Matrix<T, 4, 4> &m)
+    {
+        const T(*c)[4] = m.mat;
+        T d[6] = {c[0][0] * c[0][0] + c[0][1] * c[0][1] + c[0][2] * c[0][2] - T(1),
+                  c[1][0] * c[1][0] + c[1][1] * c[1][1] + c[1][2] * c[1][2] - T(1),
+                  c[2][0] * c[2][0] + c[2][1] * c[2][1] + c[2][2] * c[2][2] - T(1),
+                  c[0][0] * c[1][0] + c[0][1] * c[1][1] + c[0][2] * c[1][2],
+                  c[0][0] * c[2][0] + c[0][1] * c[2][1] + c[0][2] * c[2][2],
+                  c[1][0] * c[2][0] + c[1][1] * c[2][1] + c[1][2] * c[2][2]};
+        T drift = T(0);
+        for (size_t i = 0; i < 6; i++)
+        {
+            T a = fabs(d[i]);
+            drift = a > drift ? a : drift;
+        }
+        return drift;
+    }
+
+    /// @brief 重新正交化 3x3 部分，平移与最后一行不变
+    /// @param method GLMCS_orthonormalize_polar（默认）或 GLMCS_orthonormalize_gram_schmidt
+    template <typename T>
+    inline Matrix<T, 4, 4> orthonormalize(const Matrix<T, 4, 4> &m, OrthonormalizeMethod method = GLMCS_orthonormalize_polar)
+    {
+        Matrix<T, 4, 4> result = m;
+        T(*c)[4] = result.mat;
+        if (method == GLMCS_orthonormalize_gram_schmidt)
+        {
+            T inv0 = T(1) / sqrt(c[0][0] * c[0][0] + c[0][1] * c[0][1] + c[0][2] * c[0][2]);
+            for (size_t r = 0; r < 3; r++)
+            {
+                c[0][r] *= inv0;
+            }
+            T d = c[0][0] * c[1][0] + c[0][1] * c[1][1] + c[0][2] * c[1][2];
+            for (size_t r = 0; r < 3; r++)
+            {
+                c[1][r] -= d * c[0][r];
+            }
+            T inv1 = T(1) / sqrt(c[1][0] * c[1][0] + c[1][1] * c[1][1] + c[1][2] * c[1][2]);
+            for (size_t r = 0; r < 3; r++)
+            {
+                c[1][r] *= inv1;
+            }
+            c[2][0] = c[0][1] * c[1][2] - c[0][2] * c[1][1];
+            c[2][1] = c[0][2] * c[1][0] - c[0][0] * c[1][2];
+            c[2][2] = c[0][0] * c[1][1] - c[0][1] * c[1][0];
+            return result;
+        }
+        for (size_t step = 0; step < 2; step++)
+        {
+            // e = R^T R（对称），新的第 j 列 = 1.5 * cj - 0.5 * sum_i e[i][j] * ci
+            T e[3][3];
+            for (size_t i = 0; i < 3; i++)
+            {
+                for (size_t j = i; j < 3; j++)
+                {
+                    e[i][j] = e[j][i] = c[i][0] * c[j][0] + c[i][1] * c[j][1] + c[i][2] * c[j][2];
+                }
+            }
+            T next[3][3];
+            for (size_t j = 0; j < 3; j++)
+            {
+                for (size_t r = 0; r < 3; r++)
+                {
+                    next[j][r] = T(1.5) * c[j][r] - T(0.5) * (e[0][j] * c[0][r] + e[1][j] * c[1][r] + e[2][j] * c[2][r]);
+                }
+            }
+            for (size_t j = 0; j < 3; j++)
+            {
+                for (size_t r = 0; r < 3; r++)
+                {
+                    c[j][r] = next[j][r];
+                }
+            }
+        }
+        return result;
+    }
+
+    namespace orthonormal
+    {
+#if defined(GLMCS_HAS_AVX)
+        // 8 个矩阵的漂移量，soa[c * 4 + r] 为第 c 列第 r 行
+        inline __m256 drift8(const __m256 soa[16])
+        {
+            const __m256 one = _mm256_set1_ps(1.0f), signBit = _mm256_set1_ps(-0.0f);
+            const size_t pairs[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+            __m256 drift = _mm256_setzero_ps();
+            for (size_t p = 0; p < 6; p++)
+            {
+                const __m256 *a = soa + pairs[p][0] * 4, *b = soa + pairs[p][1] * 4;
+                __m256 d = simd::madd(a[2], b[2], simd::madd(a[1], b[1], _mm256_mul_ps(a[0], b[0])));
+                d = p < 3 ? _mm256_sub_ps(d, one) : d;
+                drift = _mm256_max_ps(drift, _mm256_andnot_ps(signBit, d));
+            }
+            return drift;
+        }
+
+        inline void polar8(__m256 soa[16])
+        {
+            const __m256 oneHalf = _mm256_set1_ps(1.5f), half = _mm256_set1_ps(0.5f);
+            for (size_t step = 0; step < 2; step++)
+            {
+                __m256 e[3][3];
+                for (size_t i = 0; i < 3; i++)
+                {
+                    for (size_t j = i; j < 3; j++)
+                    {
+                        const __m256 *a = soa + i * 4, *b = soa + j * 4;
+                        e[i][j] = e[j][i] = simd::madd(a[2], b[2], simd::madd(a[1], b[1], _mm256_mul_ps(a[0], b[0])));
+                    }
+                }
+                __m256 next[3][3];
+                for (size_t j = 0; j < 3; j++)
+                {
+                    for (size_t r = 0; r < 3; r++)
+                    {
+                        __m256 sum = simd::madd(e[2][j], soa[8 + r], simd::madd(e[1][j], soa[4 + r], _mm256_mul_ps(e[0][j], soa[r])));
+                        next[j][r] = _mm256_sub_ps(_mm256_mul_ps(oneHalf, soa[j * 4 + r]), _mm256_mul_ps(half, sum));
+                    }
+                }
+                for (size_t j = 0; j < 3; j++)
+                {
+                    for (size_t r = 0; r < 3; r++)
+                    {
+                        soa[j * 4 + r] = next[j][r];
+                    }
+                }
+            }
+        }
+
+        inline void gramSchmidt8(__m256 soa[16])
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            __m256 *c0 = soa, *c1 = soa + 4, *c2 = soa + 8;
+            __m256 inv0 = _mm256_div_ps(one, _mm256_sqrt_ps(simd::madd(c0[2], c0[2], simd::madd(c0[1], c0[1], _mm256_mul_ps(c0[0], c0[0])))));
+            for (size_t r = 0; r < 3; r++)
+            {
+                c0[r] = _mm256_mul_ps(c0[r], inv0);
+            }
+            __m256 d = simd::madd(c0[2], c1[2], simd::madd(c0[1], c1[1], _mm256_mul_ps(c0[0], c1[0])));
+            for (size_t r = 0; r < 3; r++)
+            {
+                c1[r] = _mm256_sub_ps(c1[r], _mm256_mul_ps(d, c0[r]));
+            }
+            __m256 inv1 = _mm256_div_ps(one, _mm256_sqrt_ps(simd::madd(c1[2], c1[2], simd::madd(c1[1], c1[1], _mm256_mul_ps(c1[0], c1[0])))));
+            for (size_t r = 0; r < 3; r++)
+            {
+                c1[r] = _mm256_mul_ps(c1[r], inv1);
+            }
+            c2[0] = _mm256_sub_ps(_mm256_mul_ps(c0[1], c1[2]), _mm256_mul_ps(c0[2], c1[1]));
+            c2[1] = _mm256_sub_ps(_mm256_mul_ps(c0[2], c1[0]), _mm256_mul_ps(c0[0], c1[2]));
+            c2[2] = _mm256_sub_ps(_mm256_mul_ps(c0[0], c1[1]), _mm256_mul_ps(c0[1], c1[0]));
+        }
+#endif
+
+        inline float maxDriftRange(const Matrix<float, 4, 4> *matrices, size_t begin, size_t end)
+        {
+            float drift = 0.0f;
+            size_t n = begin;
+#if defined(GLMCS_HAS_AVX)
+            __m256 drift8Max = _mm256_setzero_ps();
+            for (; n + 8 <= end; n += 8)
+            {
+                __m256 soa[16];
+                simd::loadMatrices8(valuePtr(matrices[n]), soa);
+                drift8Max = _mm256_max_ps(drift8Max, drift8(soa));
+            }
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, drift8Max);
+            for (size_t i = 0; i < 8; i++)
+            {
+                drift = lanes[i] > drift ? lanes[i] : drift;
+            }
+#endif
+            for (; n < end; n++)
+            {
+                float d = orthonormalDrift(matrices[n]);
+                drift = d > drift ? d : drift;
+            }
+            return drift;
+        }
+
+        inline size_t orthonormalizeRange(Matrix<float, 4, 4> *matrices, size_t begin, size_t end, float tolerance, OrthonormalizeMethod method)
+        {
+            size_t corrected = 0;
+            size_t n = begin;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 limit = _mm256_set1_ps(tolerance);
+            for (; n + 8 <= end; n += 8)
+            {
+                __m256 soa[16];
+                simd::loadMatrices8(valuePtr(matrices[n]), soa);
+                __m256 fix = _mm256_cmp_ps(drift8(soa), limit, _CMP_GT_OQ);
+                int mask = _mm256_movemask_ps(fix);
+                if (mask == 0)
+                {
+                    continue;
+                }
+                __m256 original[12];
+                for (size_t e = 0; e < 12; e++)
+                {
+                    original[e] = soa[e];
+                }
+                if (method == GLMCS_orthonormalize_gram_schmidt)
+                {
+                    gramSchmidt8(soa);
+                }
+                else
+                {
+                    polar8(soa);
+                }
+                // 未超出容差的矩阵保持原值
+                for (size_t e = 0; e < 12; e++)
+                {
+                    soa[e] = _mm256_blendv_ps(original[e], soa[e], fix);
+                }
+                simd::storeMatrices8(valuePtr(matrices[n]), soa);
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    corrected++;
+                }
+            }
+#endif
+            for (; n < end; n++)
+            {
+                if (orthonormalDrift(matrices[n]) > tolerance)
+                {
+                    matrices[n] = orthonormalize(matrices[n], method);
+                    corrected++;
+                }
+            }
+            return corrected;
+        }
+    } // namespace orthonormal
+
+    /// @brief 矩阵数组中最大的漂移量，用于判断是否需要 orthonormalizeMatrices
+    inline float maxOrthonormalDrift(const Matrix<float, 4, 4> *matrices, size_t count)
+    {
+        return orthonormal::maxDriftRange(matrices, 0, count);
+    }
+
+    /// @brief 就地重新正交化漂移量超过 tolerance 的矩阵，其余矩阵不写回
+    /// @param tolerance 漂移量阈值，小于 0 时修正全部矩阵
+    /// @param method GLMCS_orthonormalize_polar（默认）或 GLMCS_orthonormalize_gram_schmidt
+    /// @param threads 线程数，1 表示在调用线程上完成
+    /// @return 被修正的矩阵个数
+    inline size_t orthonormalizeMatrices(Matrix<float, 4, 4> *matrices, size_t count, float tolerance,
+                                         OrthonormalizeMethod method = GLMCS_orthonormalize_polar, unsigned threads = 1)
+    {
+        std::atomic<size_t> corrected(0);
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { corrected += orthonormal::orthonormalizeRange(matrices, begin, end, tolerance, method); }, 8);
+        return corrected.load();
+    }
+} // namespace glmCS
+
+#endif // __CSORTHONORMALIZE_H__
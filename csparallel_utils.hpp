@@ -0,0 +1,113 @@
+/// @ref core
+/// @file csparallel_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Minimal fork-join helpers used by the glmCS batch kernels.
+/// The calling thread always takes part in the work, and threads <= 1 runs everything inline without
+/// creating any std::thread, so single-threaded callers pay nothing.
+///
+/// glmCS::parallelFor(count, 4, [&](size_t begin, size_t end) { kernel(data + begin, end - begin); });
+/// glmCS::parallelForEach(jobs, 4, [&](size_t i) { runJob(i); });
+///
+
+#ifndef __CSPARALLEL_UTILS_H__
+#define __CSPARALLEL_UTILS_H__
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace glmCS
+{
+    // 可用的硬件线程数（至少为 1）
+    inline unsigned hardwareThreads()
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    /// @brief 将 [0, count) 均分为连续的区间并行处理
+    /// @param count 元素总数
+    /// @param threads 线程数（包含调用线程），0 表示使用全部硬件线程
+    /// @param fn 回调 fn(begin, end)
+    /// @param alignment 区间起点按该粒度对齐（例如 SIMD 宽度 8），避免区间边界落在向量中间
+    template <typename F>
+    inline void parallelFor(size_t count, unsigned threads, F &&fn, size_t alignment = 1)
+    {
+        if (threads == 0)
+        {
+            threads = hardwareThreads();
+        }
+        alignment = std::max<size_t>(alignment, 1);
+        size_t blocks = (count + alignment - 1) / alignment;
+        threads = unsigned(std::min<size_t>(threads, blocks));
+        if (threads <= 1)
+        {
+            if (count > 0)
+            {
+                fn(size_t(0), count);
+            }
+            return;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; t++)
+        {
+            size_t begin = std::min(count, (blocks * t / threads) * alignment);
+            size_t end = std::min(count, (blocks * (t + 1) / threads) * alignment);
+            workers.emplace_back([&fn, begin, end]()
+                                 { fn(begin, end); });
+        }
+        fn(size_t(0), std::min(count, (blocks / threads) * alignment));
+        for (size_t t = 0; t < workers.size(); t++)
+        {
+            workers[t].join();
+        }
+    }
+
+    /// @brief 动态分配任务：每个线程从共享计数器领取下一个下标，适合大小不均的任务
+    /// @param count 任务个数
+    /// @param threads 线程数（包含调用线程），0 表示使用全部硬件线程
+    /// @param fn 回调 fn(index)
+    template <typename F>
+    inline void parallelForEach(size_t count, unsigned threads, F &&fn)
+    {
+        if (threads == 0)
+        {
+            threads = hardwareThreads();
+        }
+        threads = unsigned(std::min<size_t>(threads, count));
+        if (threads <= 1)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                fn(i);
+            }
+            return;
+        }
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                fn(i);
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; t++)
+        {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (size_t t = 0; t < workers.size(); t++)
+        {
+            workers[t].join();
+        }
+    }
+} // namespace glmCS
+
+#endif // __CSPARALLEL_UTILS_H__
@@ -0,0 +1,402 @@
+/// @ref core
+/// @file cspicking.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Ray picking for glmCS: mouse rays from view/projection inverses and batched intersection kernels.
+/// pickRay() unprojects an NDC position through an inverse view-projection (or a Projection<float> from
+/// csprojection_utils plus a lookAt view matrix). transformRay() moves a ray into object space without
+/// normalising its direction, so hit distances t stay comparable between spaces and across objects.
+/// Triangles (precomputed edges) and boxes (the AABBArraysSoA of csfrustum_utils) are tested 8 at a time with
+/// AVX: Moller-Trumbore for triangles, the slab test for boxes; other targets use the scalar tests.
+///
+/// glmCS::Ray ray = glmCS::pickRay(projection, view, 2.0f * mouseX / width - 1.0f, 1.0f - 2.0f * mouseY / height);
+/// glmCS::Ray local = glmCS::transformRay(glmCS::inverseAffine(model), ray);
+/// glmCS::RayHit hit;
+/// if (glmCS::intersectRayTriangles(local, mesh.arrays(), mesh.size(), hit.t, &hit)) { ... hit.index ... }
+///
+
+#ifndef __CSPICKING_H__
+#define __CSPICKING_H__
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "csprojection_utils.hpp"
+#include "csfrustum_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    // 射线 origin + t * direction（direction 不要求单位长度）
+    struct Ray
+    {
+        Vector3 origin;
+        Vector3 direction;
+    };
+
+    // 最近的命中结果：重心坐标 (u, v) 对应顶点 v1、v2 的权重
+    struct RayHit
+    {
+        float t = FLT_MAX;
+        float u = 0.0f, v = 0.0f;
+        uint32_t index = 0xFFFFFFFFu; // 未命中
+    };
+
+    // SoA 排列的三角形：顶点 v0 与两条边 e1 = v1 - v0、e2 = v2 - v0
+    struct TriangleArraysSoA
+    {
+        const float *v0x, *v0y, *v0z;
+        const float *e1x, *e1y, *e1z;
+        const float *e2x, *e2y, *e2z;
+    };
+
+    // 持有三角形 SoA 数据，由索引网格构建
+    class TriangleSoABuffer
+    {
+        std::vector<float> data[9];
+        size_t count = 0;
+
+    public:
+        /// @brief 由索引三角形网格构建
+        /// @param positions 顶点位置，每个顶点从 positions + i * stride 开始的 3 个 float
+        /// @param stride 相邻顶点之间的 float 个数（紧密排列时为 3）
+        /// @param indices 三角形索引，每个三角形 3 个
+        /// @param triangleCount 三角形个数
+        void build(const float *positions, size_t stride, const uint32_t *indices, size_t triangleCount)
+        {
+            count = triangleCount;
+            for (size_t c = 0; c < 9; c++)
+            {
+                data[c].resize(triangleCount);
+            }
+            for (size_t i = 0; i < triangleCount; i++)
+            {
+                const float *p0 = positions + indices[i * 3 + 0] * stride;
+                const float *p1 = positions + indices[i * 3 + 1] * stride;
+                const float *p2 = positions + indices[i * 3 + 2] * stride;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    data[c][i] = p0[c];
+                    data[3 + c][i] = p1[c] - p0[c];
+                    data[6 + c][i] = p2[c] - p0[c];
+                }
+            }
+        }
+
+        size_t size() const { return count; }
+
+        TriangleArraysSoA arrays() const
+        {
+            TriangleArraysSoA t = {data[0].data(), data[1].data(), data[2].data(),
+                                   data[3].data(), data[4].data(), data[5].data(),
+                                   data[6].data(), data[7].data(), data[8].data()};
+            return t;
+        }
+    };
+
+    // -------------------------------------------------------------------
+    // 齐次变换后做透视除法
+    inline Vector3 unprojectNDC(const Matrix<float, 4, 4> &inverseViewProjection, float x, float y, float z)
+    {
+        const float(*m)[4] = inverseViewProjection.mat;
+        float r[4];
+        for (size_t j = 0; j < 4; j++)
+        {
+            r[j] = m[0][j] * x + m[1][j] * y + m[2][j] * z + m[3][j];
+        }
+        float invW = 1.0f / r[3];
+        return vec3(r[0] * invW, r[1] * invW, r[2] * invW);
+    }
+
+    /// @brief 由 NDC 坐标生成世界空间的拾取射线，起点位于近平面
+    /// @param inverseViewProjection 观察投影矩阵的逆矩阵
+    /// @param ndcX,ndcY NDC 坐标（[-1,1]，y 向上）
+    /// @param nearDepth 近平面的 NDC 深度：OpenGL 为 -1，[0,1] 深度为 0，反向Z 为 1
+    inline Ray pickRay(const Matrix<float, 4, 4> &inverseViewProjection, float ndcX, float ndcY, float nearDepth = -1.0f)
+    {
+        // 第二个点取近平面与深度范围另一端的中点，对无穷远投影也是有限的
+        float otherEnd = nearDepth > 0.5f ? 0.0f : 1.0f;
+        Ray ray;
+        ray.origin = unprojectNDC(inverseViewProjection, ndcX, ndcY, nearDepth);
+        Vector3 p = unprojectNDC(inverseViewProjection, ndcX, ndcY, 0.5f * (nearDepth + otherEnd));
+        subtract(&ray.direction, &p, &ray.origin);
+        normalize(&ray.direction);
+        return ray;
+    }
+
+    /// @brief 由投影（含逆矩阵）与观察矩阵生成拾取射线，无需通用 4x4 求逆
+    /// @param projection csprojection_utils 中任一投影构造函数的结果
+    /// @param view 观察矩阵（例如 lookAt 的结果）
+    inline Ray pickRay(const Projection<float> &projection, const Matrix<float, 4, 4> &view, float ndcX, float ndcY, float nearDepth = -1.0f)
+    {
+        // GLSL: (P * V)^-1 = V^-1 * P^-1，按本库的存储顺序为 matrixMultiply(P^-1, V^-1)
+        return pickRay(matrixMultiply(projection.inverse, inverseAffine(view).mat), ndcX, ndcY, nearDepth);
+    }
+
+    /// @brief 用矩阵变换射线，例如传入 inverseAffine(model) 将世界空间射线变换到物体空间。
+    /// 方向不重新归一化，因此两个空间中的命中距离 t 相同。
+    inline Ray transformRay(const Matrix<float, 4, 4> &matrix, const Ray &ray)
+    {
+        const float(*m)[4] = matrix.mat;
+        const Vector3 &o = ray.origin, &d = ray.direction;
+        Ray r;
+        r.origin.x = m[0][0] * o.x + m[1][0] * o.y + m[2][0] * o.z + m[3][0];
+        r.origin.y = m[0][1] * o.x + m[1][1] * o.y + m[2][1] * o.z + m[3][1];
+        r.origin.z = m[0][2] * o.x + m[1][2] * o.y + m[2][2] * o.z + m[3][2];
+        r.direction.x = m[0][0] * d.x + m[1][0] * d.y + m[2][0] * d.z;
+        r.direction.y = m[0][1] * d.x + m[1][1] * d.y + m[2][1] * d.z;
+        r.direction.z = m[0][2] * d.x + m[1][2] * d.y + m[2][2] * d.z;
+        return r;
+    }
+
+    // -------------------------------------------------------------------
+    /// @brief 单个射线与三角形求交（Moller-Trumbore，双面）
+    /// @param tMax 只接受 0 <= t < tMax 的命中
+    /// @return 命中时写入 t、u、v
+    inline bool intersectRayTriangle(const Ray &ray, const float v0[3], const float e1[3], const float e2[3], float tMax, float *t, float *u, float *v)
+    {
+        const Vector3 &o = ray.origin, &d = ray.direction;
+        float px = d.y * e2[2] - d.z * e2[1];
+        float py = d.z * e2[0] - d.x * e2[2];
+        float pz = d.x * e2[1] - d.y * e2[0];
+        float det = e1[0] * px + e1[1] * py + e1[2] * pz;
+        if (fabsf(det) < 1e-12f)
+        {
+            return false;
+        }
+        float invDet = 1.0f / det;
+        float sx = o.x - v0[0], sy = o.y - v0[1], sz = o.z - v0[2];
+        float uu = (sx * px + sy * py + sz * pz) * invDet;
+        if (uu < 0.0f || uu > 1.0f)
+        {
+            return false;
+        }
+        float qx = sy * e1[2] - sz * e1[1];
+        float qy = sz * e1[0] - sx * e1[2];
+        float qz = sx * e1[1] - sy * e1[0];
+        float vv = (d.x * qx + d.y * qy + d.z * qz) * invDet;
+        if (vv < 0.0f || uu + vv > 1.0f)
+        {
+            return false;
+        }
+        float tt = (e2[0] * qx + e2[1] * qy + e2[2] * qz) * invDet;
+        if (tt < 0.0f || tt >= tMax)
+        {
+            return false;
+        }
+        *t = tt;
+        *u = uu;
+        *v = vv;
+        return true;
+    }
+
+    /// @brief 射线与三角形数组求最近交点
+    /// @param ray 射线（与三角形处于同一空间）
+    /// @param tris SoA 三角形数组
+    /// @param count 三角形个数
+    /// @param tMax 只接受 t < tMax 的命中（可传入已有的最近距离）
+    /// @param hit 命中时写入最近交点
+    /// @return 是否命中
+    inline bool intersectRayTriangles(const Ray &ray, const TriangleArraysSoA &tris, size_t count, float tMax, RayHit *hit)
+    {
+        float bestT = tMax, bestU = 0.0f, bestV = 0.0f;
+        uint32_t bestIndex = 0xFFFFFFFFu;
+        size_t i = 0;
+#if defined(GLMCS_HAS_AVX)
+        const __m256 ox = _mm256_set1_ps(ray.origin.x), oy = _mm256_set1_ps(ray.origin.y), oz = _mm256_set1_ps(ray.origin.z);
+        const __m256 dx = _mm256_set1_ps(ray.direction.x), dy = _mm256_set1_ps(ray.direction.y), dz = _mm256_set1_ps(ray.direction.z);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), eps = _mm256_set1_ps(1e-12f);
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        __m256 vbestT = _mm256_set1_ps(tMax), vbestU = zero, vbestV = zero;
+        __m256i vbestIndex = _mm256_set1_epi32(-1);
+        __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i eight = _mm256_set1_epi32(8);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 e1x = _mm256_loadu_ps(tris.e1x + i), e1y = _mm256_loadu_ps(tris.e1y + i), e1z = _mm256_loadu_ps(tris.e1z + i);
+            __m256 e2x = _mm256_loadu_ps(tris.e2x + i), e2y = _mm256_loadu_ps(tris.e2y + i), e2z = _mm256_loadu_ps(tris.e2z + i);
+            // p = d x e2, det = e1 . p
+            __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+            __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+            __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+            __m256 det = simd::madd(e1x, px, simd::madd(e1y, py, _mm256_mul_ps(e1z, pz)));
+            __m256 invDet = _mm256_div_ps(one, det);
+            __m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(tris.v0x + i));
+            __m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(tris.v0y + i));
+            __m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(tris.v0z + i));
+            __m256 u = _mm256_mul_ps(simd::madd(sx, px, simd::madd(sy, py, _mm256_mul_ps(sz, pz))), invDet);
+            // q = s x e1
+            __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+            __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+            __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+            __m256 v = _mm256_mul_ps(simd::madd(dx, qx, simd::madd(dy, qy, _mm256_mul_ps(dz, qz))), invDet);
+            __m256 t = _mm256_mul_ps(simd::madd(e2x, qx, simd::madd(e2y, qy, _mm256_mul_ps(e2z, qz))), invDet);
+
+            __m256 ok = _mm256_cmp_ps(_mm256_and_ps(det, absMask), eps, _CMP_GE_OQ);
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(t, vbestT, _CMP_LT_OQ));
+            if (_mm256_movemask_ps(ok) != 0)
+            {
+                vbestT = _mm256_blendv_ps(vbestT, t, ok);
+                vbestU = _mm256_blendv_ps(vbestU, u, ok);
+                vbestV = _mm256_blendv_ps(vbestV, v, ok);
+                vbestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(vbestIndex), _mm256_castsi256_ps(lane), ok));
+            }
+            lane = _mm256_add_epi32(lane, eight);
+        }
+        // 通道间归约
+        alignas(32) float lt[8], lu[8], lv[8];
+        alignas(32) uint32_t li[8];
+        _mm256_store_ps(lt, vbestT);
+        _mm256_store_ps(lu, vbestU);
+        _mm256_store_ps(lv, vbestV);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(li), vbestIndex);
+        for (size_t l = 0; l < 8; l++)
+        {
+            if (li[l] != 0xFFFFFFFFu && lt[l] < bestT)
+            {
+                bestT = lt[l];
+                bestU = lu[l];
+                bestV = lv[l];
+                bestIndex = li[l];
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            const float v0[3] = {tris.v0x[i], tris.v0y[i], tris.v0z[i]};
+            const float e1[3] = {tris.e1x[i], tris.e1y[i], tris.e1z[i]};
+            const float e2[3] = {tris.e2x[i], tris.e2y[i], tris.e2z[i]};
+            float t, u, v;
+            if (intersectRayTriangle(ray, v0, e1, e2, bestT, &t, &u, &v))
+            {
+                bestT = t;
+                bestU = u;
+                bestV = v;
+                bestIndex = uint32_t(i);
+            }
+        }
+        if (bestIndex == 0xFFFFFFFFu)
+        {
+            return false;
+        }
+        hit->t = bestT;
+        hit->u = bestU;
+        hit->v = bestV;
+        hit->index = bestIndex;
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // 方向分量的倒数，分量为 0 时为 +-inf，slab 测试自然退化为单侧比较
+    struct RayInverse
+    {
+        float origin[3];
+        float invDirection[3];
+    };
+
+    inline RayInverse rayInverse(const Ray &ray)
+    {
+        RayInverse r = {{ray.origin.x, ray.origin.y, ray.origin.z},
+                        {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z}};
+        return r;
+    }
+
+    /// @brief 单个射线与包围盒的 slab 测试
+    /// @param tMax 只接受 tNear < tMax 的命中
+    /// @param tNear 命中时写入进入包围盒的距离（起点在盒内时为 0），可为 nullptr
+    inline bool intersectRayAABB(const RayInverse &r, float cx, float cy, float cz, float ex, float ey, float ez, float tMax, float *tNear)
+    {
+        const float c[3] = {cx, cy, cz}, e[3] = {ex, ey, ez};
+        float t0 = 0.0f, t1 = tMax;
+        for (size_t a = 0; a < 3; a++)
+        {
+            float ta = (c[a] - e[a] - r.origin[a]) * r.invDirection[a];
+            float tb = (c[a] + e[a] - r.origin[a]) * r.invDirection[a];
+            t0 = fmaxf(t0, fminf(ta, tb));
+            t1 = fminf(t1, fmaxf(ta, tb));
+        }
+        if (t0 > t1)
+        {
+            return false;
+        }
+        if (tNear)
+        {
+            *tNear = t0;
+        }
+        return true;
+    }
+
+    // 将 [begin, end) 的命中结果写入位掩码，begin 必须是 32 的倍数
+    inline void intersectRayAABBsRange(const RayInverse &r, const AABBArraysSoA &b, size_t begin, size_t end, float tMax, uint32_t *mask, float *tNear)
+    {
+        memset(mask + begin / 32, 0, ((end - begin) + 31) / 32 * sizeof(uint32_t));
+        size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+        __m256 o[3], id[3];
+        for (size_t a = 0; a < 3; a++)
+        {
+            o[a] = _mm256_set1_ps(r.origin[a]);
+            id[a] = _mm256_set1_ps(r.invDirection[a]);
+        }
+        const float *center[3] = {b.centerX, b.centerY, b.centerZ};
+        const float *extent[3] = {b.extentX, b.extentY, b.extentZ};
+        const __m256 vtMax = _mm256_set1_ps(tMax);
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256 t0 = _mm256_setzero_ps(), t1 = vtMax;
+            for (size_t a = 0; a < 3; a++)
+            {
+                __m256 c = _mm256_sub_ps(_mm256_loadu_ps(center[a] + i), o[a]);
+                __m256 e = _mm256_loadu_ps(extent[a] + i);
+                __m256 ta = _mm256_mul_ps(_mm256_sub_ps(c, e), id[a]);
+                __m256 tb = _mm256_mul_ps(_mm256_add_ps(c, e), id[a]);
+                // 0 * inf 产生的 NaN 由 max/min 返回第二个操作数的规则忽略，与标量的 fmaxf/fminf 一致
+                t0 = _mm256_max_ps(_mm256_min_ps(ta, tb), t0);
+                t1 = _mm256_min_ps(_mm256_max_ps(ta, tb), t1);
+            }
+            mask[i / 32] |= uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ))) << (i % 32);
+            if (tNear)
+            {
+                _mm256_storeu_ps(tNear + i, t0);
+            }
+        }
+#endif
+        for (; i < end; i++)
+        {
+            float t;
+            if (intersectRayAABB(r, b.centerX[i], b.centerY[i], b.centerZ[i], b.extentX[i], b.extentY[i], b.extentZ[i], tMax, &t))
+            {
+                mask[i / 32] |= 1u << (i % 32);
+                if (tNear)
+                {
+                    tNear[i] = t;
+                }
+            }
+        }
+    }
+
+    /// @brief 射线与包围盒数组批量求交
+    /// @param ray 射线
+    /// @param boxes SoA 包围盒数组（与视锥体剔除共用）
+    /// @param count 包围盒个数
+    /// @param tMax 只接受 tNear < tMax 的命中
+    /// @param hitMask 输出位掩码，至少 (count + 31) / 32 个 uint32_t
+    /// @param tNear 可选，输出每个包围盒的进入距离（仅命中的元素有效），至少 count 个
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void intersectRayAABBs(const Ray &ray, const AABBArraysSoA &boxes, size_t count, float tMax, uint32_t *hitMask, float *tNear = nullptr, unsigned threads = 1)
+    {
+        RayInverse r = rayInverse(ray);
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { intersectRayAABBsRange(r, boxes, begin, end, tMax, hitMask, tNear); }, 32);
+    }
+} // namespace glmCS
+
+#endif // __CSPICKING_H__
@@ -0,0 +1,184 @@
+/// @ref core
+/// @file csprojection_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Projection matrix variants that return their analytic inverse.
+/// Besides the OpenGL [-1,1] perspective provided by csmatrix_utils, this adds [0,1] depth, reverse-Z,
+/// infinite-far and orthographic projections. Every builder returns Projection<T> holding both the matrix and its
+/// exact inverse, built from the same few terms, so unprojecting (picking, depth reconstruction) never needs a
+/// general 4x4 inverse. Matrices use the same storage as perspective() and can be uploaded unchanged.
+///
+/// glmCS::Projection<float> proj = glmCS::perspectiveInfiniteReverseZ(1.0f, 16.0f / 9.0f, 0.1f);
+/// glUniformMatrix4fv(loc, 1, GL_FALSE, &proj.matrix.mat[0][0]);
+/// glmCS::Vector3T<float> p = glmCS::unprojectPoint(proj, ndcX, ndcY, depth); // 观察空间坐标
+///
+
+#ifndef __CSPROJECTION_UTILS_H__
+#define __CSPROJECTION_UTILS_H__
+
+#include <math.h>
+#include "csmatrix_utils.hpp"
+
+namespace glmCS
+{
+    // 投影矩阵及其逆矩阵
+    template <typename T>
+    struct Projection
+    {
+        Matrix<T, 4, 4> matrix;
+        Matrix<T, 4, 4> inverse;
+    };
+
+    /// @brief 由缩放与深度项构造透视投影及其逆矩阵：
+    /// clip = (sx*x, sy*y, A*z + B, -z)，逆矩阵为 (x/sx, y/sy, -w, z/B + A*w/B)
+    template <typename T>
+    inline Projection<T> perspectiveFromTerms(T sx, T sy, T A, T B)
+    {
+        Projection<T> p;
+        size_t i, j;
+        for (i = 0; i < 4; i++)
+        {
+            for (j = 0; j < 4; j++)
+            {
+                p.matrix.mat[i][j] = T(0);
+                p.inverse.mat[i][j] = T(0);
+            }
+        }
+        p.matrix.mat[0][0] = sx;
+        p.matrix.mat[1][1] = sy;
+        p.matrix.mat[2][2] = A;
+        p.matrix.mat[2][3] = T(-1);
+        p.matrix.mat[3][2] = B;
+
+        T invB = T(1) / B;
+        p.inverse.mat[0][0] = T(1) / sx;
+        p.inverse.mat[1][1] = T(1) / sy;
+        p.inverse.mat[2][3] = invB;
+        p.inverse.mat[3][2] = T(-1);
+        p.inverse.mat[3][3] = A * invB;
+        return p;
+    }
+
+    /// @brief OpenGL 透视投影（深度 [-1,1]），与 perspective() 相同，同时返回逆矩阵
+    /// @param fov 视野角度（弧度）
+    /// @param aspectRatio 纵横比
+    /// @param nearPlane 近平面距离
+    /// @param farPlane 远平面距离
+    template <typename T = float>
+    inline Projection<T> perspectiveWithInverse(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                                typename NonDeduced<T>::type nearPlane, typename NonDeduced<T>::type farPlane)
+    {
+        T f = T(1) / tan(fov * T(0.5));
+        T rangeInv = T(1) / (nearPlane - farPlane);
+        return perspectiveFromTerms<T>(f / aspectRatio, f, (farPlane + nearPlane) * rangeInv, T(2) * farPlane * nearPlane * rangeInv);
+    }
+
+    /// @brief 深度范围为 [0,1] 的透视投影（Vulkan / D3D / glClipControl(GL_ZERO_TO_ONE)），近平面映射到 0
+    template <typename T = float>
+    inline Projection<T> perspectiveZO(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                       typename NonDeduced<T>::type nearPlane, typename NonDeduced<T>::type farPlane)
+    {
+        T f = T(1) / tan(fov * T(0.5));
+        T rangeInv = T(1) / (nearPlane - farPlane);
+        return perspectiveFromTerms<T>(f / aspectRatio, f, farPlane * rangeInv, farPlane * nearPlane * rangeInv);
+    }
+
+    /// @brief 反向Z透视投影（深度 [0,1]，近平面映射到 1、远平面映射到 0），配合浮点深度缓冲与 GL_GREATER 使用
+    template <typename T = float>
+    inline Projection<T> perspectiveReverseZ(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                             typename NonDeduced<T>::type nearPlane, typename NonDeduced<T>::type farPlane)
+    {
+        T f = T(1) / tan(fov * T(0.5));
+        T rangeInv = T(1) / (farPlane - nearPlane);
+        return perspectiveFromTerms<T>(f / aspectRatio, f, nearPlane * rangeInv, farPlane * nearPlane * rangeInv);
+    }
+
+    /// @brief 远平面在无穷远处的 OpenGL 透视投影（深度 [-1,1]）
+    template <typename T = float>
+    inline Projection<T> perspectiveInfinite(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                             typename NonDeduced<T>::type nearPlane)
+    {
+        T f = T(1) / tan(fov * T(0.5));
+        return perspectiveFromTerms<T>(f / aspectRatio, f, T(-1), T(-2) * nearPlane);
+    }
+
+    /// @brief 远平面在无穷远处的反向Z透视投影（深度 [0,1]，近平面为 1，无穷远为 0）
+    template <typename T = float>
+    inline Projection<T> perspectiveInfiniteReverseZ(typename NonDeduced<T>::type fov, typename NonDeduced<T>::type aspectRatio,
+                                                     typename NonDeduced<T>::type nearPlane)
+    {
+        T f = T(1) / tan(fov * T(0.5));
+        return perspectiveFromTerms<T>(f / aspectRatio, f, T(0), nearPlane);
+    }
+
+    /// @brief 正交投影及其逆矩阵
+    /// @param left,right,bottom,top 视景体的左右下上边界
+    /// @param nearPlane,farPlane 近、远平面距离
+    /// @param zeroToOne 深度范围是否为 [0,1]（默认为 OpenGL 的 [-1,1]）
+    template <typename T = float>
+    inline Projection<T> orthographic(typename NonDeduced<T>::type left, typename NonDeduced<T>::type right,
+                                      typename NonDeduced<T>::type bottom, typename NonDeduced<T>::type top,
+                                      typename NonDeduced<T>::type nearPlane, typename NonDeduced<T>::type farPlane,
+                                      bool zeroToOne = false)
+    {
+        Projection<T> p;
+        p.matrix = initIdentityMatrix<T, 4>();
+        p.inverse = initIdentityMatrix<T, 4>();
+        T rl = T(1) / (right - left);
+        T tb = T(1) / (top - bottom);
+        T fn = T(1) / (farPlane - nearPlane);
+        T sx = T(2) * rl, sy = T(2) * tb;
+        T tx = -(right + left) * rl, ty = -(top + bottom) * tb;
+        T sz = zeroToOne ? -fn : T(-2) * fn;
+        T tz = zeroToOne ? -nearPlane * fn : -(farPlane + nearPlane) * fn;
+
+        p.matrix.mat[0][0] = sx;
+        p.matrix.mat[1][1] = sy;
+        p.matrix.mat[2][2] = sz;
+        p.matrix.mat[3][0] = tx;
+        p.matrix.mat[3][1] = ty;
+        p.matrix.mat[3][2] = tz;
+
+        // 逆变换：x = (x_ndc - tx) / sx
+        p.inverse.mat[0][0] = (right - left) * T(0.5);
+        p.inverse.mat[1][1] = (top - bottom) * T(0.5);
+        p.inverse.mat[2][2] = T(1) / sz;
+        p.inverse.mat[3][0] = (right + left) * T(0.5);
+        p.inverse.mat[3][1] = (top + bottom) * T(0.5);
+        p.inverse.mat[3][2] = -tz / sz;
+        return p;
+    }
+
+    /// @brief 用逆投影矩阵将 NDC 坐标还原到观察空间
+    /// @param projection 投影及其逆矩阵
+    /// @param x,y NDC 坐标
+    /// @param z NDC 深度（与所用投影的深度范围一致）
+    /// @return 观察空间坐标
+    template <typename T>
+    inline Vector3T<T> unprojectPoint(const Projection<T> &projection, T x, T y, T z)
+    {
+        const Matrix<T, 4, 4> &m = projection.inverse;
+        T r[4];
+        for (size_t j = 0; j < 4; j++)
+        {
+            r[j] = m.mat[0][j] * x + m.mat[1][j] * y + m.mat[2][j] * z + m.mat[3][j];
+        }
+        T invW = T(1) / r[3];
+        Vector3T<T> v;
+        v.x = r[0] * invW;
+        v.y = r[1] * invW;
+        v.z = r[2] * invW;
+        return v;
+    }
+
+    /// @brief 由 NDC 深度重建观察空间深度（正值，即到相机平面的距离），只用到逆矩阵的 z/w 两项
+    template <typename T>
+    inline T linearizeDepth(const Projection<T> &projection, T z)
+    {
+        const Matrix<T, 4, 4> &m = projection.inverse;
+        return -(m.mat[2][2] * z + m.mat[3][2]) / (m.mat[2][3] * z + m.mat[3][3]);
+    }
+} // namespace glmCS
+
+#endif // __CSPROJECTION_UTILS_H__
@@ -0,0 +1,352 @@
+/// @ref core
+/// @file csquaternion_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Quaternions and dual quaternions for glmCS.
+/// Quaternion<T> is a unit rotation (x, y, z, w) and DualQuaternion<T> a rigid transform (rotation + translation)
+/// in 8 values instead of the 16 of a Matrix<T,4,4>. Both convert to and from the matrices built by
+/// translateMatrix / rotate (scale and shear are not representable and are dropped). Blending dual quaternions
+/// (dual-quaternion linear blending, DLB) keeps the result rigid, so skinning and interpolation do not show the
+/// candy-wrapper collapse of blended matrices.
+///
+/// The product follows the Hamilton convention: (a * b) applies b first, then a. For matrices this means
+/// dualQuaternionFromMatrix(matrixMultiply(m1, m2)) == dualQuaternionFromMatrix(m2) * dualQuaternionFromMatrix(m1).
+///
+/// glmCS::DualQuaternion<float> dq = glmCS::dualQuaternionFromMatrix(boneMatrix);
+/// glmCS::Vector3 p = glmCS::transformPoint(dq, glmCS::vec3(1.0f, 0.0f, 0.0f));
+/// glmCS::DualQuaternion<float> half = glmCS::interpolate(dqA, dqB, 0.5f);
+///
+
+#ifndef __CSQUATERNION_UTILS_H__
+#define __CSQUATERNION_UTILS_H__
+
+#include <math.h>
+#include <stddef.h>
+#include "csmatrix_utils.hpp"
+
+namespace glmCS
+{
+    // 四元数 x*i + y*j + z*k + w
+    template <typename T>
+    struct alignas(sizeof(T) * 4) Quaternion
+    {
+        T x, y, z, w;
+    };
+
+    // 对偶四元数 real + eps * dual：real 为旋转，dual = 0.5 * t * real（t 为平移）
+    template <typename T>
+    struct DualQuaternion
+    {
+        Quaternion<T> real;
+        Quaternion<T> dual;
+    };
+
+    // -------------------------------------------------------------------
+    template <typename T>
+    inline Quaternion<T> quaternion(T x, T y, T z, T w)
+    {
+        Quaternion<T> q;
+        q.x = x;
+        q.y = y;
+        q.z = z;
+        q.w = w;
+        return q;
+    }
+
+    template <typename T>
+    inline Quaternion<T> quaternionIdentity()
+    {
+        return quaternion(T(0), T(0), T(0), T(1));
+    }
+
+    /// @brief 绕任意轴旋转的四元数，角度单位与 rotate() 相同
+    /// @param angle 旋转角度（度）
+    /// @param axis 旋转轴（单位向量）
+    template <typename T>
+    inline Quaternion<T> quaternionFromAxisAngle(typename NonDeduced<T>::type angle, const Vector3T<T> &axis)
+    {
+        T half = angle * T(M_PI) / T(360);
+        T s = sin(half);
+        return quaternion(axis.x * s, axis.y * s, axis.z * s, T(cos(half)));
+    }
+
+    // Hamilton 乘积：先应用 b 再应用 a
+    template <typename T>
+    inline Quaternion<T> operator*(const Quaternion<T> &a, const Quaternion<T> &b)
+    {
+        return quaternion(a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                          a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                          a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                          a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+    }
+
+    template <typename T>
+    inline Quaternion<T> operator*(const Quaternion<T> &q, T s)
+    {
+        return quaternion(q.x * s, q.y * s, q.z * s, q.w * s);
+    }
+
+    template <typename T>
+    inline Quaternion<T> operator+(const Quaternion<T> &a, const Quaternion<T> &b)
+    {
+        return quaternion(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+    }
+
+    template <typename T>
+    inline Quaternion<T> conjugate(const Quaternion<T> &q)
+    {
+        return quaternion(-q.x, -q.y, -q.z, q.w);
+    }
+
+    template <typename T>
+    inline T dot(const Quaternion<T> &a, const Quaternion<T> &b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    // 归一化，长度为 0 时返回单位四元数
+    template <typename T>
+    inline Quaternion<T> normalize(const Quaternion<T> &q)
+    {
+        T len2 = dot(q, q);
+        if (len2 <= T(0))
+        {
+            return quaternionIdentity<T>();
+        }
+        return q * (T(1) / sqrt(len2));
+    }
+
+    /// @brief 四元数转旋转矩阵，布局与 rotate() 相同（mat[i] 为第 i 列）
+    template <typename T>
+    inline Matrix<T, 4, 4> quaternionToMatrix(const Quaternion<T> &q)
+    {
+        Matrix<T, 4, 4> m = initIdentityMatrix<T, 4>();
+        T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        m.mat[0][0] = T(1) - T(2) * (yy + zz);
+        m.mat[0][1] = T(2) * (xy + wz);
+        m.mat[0][2] = T(2) * (xz - wy);
+        m.mat[1][0] = T(2) * (xy - wz);
+        m.mat[1][1] = T(1) - T(2) * (xx + zz);
+        m.mat[1][2] = T(2) * (yz + wx);
+        m.mat[2][0] = T(2) * (xz + wy);
+        m.mat[2][1] = T(2) * (yz - wx);
+        m.mat[2][2] = T(1) - T(2) * (xx + yy);
+        return m;
+    }
+
+    /// @brief 由矩阵的旋转部分（左上 3x3，需为正交矩阵）构造四元数，按最大分量选择分支保证数值稳定
+    template <typename T>
+    inline Quaternion<T> quaternionFromMatrix(const Matrix<T, 4, 4> &m)
+    {
+        // r(row, col) = m.mat[col][row]
+        T r00 = m.mat[0][0], r11 = m.mat[1][1], r22 = m.mat[2][2];
+        T trace = r00 + r11 + r22;
+        Quaternion<T> q;
+        if (trace > T(0))
+        {
+            T s = sqrt(trace + T(1)) * T(2);
+            q.w = T(0.25) * s;
+            q.x = (m.mat[1][2] - m.mat[2][1]) / s;
+            q.y = (m.mat[2][0] - m.mat[0][2]) / s;
+            q.z = (m.mat[0][1] - m.mat[1][0]) / s;
+        }
+        else if (r00 > r11 && r00 > r22)
+        {
+            T s = sqrt(T(1) + r00 - r11 - r22) * T(2);
+            q.w = (m.mat[1][2] - m.mat[2][1]) / s;
+            q.x = T(0.25) * s;
+            q.y = (m.mat[1][0] + m.mat[0][1]) / s;
+            q.z = (m.mat[2][0] + m.mat[0][2]) / s;
+        }
+        else if (r11 > r22)
+        {
+            T s = sqrt(T(1) + r11 - r00 - r22) * T(2);
+            q.w = (m.mat[2][0] - m.mat[0][2]) / s;
+            q.x = (m.mat[1][0] + m.mat[0][1]) / s;
+            q.y = T(0.25) * s;
+            q.z = (m.mat[2][1] + m.mat[1][2]) / s;
+        }
+        else
+        {
+            T s = sqrt(T(1) + r22 - r00 - r11) * T(2);
+            q.w = (m.mat[0][1] - m.mat[1][0]) / s;
+            q.x = (m.mat[2][0] + m.mat[0][2]) / s;
+            q.y = (m.mat[2][1] + m.mat[1][2]) / s;
+            q.z = T(0.25) * s;
+        }
+        return normalize(q);
+    }
+
+    // 用四元数旋转向量：v + 2 * q.xyz x (q.xyz x v + w * v)
+    template <typename T>
+    inline Vector3T<T> rotateVector(const Quaternion<T> &q, const Vector3T<T> &v)
+    {
+        T cx = q.y * v.z - q.z * v.y + q.w * v.x;
+        T cy = q.z * v.x - q.x * v.z + q.w * v.y;
+        T cz = q.x * v.y - q.y * v.x + q.w * v.z;
+        Vector3T<T> r;
+        r.x = v.x + T(2) * (q.y * cz - q.z * cy);
+        r.y = v.y + T(2) * (q.z * cx - q.x * cz);
+        r.z = v.z + T(2) * (q.x * cy - q.y * cx);
+        return r;
+    }
+
+    /// @brief 球面线性插值（最短路径）
+    template <typename T>
+    inline Quaternion<T> slerp(const Quaternion<T> &a, const Quaternion<T> &b, T t)
+    {
+        T c = dot(a, b);
+        Quaternion<T> end = b;
+        if (c < T(0))
+        {
+            c = -c;
+            end = b * T(-1);
+        }
+        // 夹角很小时退化为线性插值
+        if (c > T(0.9995))
+        {
+            return normalize(a * (T(1) - t) + end * t);
+        }
+        T theta = acos(c);
+        T invSin = T(1) / sin(theta);
+        return a * (T(sin((T(1) - t) * theta)) * invSin) + end * (T(sin(t * theta)) * invSin);
+    }
+
+    // -------------------------------------------------------------------
+    template <typename T>
+    inline DualQuaternion<T> dualQuaternionIdentity()
+    {
+        DualQuaternion<T> dq;
+        dq.real = quaternionIdentity<T>();
+        dq.dual = quaternion(T(0), T(0), T(0), T(0));
+        return dq;
+    }
+
+    /// @brief 由旋转与平移构造对偶四元数（先旋转后平移）
+    template <typename T>
+    inline DualQuaternion<T> dualQuaternion(const Quaternion<T> &rotation, T tx, T ty, T tz)
+    {
+        DualQuaternion<T> dq;
+        dq.real = rotation;
+        dq.dual = quaternion(tx, ty, tz, T(0)) * rotation * T(0.5);
+        return dq;
+    }
+
+    /// @brief 由刚体矩阵（旋转 + 平移）构造对偶四元数，缩放与错切会被丢弃
+    template <typename T>
+    inline DualQuaternion<T> dualQuaternionFromMatrix(const Matrix<T, 4, 4> &m)
+    {
+        return dualQuaternion(quaternionFromMatrix(m), m.mat[3][0], m.mat[3][1], m.mat[3][2]);
+    }
+
+    // 平移分量 t = 2 * dual * conjugate(real)
+    template <typename T>
+    inline Vector3T<T> translation(const DualQuaternion<T> &dq)
+    {
+        Quaternion<T> t = dq.dual * conjugate(dq.real);
+        Vector3T<T> r;
+        r.x = T(2) * t.x;
+        r.y = T(2) * t.y;
+        r.z = T(2) * t.z;
+        return r;
+    }
+
+    /// @brief 对偶四元数转刚体矩阵，可直接代替 translateMatrix / rotate 的结果使用
+    template <typename T>
+    inline Matrix<T, 4, 4> dualQuaternionToMatrix(const DualQuaternion<T> &dq)
+    {
+        Matrix<T, 4, 4> m = quaternionToMatrix(dq.real);
+        Vector3T<T> t = translation(dq);
+        m.mat[3][0] = t.x;
+        m.mat[3][1] = t.y;
+        m.mat[3][2] = t.z;
+        return m;
+    }
+
+    // 组合变换：先应用 b 再应用 a
+    template <typename T>
+    inline DualQuaternion<T> operator*(const DualQuaternion<T> &a, const DualQuaternion<T> &b)
+    {
+        DualQuaternion<T> r;
+        r.real = a.real * b.real;
+        r.dual = a.real * b.dual + a.dual * b.real;
+        return r;
+    }
+
+    // 逆变换（单位对偶四元数）
+    template <typename T>
+    inline DualQuaternion<T> conjugate(const DualQuaternion<T> &dq)
+    {
+        DualQuaternion<T> r;
+        r.real = conjugate(dq.real);
+        r.dual = conjugate(dq.dual);
+        return r;
+    }
+
+    // 归一化为单位对偶四元数：除以 |real| 并去掉 dual 中平行于 real 的分量
+    template <typename T>
+    inline DualQuaternion<T> normalize(const DualQuaternion<T> &dq)
+    {
+        T len2 = dot(dq.real, dq.real);
+        if (len2 <= T(0))
+        {
+            return dualQuaternionIdentity<T>();
+        }
+        T inv = T(1) / sqrt(len2);
+        DualQuaternion<T> r;
+        r.real = dq.real * inv;
+        r.dual = dq.dual * inv;
+        r.dual = r.dual + r.real * (-dot(r.real, r.dual));
+        return r;
+    }
+
+    template <typename T>
+    inline Vector3T<T> transformVector(const DualQuaternion<T> &dq, const Vector3T<T> &v)
+    {
+        return rotateVector(dq.real, v);
+    }
+
+    template <typename T>
+    inline Vector3T<T> transformPoint(const DualQuaternion<T> &dq, const Vector3T<T> &p)
+    {
+        Vector3T<T> r = rotateVector(dq.real, p);
+        Vector3T<T> t = translation(dq);
+        r.x += t.x;
+        r.y += t.y;
+        r.z += t.z;
+        return r;
+    }
+
+    /// @brief 对偶四元数线性混合（DLB）：按权重求和后归一化，与第一个元素反向的四元数先取反（最短路径）
+    /// @param dqs 对偶四元数数组
+    /// @param weights 权重数组
+    /// @param count 元素个数
+    template <typename T>
+    inline DualQuaternion<T> blendDualQuaternions(const DualQuaternion<T> *dqs, const T *weights, size_t count)
+    {
+        DualQuaternion<T> sum;
+        sum.real = quaternion(T(0), T(0), T(0), T(0));
+        sum.dual = sum.real;
+        for (size_t i = 0; i < count; i++)
+        {
+            T w = dot(dqs[i].real, dqs[0].real) < T(0) ? -weights[i] : weights[i];
+            sum.real = sum.real + dqs[i].real * w;
+            sum.dual = sum.dual + dqs[i].dual * w;
+        }
+        return normalize(sum);
+    }
+
+    // 两个刚体变换之间插值（DLB），t = 0 返回 a，t = 1 返回 b
+    template <typename T>
+    inline DualQuaternion<T> interpolate(const DualQuaternion<T> &a, const DualQuaternion<T> &b, typename NonDeduced<T>::type t)
+    {
+        DualQuaternion<T> pair[2] = {a, b};
+        T weights[2] = {T(1) - t, t};
+        return blendDualQuaternions(pair, weights, 2);
+    }
+} // namespace glmCS
+
+#endif // __CSQUATERNION_UTILS_H__
@@ -0,0 +1,289 @@
+/// @ref core
+/// @file csshadow_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Batch view matrices for shadow rendering: many lookAt matrices at once, point-light cubemap faces and
+/// cascaded shadow map fitting.
+/// buildLookAtMatrices() builds the same matrices as lookAt() from SoA eye / target / up arrays, 8 per AVX iteration
+/// (3 square roots per lane, no Vector3 pointer round trips). The result is transposed back to packed column-major
+/// matrices on the store. Degenerate input (eye == target, up parallel to the view direction) is not checked and
+/// gives NaN.
+/// buildCubemapViews() writes the 6 face views of each point light in the GL cubemap face order (+X, -X, +Y, -Y,
+/// +Z, -Z). The face rotations are constant, so each matrix is a fixed rotation plus one translation, written
+/// without any lookAt math. Pair them with perspectiveWithInverse(pi / 2, 1, near, far).
+/// Cascades: cascadeSplitDistances() blends logarithmic and uniform splits (the "practical" split scheme).
+/// fitShadowCascade() encloses each camera frustum slice in a bounding sphere, which does not change when the
+/// camera rotates, and fits an orthographic projection around it in light space. The light-space origin of that
+/// projection snaps to whole shadow-map texels, so static shadows do not shimmer when the camera moves.
+///
+/// glmCS::LookAtArraysSoA spots = {ex, ey, ez, tx, ty, tz, ux, uy, uz};
+/// glmCS::buildLookAtMatrices(spots, spotCount, spotViews, 4);
+/// glmCS::buildCubemapViews(px, py, pz, pointLightCount, cubeViews);             // 6 * pointLightCount 个矩阵
+/// glmCS::ShadowCascade cascades[4];
+/// glmCS::buildShadowCascades(camera, sunDirection, 4, 200.0f, 0.75f, 2048.0f, cascades);
+///
+
+#ifndef __CSSHADOW_UTILS_H__
+#define __CSSHADOW_UTILS_H__
+
+#include <math.h>
+#include <stddef.h>
+#include "csmatrix_utils.hpp"
+#include "csprojection_utils.hpp"
+#include "cscamera.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    // SoA 排列的 lookAt 参数
+    struct LookAtArraysSoA
+    {
+        const float *eyeX, *eyeY, *eyeZ;
+        const float *targetX, *targetY, *targetZ;
+        const float *upX, *upY, *upZ;
+    };
+
+    // 一级阴影级联：光源观察矩阵、正交投影（含逆矩阵）与二者的乘积
+    struct ShadowCascade
+    {
+        Matrix<float, 4, 4> view;
+        Projection<float> projection;
+        Matrix<float, 4, 4> viewProjection; // matrixMultiply(view, projection.matrix)
+        float splitNear, splitFar;          // 覆盖的相机观察距离区间
+    };
+
+    namespace shadow
+    {
+        // 与 lookAt() 相同的计算：f = normalize(target - eye)，r = normalize(f x up)，u = r x f
+        inline void lookAtOne(const LookAtArraysSoA &in, size_t i, float *dst)
+        {
+            float ex = in.eyeX[i], ey = in.eyeY[i], ez = in.eyeZ[i];
+            float fx = in.targetX[i] - ex, fy = in.targetY[i] - ey, fz = in.targetZ[i] - ez;
+            float invF = 1.0f / sqrtf(fx * fx + fy * fy + fz * fz);
+            fx *= invF;
+            fy *= invF;
+            fz *= invF;
+            float ux = in.upX[i], uy = in.upY[i], uz = in.upZ[i];
+            float rx = fy * uz - fz * uy, ry = fz * ux - fx * uz, rz = fx * uy - fy * ux;
+            float invR = 1.0f / sqrtf(rx * rx + ry * ry + rz * rz);
+            rx *= invR;
+            ry *= invR;
+            rz *= invR;
+            float vx = ry * fz - rz * fy, vy = rz * fx - rx * fz, vz = rx * fy - ry * fx;
+            float invV = 1.0f / sqrtf(vx * vx + vy * vy + vz * vz);
+            vx *= invV;
+            vy *= invV;
+            vz *= invV;
+            const float m[16] = {rx, vx, -fx, 0.0f,
+                                 ry, vy, -fy, 0.0f,
+                                 rz, vz, -fz, 0.0f,
+                                 -(rx * ex + ry * ey + rz * ez), -(vx * ex + vy * ey + vz * ez), fx * ex + fy * ey + fz * ez, 1.0f};
+            for (size_t k = 0; k < 16; k++)
+            {
+                dst[k] = m[k];
+            }
+        }
+
+        inline void buildLookAtRange(const LookAtArraysSoA &in, size_t begin, size_t end, float *out)
+        {
+            size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), signBit = _mm256_set1_ps(-0.0f);
+            for (; i + 8 <= end; i += 8)
+            {
+                __m256 ex = _mm256_loadu_ps(in.eyeX + i), ey = _mm256_loadu_ps(in.eyeY + i), ez = _mm256_loadu_ps(in.eyeZ + i);
+                __m256 fx = _mm256_sub_ps(_mm256_loadu_ps(in.targetX + i), ex);
+                __m256 fy = _mm256_sub_ps(_mm256_loadu_ps(in.targetY + i), ey);
+                __m256 fz = _mm256_sub_ps(_mm256_loadu_ps(in.targetZ + i), ez);
+                __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(simd::madd(fz, fz, simd::madd(fy, fy, _mm256_mul_ps(fx, fx)))));
+                fx = _mm256_mul_ps(fx, inv);
+                fy = _mm256_mul_ps(fy, inv);
+                fz = _mm256_mul_ps(fz, inv);
+                __m256 ux = _mm256_loadu_ps(in.upX + i), uy = _mm256_loadu_ps(in.upY + i), uz = _mm256_loadu_ps(in.upZ + i);
+                __m256 rx = _mm256_sub_ps(_mm256_mul_ps(fy, uz), _mm256_mul_ps(fz, uy));
+                __m256 ry = _mm256_sub_ps(_mm256_mul_ps(fz, ux), _mm256_mul_ps(fx, uz));
+                __m256 rz = _mm256_sub_ps(_mm256_mul_ps(fx, uy), _mm256_mul_ps(fy, ux));
+                inv = _mm256_div_ps(one, _mm256_sqrt_ps(simd::madd(rz, rz, simd::madd(ry, ry, _mm256_mul_ps(rx, rx)))));
+                rx = _mm256_mul_ps(rx, inv);
+                ry = _mm256_mul_ps(ry, inv);
+                rz = _mm256_mul_ps(rz, inv);
+                __m256 vx = _mm256_sub_ps(_mm256_mul_ps(ry, fz), _mm256_mul_ps(rz, fy));
+                __m256 vy = _mm256_sub_ps(_mm256_mul_ps(rz, fx), _mm256_mul_ps(rx, fz));
+                __m256 vz = _mm256_sub_ps(_mm256_mul_ps(rx, fy), _mm256_mul_ps(ry, fx));
+                inv = _mm256_div_ps(one, _mm256_sqrt_ps(simd::madd(vz, vz, simd::madd(vy, vy, _mm256_mul_ps(vx, vx)))));
+                vx = _mm256_mul_ps(vx, inv);
+                vy = _mm256_mul_ps(vy, inv);
+                vz = _mm256_mul_ps(vz, inv);
+                __m256 soa[16] = {rx, vx, _mm256_xor_ps(fx, signBit), zero,
+                                  ry, vy, _mm256_xor_ps(fy, signBit), zero,
+                                  rz, vz, _mm256_xor_ps(fz, signBit), zero,
+                                  _mm256_xor_ps(simd::madd(rz, ez, simd::madd(ry, ey, _mm256_mul_ps(rx, ex))), signBit),
+                                  _mm256_xor_ps(simd::madd(vz, ez, simd::madd(vy, ey, _mm256_mul_ps(vx, ex))), signBit),
+                                  simd::madd(fz, ez, simd::madd(fy, ey, _mm256_mul_ps(fx, ex))),
+                                  one};
+                simd::storeMatrices8(out + i * 16, soa);
+            }
+#endif
+            for (; i < end; i++)
+            {
+                lookAtOne(in, i, out + i * 16);
+            }
+        }
+
+        // 立方体贴图 6 个面的旋转（GL 面顺序），rotation[face][c][r] 为观察矩阵第 c 列第 r 行
+        inline const float (*cubemapRotations())[3][3]
+        {
+            // 各面的 (right, up, -forward) 按行排列后存入列：与 lookAt(p, p + dir, up) 相同
+            static const float rotations[6][3][3] = {
+                {{0, 0, -1}, {0, -1, 0}, {-1, 0, 0}}, // +X：dir (1,0,0)，up (0,-1,0)
+                {{0, 0, 1}, {0, -1, 0}, {1, 0, 0}},   // -X：dir (-1,0,0)，up (0,-1,0)
+                {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},   // +Y：dir (0,1,0)，up (0,0,1)
+                {{1, 0, 0}, {0, 0, 1}, {0, -1, 0}},   // -Y：dir (0,-1,0)，up (0,0,-1)
+                {{1, 0, 0}, {0, -1, 0}, {0, 0, -1}},  // +Z：dir (0,0,1)，up (0,-1,0)
+                {{-1, 0, 0}, {0, -1, 0}, {0, 0, 1}}}; // -Z：dir (0,0,-1)，up (0,-1,0)
+            return rotations;
+        }
+    } // namespace shadow
+
+    /// @brief 批量构建观察矩阵，结果与逐个调用 lookAt() 相同
+    /// @param in SoA 的 eye / target / up
+    /// @param count 矩阵个数
+    /// @param out 输出，count * 16 个 float，与 Matrix<float,4,4> 的存储相同
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void buildLookAtMatrices(const LookAtArraysSoA &in, size_t count, float *out, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { shadow::buildLookAtRange(in, begin, end, out); }, 8);
+    }
+
+    // 输出为矩阵数组的重载
+    inline void buildLookAtMatrices(const LookAtArraysSoA &in, size_t count, Matrix<float, 4, 4> *out, unsigned threads = 1)
+    {
+        buildLookAtMatrices(in, count, reinterpret_cast<float *>(out), threads);
+    }
+
+    /// @brief 点光源立方体阴影贴图的 6 个观察矩阵
+    /// @param positionX,positionY,positionZ 光源位置（SoA）
+    /// @param count 光源个数
+    /// @param out 输出，count * 6 个矩阵，第 i 个光源的第 face 面位于 out[i * 6 + face]（GL 面顺序 +X -X +Y -Y +Z -Z）
+    inline void buildCubemapViews(const float *positionX, const float *positionY, const float *positionZ, size_t count, Matrix<float, 4, 4> *out)
+    {
+        const float(*rotations)[3][3] = shadow::cubemapRotations();
+        for (size_t i = 0; i < count; i++)
+        {
+            const float p[3] = {positionX[i], positionY[i], positionZ[i]};
+            for (size_t face = 0; face < 6; face++)
+            {
+                const float(*rot)[3] = rotations[face];
+                float(*m)[4] = out[i * 6 + face].mat;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    m[c][0] = rot[c][0];
+                    m[c][1] = rot[c][1];
+                    m[c][2] = rot[c][2];
+                    m[c][3] = 0.0f;
+                }
+                // 平移 = -R * p
+                for (size_t r = 0; r < 3; r++)
+                {
+                    m[3][r] = -(rot[0][r] * p[0] + rot[1][r] * p[1] + rot[2][r] * p[2]);
+                }
+                m[3][3] = 1.0f;
+            }
+        }
+    }
+
+    /// @brief 级联分割距离：lambda * 对数分割 + (1 - lambda) * 均匀分割
+    /// @param nearPlane,farPlane 阴影覆盖的观察距离范围
+    /// @param cascadeCount 级联数
+    /// @param lambda 0 为均匀分割，1 为对数分割，常用 0.5 ~ 0.8
+    /// @param splits 输出 cascadeCount + 1 个距离，splits[0] = nearPlane，splits[cascadeCount] = farPlane
+    inline void cascadeSplitDistances(float nearPlane, float farPlane, size_t cascadeCount, float lambda, float *splits)
+    {
+        splits[0] = nearPlane;
+        for (size_t i = 1; i < cascadeCount; i++)
+        {
+            float t = float(i) / float(cascadeCount);
+            float logSplit = nearPlane * powf(farPlane / nearPlane, t);
+            float uniformSplit = nearPlane + (farPlane - nearPlane) * t;
+            splits[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+        }
+        splits[cascadeCount] = farPlane;
+    }
+
+    /// @brief 用正交投影包住相机视锥体在 [splitNear, splitFar] 之间的切片
+    /// @param cameraWorld 相机的世界矩阵（观察矩阵的逆，Camera::inverseView()）
+    /// @param fov,aspectRatio 相机的垂直视野（弧度）与纵横比
+    /// @param lightDirection 光线方向（从光源指向场景），无需归一化
+    /// @param resolution 阴影贴图边长（像素，大于 2），用于按纹素对齐；四周各留一个纹素的余量
+    /// @param casterDistance 向光源方向额外延伸的深度，包含切片外的投影物体
+    /// @param zeroToOneDepth 正交投影的深度范围是否为 [0,1]
+    inline ShadowCascade fitShadowCascade(const Matrix<float, 4, 4> &cameraWorld, float fov, float aspectRatio, const Vector3 &lightDirection,
+                                          float splitNear, float splitFar, float resolution, float casterDistance = 0.0f, bool zeroToOneDepth = false)
+    {
+        // 切片的包围球：球心在视线上，与近、远平面的角点等距（相机旋转时不变）
+        float tanHalf = tanf(fov * 0.5f);
+        float k2 = tanHalf * tanHalf * (1.0f + aspectRatio * aspectRatio);
+        float centerDistance = 0.5f * (splitNear + splitFar) * (1.0f + k2);
+        float radius;
+        if (centerDistance >= splitFar)
+        {
+            centerDistance = splitFar;
+            radius = splitFar * sqrtf(k2);
+        }
+        else
+        {
+            float d = splitFar - centerDistance;
+            radius = sqrtf(d * d + splitFar * splitFar * k2);
+        }
+        // 半径取整到 1/16，避免浮点抖动改变投影大小
+        radius = ceilf(radius * 16.0f) / 16.0f;
+        const float(*w)[4] = cameraWorld.mat;
+        Vector3 center = vec3(w[3][0] - w[2][0] * centerDistance, w[3][1] - w[2][1] * centerDistance, w[3][2] - w[2][2] * centerDistance);
+
+        // 仅含旋转的光源观察矩阵（所有级联共用）
+        Vector3 up = fabsf(lightDirection.y) > 0.99f * sqrtf(dot(&lightDirection, &lightDirection)) ? vec3(0.0f, 0.0f, 1.0f) : vec3(0.0f, 1.0f, 0.0f);
+        ShadowCascade cascade;
+        cascade.view = lookAt(vec3(0.0f, 0.0f, 0.0f), lightDirection, up);
+        const float(*v)[4] = cascade.view.mat;
+        float cx = v[0][0] * center.x + v[1][0] * center.y + v[2][0] * center.z;
+        float cy = v[0][1] * center.x + v[1][1] * center.y + v[2][1] * center.z;
+        float cz = v[0][2] * center.x + v[1][2] * center.y + v[2][2] * center.z;
+        // 光源空间的投影中心按纹素对齐：对齐最多使中心移动一个纹素，窗口半宽取 radius + texel 使包围球始终在窗口内，
+        // 即 2 * (radius + texel) = resolution * texel
+        float texel = 2.0f * radius / (resolution - 2.0f);
+        float extent = radius + texel;
+        cx = floorf(cx / texel) * texel;
+        cy = floorf(cy / texel) * texel;
+        // 光源沿 -z 观察：深度 = -z
+        cascade.projection = orthographic<float>(cx - extent, cx + extent, cy - extent, cy + extent,
+                                                 -cz - radius - casterDistance, -cz + radius, zeroToOneDepth);
+        cascade.viewProjection = matrixMultiply(cascade.view, cascade.projection.matrix.mat);
+        cascade.splitNear = splitNear;
+        cascade.splitFar = splitFar;
+        return cascade;
+    }
+
+    /// @brief 为相机构建 cascadeCount 级阴影级联
+    /// @param shadowDistance 阴影覆盖的最远距离（与相机远平面取较小者，支持无穷远投影）
+    /// @param lambda 分割方式，见 cascadeSplitDistances
+    /// @param cascadeCount 级联数，最多 64
+    /// @param cascades 输出 cascadeCount 个级联
+    inline void buildShadowCascades(const Camera &camera, const Vector3 &lightDirection, size_t cascadeCount, float shadowDistance, float lambda,
+                                    float resolution, ShadowCascade *cascades, float casterDistance = 0.0f)
+    {
+        float farPlane = camera.farPlane() < shadowDistance ? camera.farPlane() : shadowDistance;
+        float splits[65];
+        cascadeCount = cascadeCount < 64 ? cascadeCount : 64;
+        cascadeSplitDistances(camera.nearPlane(), farPlane, cascadeCount, lambda, splits);
+        bool zeroToOne = camera.depthMode() != GLMCS_depth_negative_one_to_one;
+        for (size_t i = 0; i < cascadeCount; i++)
+        {
+            cascades[i] = fitShadowCascade(camera.inverseView(), camera.fov(), camera.aspectRatio(), lightDirection,
+                                           splits[i], splits[i + 1], resolution, casterDistance, zeroToOne);
+        }
+    }
+} // namespace glmCS
+
+#endif // __CSSHADOW_UTILS_H__
@@ -0,0 +1,179 @@
+/// @ref core
+/// @file cssimd_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief SIMD configuration shared by the glmCS headers.
+/// Detects the instruction sets enabled by the compiler flags (-msse2 / -mavx / -mavx2 -mfma / NEON) and
+/// exposes them as GLMCS_HAS_* macros, plus a few register helpers. Every SIMD path in glmCS has a scalar
+/// fallback, so the headers also compile for targets without any of these.
+///
+/// Define GLMCS_FORCE_SCALAR before including any glmCS header to disable all SIMD paths.
+///
+
+#ifndef __CSSIMD_UTILS_H__
+#define __CSSIMD_UTILS_H__
+
+#if !defined(GLMCS_FORCE_SCALAR)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLMCS_HAS_SSE2 1
+#endif
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define GLMCS_HAS_SSE41 1
+#endif
+#if defined(__AVX__)
+#define GLMCS_HAS_AVX 1
+#endif
+#if defined(__AVX2__)
+#define GLMCS_HAS_AVX2 1
+#endif
+#if defined(__FMA__)
+#define GLMCS_HAS_FMA 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GLMCS_HAS_NEON 1
+#endif
+#endif // GLMCS_FORCE_SCALAR
+
+#if defined(GLMCS_HAS_AVX)
+#include <immintrin.h>
+#elif defined(GLMCS_HAS_SSE41)
+#include <smmintrin.h>
+#elif defined(GLMCS_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(GLMCS_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace glmCS
+{
+    namespace simd
+    {
+#if defined(GLMCS_HAS_SSE2)
+        // a * b + c
+        inline __m128 madd(__m128 a, __m128 b, __m128 c)
+        {
+#if defined(GLMCS_HAS_FMA)
+            return _mm_fmadd_ps(a, b, c);
+#else
+            return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+        }
+#endif
+
+#if defined(GLMCS_HAS_AVX)
+        inline __m256 madd(__m256 a, __m256 b, __m256 c)
+        {
+#if defined(GLMCS_HAS_FMA)
+            return _mm256_fmadd_ps(a, b, c);
+#else
+            return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+        }
+
+        inline __m256d madd(__m256d a, __m256d b, __m256d c)
+        {
+#if defined(GLMCS_HAS_FMA)
+            return _mm256_fmadd_pd(a, b, c);
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+        }
+
+        // 两个 128 位通道内分别做 4x4 转置
+        inline void transpose4x4Lanes(__m256 &r0, __m256 &r1, __m256 &r2, __m256 &r3)
+        {
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        // 8x8 转置：r[i] 的第 j 个元素与 r[j] 的第 i 个元素互换
+        inline void transpose8x8(__m256 r[8])
+        {
+            __m256 t[8];
+            for (size_t i = 0; i < 8; i += 2)
+            {
+                t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+                t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+            }
+            __m256 u[8];
+            for (size_t i = 0; i < 8; i += 4)
+            {
+                u[i + 0] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+                u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+                u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+                u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+            }
+            for (size_t i = 0; i < 4; i++)
+            {
+                r[i] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x20);
+                r[i + 4] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x31);
+            }
+        }
+
+        /// @brief 读取 8 个连续的 4x4 矩阵并转置为 SoA：soa[e] 为 8 个矩阵的第 e 个元素。
+        /// 矩阵 m 与 m+4 的同一组 4 个元素拼入一个寄存器（插入式读取不占用 shuffle 端口），再做通道内 4x4 转置，
+        /// 比完整的 8x8 转置少三分之一的 shuffle。
+        inline void loadMatrices8(const float *src, __m256 soa[16])
+        {
+            for (size_t base = 0; base < 16; base += 4)
+            {
+                __m256 r[4];
+                for (size_t m = 0; m < 4; m++)
+                {
+                    r[m] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + m * 16 + base)), _mm_loadu_ps(src + (m + 4) * 16 + base), 1);
+                }
+                transpose4x4Lanes(r[0], r[1], r[2], r[3]);
+                soa[base + 0] = r[0];
+                soa[base + 1] = r[1];
+                soa[base + 2] = r[2];
+                soa[base + 3] = r[3];
+            }
+        }
+
+        // 将 SoA 的 8 个 4x4 矩阵转置回 AoS 并写入 dst（soa 会被修改），每个 128 位通道直接写到对应矩阵
+        inline void storeMatrices8(float *dst, __m256 soa[16])
+        {
+            for (size_t base = 0; base < 16; base += 4)
+            {
+                transpose4x4Lanes(soa[base + 0], soa[base + 1], soa[base + 2], soa[base + 3]);
+                for (size_t m = 0; m < 4; m++)
+                {
+                    _mm_storeu_ps(dst + m * 16 + base, _mm256_castps256_ps128(soa[base + m]));
+                    _mm_storeu_ps(dst + (m + 4) * 16 + base, _mm256_extractf128_ps(soa[base + m], 1));
+                }
+            }
+        }
+
+        // 同 storeMatrices8，用于每个矩阵 12 个元素的 3x4 矩阵
+        inline void storeMatrices3x4x8(float *dst, __m256 soa[12])
+        {
+            for (size_t base = 0; base < 12; base += 4)
+            {
+                transpose4x4Lanes(soa[base + 0], soa[base + 1], soa[base + 2], soa[base + 3]);
+                for (size_t m = 0; m < 4; m++)
+                {
+                    _mm_storeu_ps(dst + m * 12 + base, _mm256_castps256_ps128(soa[base + m]));
+                    _mm_storeu_ps(dst + (m + 4) * 12 + base, _mm256_extractf128_ps(soa[base + m], 1));
+                }
+            }
+        }
+#endif
+
+#if defined(GLMCS_HAS_NEON)
+        inline float32x4_t madd(float32x4_t a, float32x4_t b, float32x4_t c)
+        {
+            return vmlaq_f32(c, a, b);
+        }
+#endif
+    } // namespace simd
+} // namespace glmCS
+
+#endif // __CSSIMD_UTILS_H__
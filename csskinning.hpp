@@ -0,0 +1,372 @@
+/// @ref core
+/// @file csskinning.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Linear-blend skinning (LBS) on the CPU, for devices without GPU skinning.
+/// Consumes an interleaved vertex stream (position, normal, 4 weights, 4 bone indices) and a matrix palette built
+/// by csmatrix_palette.hpp (16 floats per bone, column-major). Per vertex, the 4 referenced palette matrices are
+/// fetched as rows, blended by weight and applied to the position and normal. With AVX the blended matrix is kept
+/// as two 256-bit registers and the result (position + normal, 32 bytes) is written with one non-temporal store,
+/// so the output stream does not evict the palette from the cache. Large meshes can be split across threads.
+/// skinVerticesDQ does the same with a dual-quaternion palette (8 floats per bone instead of 16), which keeps the
+/// blended transform rigid and avoids the volume loss of linear blending at twisting joints.
+///
+/// std::vector<glmCS::SkinnedVertex> out(vertexCount);
+/// glmCS::buildMatrixPalette(inverseBind.data(), pose.data(), boneCount, palette.data());
+/// glmCS::skinVertices(vertices.data(), vertexCount, palette.data(), out.data(), 4);
+///
+/// glmCS::buildDualQuaternionPalette(inverseBindDQ.data(), poseDQ.data(), boneCount, dqPalette.data());
+/// glmCS::skinVerticesDQ(vertices.data(), vertexCount, dqPalette.data(), out.data(), 4);
+///
+
+#ifndef __CSSKINNING_H__
+#define __CSSKINNING_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "csmatrix_utils.hpp"
+#include "csparallel_utils.hpp"
+#include "csquaternion_utils.hpp"
+
+namespace glmCS
+{
+    // 蒙皮输入顶点：未使用的影响骨骼权重置 0（索引仍需有效，通常为 0）
+    struct SkinVertex
+    {
+        float position[3];
+        float normal[3];
+        float weights[4];
+        uint16_t indices[4];
+    };
+
+    // 蒙皮输出顶点：normal.w = 0；position.w 在线性混合蒙皮中为权重之和（权重归一化时为 1，
+    // 未归一化时 xyz 同比缩放，透视除法后位置仍正确），对偶四元数蒙皮固定为 1。32 字节对齐可直接作为顶点缓冲上传
+    struct alignas(32) SkinnedVertex
+    {
+        float position[4];
+        float normal[4];
+    };
+
+    /// @brief 对 [begin, end) 范围内的顶点做线性混合蒙皮
+    /// @param vertices 输入顶点
+    /// @param palette 矩阵调色板，每个骨骼 16 个 float（buildMatrixPalette 的输出）
+    /// @param out 输出顶点；按 32 字节对齐时使用非临时写入
+    /// @note 法线直接用混合矩阵变换且不做归一化，适用于旋转与均匀缩放
+    inline void skinVerticesRange(const SkinVertex *vertices, size_t begin, size_t end, const float *palette, SkinnedVertex *out)
+    {
+        size_t n = begin;
+#if defined(GLMCS_HAS_AVX)
+        const bool stream = (reinterpret_cast<uintptr_t>(out) & 31) == 0;
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i lo = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        const __m256i hi = _mm256_set1_epi32(2);
+        for (; n < end; n++)
+        {
+            const SkinVertex &v = vertices[n];
+            // 两个寄存器保存混合矩阵：m01 = [mat[0] | mat[1]]，m23 = [mat[2] | mat[3]]
+            const float *p0 = palette + size_t(v.indices[0]) * 16;
+            const float *p1 = palette + size_t(v.indices[1]) * 16;
+            const float *p2 = palette + size_t(v.indices[2]) * 16;
+            const float *p3 = palette + size_t(v.indices[3]) * 16;
+            __m256 w = _mm256_broadcast_ss(&v.weights[0]);
+            __m256 m01 = _mm256_mul_ps(w, _mm256_loadu_ps(p0));
+            __m256 m23 = _mm256_mul_ps(w, _mm256_loadu_ps(p0 + 8));
+            w = _mm256_broadcast_ss(&v.weights[1]);
+            m01 = simd::madd(w, _mm256_loadu_ps(p1), m01);
+            m23 = simd::madd(w, _mm256_loadu_ps(p1 + 8), m23);
+            w = _mm256_broadcast_ss(&v.weights[2]);
+            m01 = simd::madd(w, _mm256_loadu_ps(p2), m01);
+            m23 = simd::madd(w, _mm256_loadu_ps(p2 + 8), m23);
+            w = _mm256_broadcast_ss(&v.weights[3]);
+            m01 = simd::madd(w, _mm256_loadu_ps(p3), m01);
+            m23 = simd::madd(w, _mm256_loadu_ps(p3 + 8), m23);
+
+            // [x|y] 与 [z|1]、[z|0]：两半分别乘 mat[0]/mat[1]、mat[2]/mat[3]，再把高低两半相加
+            __m256 pos = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(v.position));
+            __m256 nrm = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(v.normal));
+            __m256 tp = _mm256_mul_ps(m01, _mm256_permutevar_ps(pos, lo));
+            tp = simd::madd(m23, _mm256_blend_ps(_mm256_permutevar_ps(pos, hi), one, 0xF0), tp);
+            __m256 tn = _mm256_mul_ps(m01, _mm256_permutevar_ps(nrm, lo));
+            tn = simd::madd(_mm256_blend_ps(m23, _mm256_setzero_ps(), 0xF0), _mm256_permutevar_ps(nrm, hi), tn);
+            __m256 r = _mm256_add_ps(_mm256_permute2f128_ps(tp, tn, 0x20), _mm256_permute2f128_ps(tp, tn, 0x31));
+            if (stream)
+            {
+                _mm256_stream_ps(out[n].position, r);
+            }
+            else
+            {
+                _mm256_storeu_ps(out[n].position, r);
+            }
+        }
+        if (stream)
+        {
+            _mm_sfence();
+        }
+#elif defined(GLMCS_HAS_SSE2)
+        const bool stream = (reinterpret_cast<uintptr_t>(out) & 15) == 0;
+        for (; n < end; n++)
+        {
+            const SkinVertex &v = vertices[n];
+            __m128 m[4];
+            for (size_t i = 0; i < 4; i++)
+            {
+                m[i] = _mm_setzero_ps();
+            }
+            for (size_t k = 0; k < 4; k++)
+            {
+                const float *p = palette + size_t(v.indices[k]) * 16;
+                __m128 w = _mm_set1_ps(v.weights[k]);
+                for (size_t i = 0; i < 4; i++)
+                {
+                    m[i] = simd::madd(w, _mm_loadu_ps(p + i * 4), m[i]);
+                }
+            }
+            __m128 pos = simd::madd(m[0], _mm_set1_ps(v.position[0]), m[3]);
+            pos = simd::madd(m[1], _mm_set1_ps(v.position[1]), pos);
+            pos = simd::madd(m[2], _mm_set1_ps(v.position[2]), pos);
+            __m128 nrm = _mm_mul_ps(m[0], _mm_set1_ps(v.normal[0]));
+            nrm = simd::madd(m[1], _mm_set1_ps(v.normal[1]), nrm);
+            nrm = simd::madd(m[2], _mm_set1_ps(v.normal[2]), nrm);
+            if (stream)
+            {
+                _mm_stream_ps(out[n].position, pos);
+                _mm_stream_ps(out[n].normal, nrm);
+            }
+            else
+            {
+                _mm_storeu_ps(out[n].position, pos);
+                _mm_storeu_ps(out[n].normal, nrm);
+            }
+        }
+        if (stream)
+        {
+            _mm_sfence();
+        }
+#endif
+        for (; n < end; n++)
+        {
+            const SkinVertex &v = vertices[n];
+            float m[16] = {0.0f};
+            for (size_t k = 0; k < 4; k++)
+            {
+                const float *p = palette + size_t(v.indices[k]) * 16;
+                for (size_t e = 0; e < 16; e++)
+                {
+                    m[e] += v.weights[k] * p[e];
+                }
+            }
+            // 与 GLSL 的 M * vec4 相同：out[j] = sum_i v[i] * mat[i][j]
+            for (size_t j = 0; j < 4; j++)
+            {
+                out[n].position[j] = m[j] * v.position[0] + m[4 + j] * v.position[1] + m[8 + j] * v.position[2] + m[12 + j];
+                out[n].normal[j] = m[j] * v.normal[0] + m[4 + j] * v.normal[1] + m[8 + j] * v.normal[2];
+            }
+        }
+    }
+
+    /// @brief 线性混合蒙皮
+    /// @param vertices 输入顶点
+    /// @param count 顶点个数
+    /// @param palette 矩阵调色板，每个骨骼 16 个 float，列主序
+    /// @param out 输出顶点，至少 count 个
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void skinVertices(const SkinVertex *vertices, size_t count, const float *palette, SkinnedVertex *out, unsigned threads = 1)
+    {
+        // 区间按 64 字节（两个输出顶点）对齐，相邻线程不会写同一缓存行
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { skinVerticesRange(vertices, begin, end, palette, out); }, 2);
+    }
+
+    // 调色板为矩阵数组的重载
+    inline void skinVertices(const SkinVertex *vertices, size_t count, const Matrix<float, 4, 4> *palette, SkinnedVertex *out, unsigned threads = 1)
+    {
+        skinVertices(vertices, count, reinterpret_cast<const float *>(palette), out, threads);
+    }
+
+    /// @brief 构建对偶四元数调色板：palette[i] = bonePose[i] * inverseBind[i]（先逆绑定，再骨骼姿态）
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void buildDualQuaternionPalette(const DualQuaternion<float> *inverseBind, const DualQuaternion<float> *bonePose, size_t count, DualQuaternion<float> *palette, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            palette[i] = bonePose[i] * inverseBind[i];
+                        } });
+    }
+
+    /// @brief 对 [begin, end) 范围内的顶点做对偶四元数蒙皮（DLB）
+    /// 使用 AVX2 时每次处理 8 个顶点：每个影响骨骼读取 8 个对偶四元数（各占一个 256 位寄存器）并转置为 SoA，
+    /// 混合、归一化与变换都在 8 个通道上同时完成，最后转置回 AoS 写出。
+    /// @param vertices 输入顶点
+    /// @param palette 对偶四元数调色板，每个骨骼 8 个 float
+    /// @param out 输出顶点；按 32 字节对齐时使用非临时写入
+    inline void skinVerticesDQRange(const SkinVertex *vertices, size_t begin, size_t end, const DualQuaternion<float> *palette, SkinnedVertex *out)
+    {
+        size_t n = begin;
+#if defined(GLMCS_HAS_AVX2)
+        const bool stream = (reinterpret_cast<uintptr_t>(out) & 31) == 0;
+        const int vertexFloats = int(sizeof(SkinVertex) / sizeof(float));
+        const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(vertexFloats));
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        for (; n + 8 <= end; n += 8)
+        {
+            const float *base = vertices[n].position;
+            __m256 pos[3], nrm[3], weight[4];
+            for (size_t c = 0; c < 3; c++)
+            {
+                pos[c] = _mm256_i32gather_ps(base + c, offsets, 4);
+                nrm[c] = _mm256_i32gather_ps(vertices[n].normal + c, offsets, 4);
+            }
+            for (size_t k = 0; k < 4; k++)
+            {
+                weight[k] = _mm256_i32gather_ps(vertices[n].weights + k, offsets, 4);
+            }
+            // 每 32 位包含两个 uint16 索引
+            alignas(32) uint32_t index[4][8];
+            for (size_t k = 0; k < 4; k += 2)
+            {
+                __m256i pair = _mm256_i32gather_epi32(reinterpret_cast<const int *>(vertices[n].indices + k), offsets, 4);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(index[k]), _mm256_and_si256(pair, _mm256_set1_epi32(0xFFFF)));
+                _mm256_store_si256(reinterpret_cast<__m256i *>(index[k + 1]), _mm256_srli_epi32(pair, 16));
+            }
+
+            // 第一个影响骨骼作为符号参考
+            __m256 b[8], pivot[8];
+            for (size_t l = 0; l < 8; l++)
+            {
+                pivot[l] = _mm256_loadu_ps(&palette[index[0][l]].real.x);
+            }
+            simd::transpose8x8(pivot);
+            for (size_t e = 0; e < 8; e++)
+            {
+                b[e] = _mm256_mul_ps(weight[0], pivot[e]);
+            }
+            for (size_t k = 1; k < 4; k++)
+            {
+                __m256 q[8];
+                for (size_t l = 0; l < 8; l++)
+                {
+                    q[l] = _mm256_loadu_ps(&palette[index[k][l]].real.x);
+                }
+                simd::transpose8x8(q);
+                // 与第一个骨骼反向时权重取反（最短路径）
+                __m256 d = _mm256_mul_ps(q[0], pivot[0]);
+                d = simd::madd(q[1], pivot[1], d);
+                d = simd::madd(q[2], pivot[2], d);
+                d = simd::madd(q[3], pivot[3], d);
+                __m256 w = _mm256_xor_ps(weight[k], _mm256_and_ps(d, signMask));
+                for (size_t e = 0; e < 8; e++)
+                {
+                    b[e] = simd::madd(w, q[e], b[e]);
+                }
+            }
+
+            __m256 len2 = _mm256_mul_ps(b[0], b[0]);
+            len2 = simd::madd(b[1], b[1], len2);
+            len2 = simd::madd(b[2], b[2], len2);
+            len2 = simd::madd(b[3], b[3], len2);
+            __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+            for (size_t e = 0; e < 8; e++)
+            {
+                b[e] = _mm256_mul_ps(b[e], inv);
+            }
+            const __m256 rx = b[0], ry = b[1], rz = b[2], rw = b[3];
+            const __m256 dx = b[4], dy = b[5], dz = b[6], dw = b[7];
+            // t = 2 * (rw * dv - dw * rv + rv x dv)
+            __m256 tx = _mm256_sub_ps(_mm256_mul_ps(rw, dx), _mm256_mul_ps(dw, rx));
+            __m256 ty = _mm256_sub_ps(_mm256_mul_ps(rw, dy), _mm256_mul_ps(dw, ry));
+            __m256 tz = _mm256_sub_ps(_mm256_mul_ps(rw, dz), _mm256_mul_ps(dw, rz));
+            tx = _mm256_add_ps(tx, _mm256_sub_ps(_mm256_mul_ps(ry, dz), _mm256_mul_ps(rz, dy)));
+            ty = _mm256_add_ps(ty, _mm256_sub_ps(_mm256_mul_ps(rz, dx), _mm256_mul_ps(rx, dz)));
+            tz = _mm256_add_ps(tz, _mm256_sub_ps(_mm256_mul_ps(rx, dy), _mm256_mul_ps(ry, dx)));
+
+            // v + 2 * rv x (rv x v + rw * v)
+            __m256 r[8];
+            __m256 *src[2] = {pos, nrm};
+            for (size_t s = 0; s < 2; s++)
+            {
+                const __m256 *v = src[s];
+                __m256 cx = simd::madd(rw, v[0], _mm256_sub_ps(_mm256_mul_ps(ry, v[2]), _mm256_mul_ps(rz, v[1])));
+                __m256 cy = simd::madd(rw, v[1], _mm256_sub_ps(_mm256_mul_ps(rz, v[0]), _mm256_mul_ps(rx, v[2])));
+                __m256 cz = simd::madd(rw, v[2], _mm256_sub_ps(_mm256_mul_ps(rx, v[1]), _mm256_mul_ps(ry, v[0])));
+                r[s * 4 + 0] = simd::madd(two, _mm256_sub_ps(_mm256_mul_ps(ry, cz), _mm256_mul_ps(rz, cy)), v[0]);
+                r[s * 4 + 1] = simd::madd(two, _mm256_sub_ps(_mm256_mul_ps(rz, cx), _mm256_mul_ps(rx, cz)), v[1]);
+                r[s * 4 + 2] = simd::madd(two, _mm256_sub_ps(_mm256_mul_ps(rx, cy), _mm256_mul_ps(ry, cx)), v[2]);
+            }
+            r[0] = simd::madd(two, tx, r[0]);
+            r[1] = simd::madd(two, ty, r[1]);
+            r[2] = simd::madd(two, tz, r[2]);
+            r[3] = one;
+            r[7] = _mm256_setzero_ps();
+            simd::transpose8x8(r);
+            for (size_t l = 0; l < 8; l++)
+            {
+                if (stream)
+                {
+                    _mm256_stream_ps(out[n + l].position, r[l]);
+                }
+                else
+                {
+                    _mm256_storeu_ps(out[n + l].position, r[l]);
+                }
+            }
+        }
+        if (stream)
+        {
+            _mm_sfence();
+        }
+#endif
+        for (; n < end; n++)
+        {
+            const SkinVertex &v = vertices[n];
+            const Quaternion<float> &pivot = palette[v.indices[0]].real;
+            float b[8] = {0.0f};
+            for (size_t k = 0; k < 4; k++)
+            {
+                const DualQuaternion<float> &dq = palette[v.indices[k]];
+                const float *q = &dq.real.x;
+                float w = dot(dq.real, pivot) < 0.0f ? -v.weights[k] : v.weights[k];
+                for (size_t e = 0; e < 8; e++)
+                {
+                    b[e] += w * q[e];
+                }
+            }
+            DualQuaternion<float> dq;
+            dq.real = quaternion(b[0], b[1], b[2], b[3]);
+            dq.dual = quaternion(b[4], b[5], b[6], b[7]);
+            float inv = 1.0f / sqrtf(dot(dq.real, dq.real));
+            dq.real = dq.real * inv;
+            dq.dual = dq.dual * inv;
+            Vector3 p = transformPoint(dq, vec3(v.position[0], v.position[1], v.position[2]));
+            Vector3 nr = transformVector(dq, vec3(v.normal[0], v.normal[1], v.normal[2]));
+            SkinnedVertex &o = out[n];
+            o.position[0] = p.x;
+            o.position[1] = p.y;
+            o.position[2] = p.z;
+            o.position[3] = 1.0f;
+            o.normal[0] = nr.x;
+            o.normal[1] = nr.y;
+            o.normal[2] = nr.z;
+            o.normal[3] = 0.0f;
+        }
+    }
+
+    /// @brief 对偶四元数蒙皮
+    /// @param vertices 输入顶点
+    /// @param count 顶点个数
+    /// @param palette 对偶四元数调色板（buildDualQuaternionPalette 的输出）
+    /// @param out 输出顶点，至少 count 个
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void skinVerticesDQ(const SkinVertex *vertices, size_t count, const DualQuaternion<float> *palette, SkinnedVertex *out, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { skinVerticesDQRange(vertices, begin, end, palette, out); }, 8);
+    }
+} // namespace glmCS
+
+#endif // __CSSKINNING_H__
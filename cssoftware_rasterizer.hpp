@@ -0,0 +1,674 @@
+/// @ref core
+/// @file cssoftware_rasterizer.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Headless CPU rasterizer with GLSL-like semantics, for render tests and thumbnails on machines without a GPU.
+/// drawIndexed() takes clip-space positions (for example from transformPositions() with a glmCS MVP matrix) plus
+/// per-vertex varyings. Triangles are clipped against the near plane and a guard band, culled by winding, snapped
+/// to 1/256 pixel and binned into 64x64 tiles. Tiles are shaded on several threads, each tile taking its triangles
+/// in submission order, so the image is identical for any thread count. Inside a tile the rasterizer walks 8-pixel
+/// spans. Coverage, depth test and perspective-correct varyings are computed for all 8 lanes at once (AVX, scalar
+/// elsewhere), and the fragment callback receives the whole span as SoA lanes (FragmentLanes -> FragmentOutput).
+/// This is SPMD shading in the style of GPU warps.
+///
+/// Rules follow OpenGL: pixel centres are sampled with the top-left fill rule, so shared edges are drawn exactly
+/// once. Counter-clockwise triangles are front-facing. Depth is window depth in [0,1] with a LESS test (GREATER for
+/// reverse-Z), and fragments outside the depth range are clipped. Depth is tested before the callback runs and
+/// written after it, so a callback that clears bits of out.mask behaves like discard. Optional blending is
+/// SRC_ALPHA, ONE_MINUS_SRC_ALPHA. The colour buffer is RGBA8 and the depth buffer float, both with row 0 at the
+/// bottom; readColor() can flip to top-down for image files. The callback runs concurrently on several threads, so
+/// it must only read shared state.
+///
+/// glmCS::SoftwareRasterizer raster(256, 256);
+/// raster.clear(0.0f, 0.0f, 0.0f, 1.0f);
+/// glmCS::transformPositions(positions, vertexCount, mvp, clip.data());
+/// raster.drawIndexed(clip.data(), normals, 3, vertexCount, indices, triangleCount,
+///                    [&](const glmCS::FragmentLanes &in, glmCS::FragmentOutput &out) {
+///                        for (size_t l = 0; l < glmCS::FragmentLanes::width; l++)
+///                            out.color[0][l] = out.color[1][l] = out.color[2][l] = in.varyings[1][l] * 0.5f + 0.5f, out.color[3][l] = 1.0f;
+///                    }, 4);
+/// raster.readColor(pixels, true);
+///
+
+#ifndef __CSSOFTWARE_RASTERIZER_H__
+#define __CSSOFTWARE_RASTERIZER_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "cssimd_utils.hpp"
+#include "cscamera.hpp"
+#include "csparallel_utils.hpp"
+#include "cserror_utils.hpp"
+
+namespace glmCS
+{
+    // 面剔除方式
+    enum CullMode
+    {
+        GLMCS_cull_none = 0,
+        GLMCS_cull_back, // 剔除顺时针（背面）三角形
+        GLMCS_cull_front // 剔除逆时针（正面）三角形
+    };
+
+    // 同一行连续 8 个片元的输入（SoA）
+    struct FragmentLanes
+    {
+        static constexpr size_t width = 8;
+        static constexpr size_t maxVaryings = 16;
+
+        float x[width], y[width]; // 像素中心的窗口坐标（gl_FragCoord.xy）
+        float depth[width];       // 窗口深度（gl_FragCoord.z）
+        float varyings[maxVaryings][width];
+        uint32_t mask;        // 被覆盖且通过深度测试的通道，第 l 位对应 x[l]
+        bool frontFacing;     // gl_FrontFacing
+        uint32_t primitiveId; // gl_PrimitiveID
+    };
+
+    // 片元回调的输出，color[channel][lane]，值域 [0,1]
+    struct FragmentOutput
+    {
+        float color[4][FragmentLanes::width];
+        uint32_t mask; // 初始为 FragmentLanes::mask，清除某一位即丢弃该片元（discard）
+    };
+
+    /// @brief 批量把模型空间位置变换到裁剪空间
+    /// @param positions 顶点位置 xyz 紧密排列
+    /// @param clip 输出，每个顶点 4 个 float (x, y, z, w)
+    inline void transformPositions(const float *positions, size_t count, const Matrix<float, 4, 4> &modelViewProjection, float *clip)
+    {
+        const float(*m)[4] = modelViewProjection.mat;
+        for (size_t i = 0; i < count; i++)
+        {
+            float x = positions[i * 3], y = positions[i * 3 + 1], z = positions[i * 3 + 2];
+            for (size_t r = 0; r < 4; r++)
+            {
+                clip[i * 4 + r] = m[0][r] * x + m[1][r] * y + m[2][r] * z + m[3][r];
+            }
+        }
+    }
+
+    namespace raster
+    {
+        const size_t binSize = 64; // 线程分配与三角形分桶的 tile 边长（像素）
+        const size_t lanes = FragmentLanes::width;
+        const float subpixel = 256.0f;    // 顶点吸附到 1/256 像素
+        const float guardBand = 4.0f;     // 裁剪空间 |x|, |y| <= guardBand * w
+        const size_t maxClipVertices = 9; // 三角形经 5 个平面裁剪后的最大顶点数
+
+        // 屏幕空间中已完成建立的三角形
+        struct Triangle
+        {
+            float originX[3], originY[3]; // 边函数的原点：共享边的两个三角形使用同一端点，结果严格互为相反数
+            float edgeA[3], edgeB[3];     // e = A * (x - originX) + B * (y - originY) > 0 为内侧
+            bool topLeft[3];              // e == 0 时是否属于本三角形（左上规则）
+            float invArea;
+            float z0, dz1, dz2;          // 窗口深度，按屏幕空间重心坐标线性插值
+            float w0, dw1, dw2;          // 1 / w
+            uint32_t attributes;         // 在 attributeData 中的起点：每个 varying 为 (a0, a1 - a0, a2 - a0)，已除以 w
+            uint32_t px0, py0, px1, py1; // 覆盖的像素范围（含两端）
+            uint32_t primitiveId;
+            bool frontFacing;
+        };
+
+        // 裁剪平面 dot(plane, clip) >= 0 为内侧
+        inline float planeDistance(const float *v, size_t plane, CameraDepthMode mode)
+        {
+            switch (plane)
+            {
+            case 0:
+                return mode == GLMCS_depth_zero_to_one ? v[2] : (mode == GLMCS_depth_reverse_z ? v[3] - v[2] : v[2] + v[3]);
+            case 1:
+                return guardBand * v[3] - v[0];
+            case 2:
+                return guardBand * v[3] + v[0];
+            case 3:
+                return guardBand * v[3] - v[1];
+            default:
+                return guardBand * v[3] + v[1];
+            }
+        }
+
+        inline float snap(float v)
+        {
+            return floorf(v * subpixel + 0.5f) / subpixel;
+        }
+
+        // 颜色 [0,1] -> [0,255]，NaN 视为 0
+        inline uint8_t toByte(float v)
+        {
+            v = !(v > 0.0f) ? 0.0f : (v > 1.0f ? 1.0f : v);
+            return uint8_t(v * 255.0f + 0.5f);
+        }
+
+        // 按内存顺序 R, G, B, A 打包为一个像素
+        inline uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+        {
+            const uint8_t rgba[4] = {r, g, b, a};
+            uint32_t packed;
+            memcpy(&packed, rgba, 4);
+            return packed;
+        }
+
+#if defined(GLMCS_HAS_AVX)
+        // 通道位掩码 -> 向量掩码（AVX 没有 256 位整数比较，用查表代替）
+        inline __m256 laneMask(uint32_t mask)
+        {
+            struct Table
+            {
+                alignas(32) int32_t masks[256][lanes];
+                Table()
+                {
+                    for (size_t m = 0; m < 256; m++)
+                    {
+                        for (size_t l = 0; l < lanes; l++)
+                        {
+                            masks[m][l] = (m >> l) & 1 ? -1 : 0;
+                        }
+                    }
+                }
+            };
+            static const Table table;
+            return _mm256_load_ps(reinterpret_cast<const float *>(table.masks[mask]));
+        }
+#endif
+
+        // 8 个通道的颜色转换为 RGBA8
+        inline void packColors(const float color[4][lanes], uint32_t packed[lanes])
+        {
+#if defined(GLMCS_HAS_AVX)
+            // max(v, 0) 对 NaN 返回 0；x86 为小端序，r | g << 8 | b << 16 | a << 24 即内存顺序 R, G, B, A
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), scale = _mm256_set1_ps(255.0f), half = _mm256_set1_ps(0.5f);
+            __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+            for (int c = 0; c < 4; c++)
+            {
+                __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(color[c]), zero), one);
+                __m256i bytes = _mm256_cvttps_epi32(simd::madd(v, scale, half));
+                lo = _mm_or_si128(lo, _mm_slli_epi32(_mm256_castsi256_si128(bytes), c * 8));
+                hi = _mm_or_si128(hi, _mm_slli_epi32(_mm256_extractf128_si256(bytes, 1), c * 8));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(packed), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(packed + 4), hi);
+#else
+            for (size_t l = 0; l < lanes; l++)
+            {
+                packed[l] = packColor(toByte(color[0][l]), toByte(color[1][l]), toByte(color[2][l]), toByte(color[3][l]));
+            }
+#endif
+        }
+    } // namespace raster
+
+    class SoftwareRasterizer
+    {
+    public:
+        /// @param depthMode 裁剪空间的深度约定，决定近平面裁剪、窗口深度与深度测试方向
+        SoftwareRasterizer(size_t width, size_t height, CameraDepthMode depthMode = GLMCS_depth_negative_one_to_one)
+            : mode(depthMode)
+        {
+            resize(width, height);
+        }
+
+        void resize(size_t width, size_t height)
+        {
+            pixelsX = width > 0 ? width : 1;
+            pixelsY = height > 0 ? height : 1;
+            // 行宽补齐到 8 的倍数，使每个 8 像素片段都在同一行内
+            stride = (pixelsX + raster::lanes - 1) / raster::lanes * raster::lanes;
+            colorBuffer.assign(stride * pixelsY, 0);
+            depthBuffer.assign(stride * pixelsY, farDepth());
+            binsX = (pixelsX + raster::binSize - 1) / raster::binSize;
+            binsY = (pixelsY + raster::binSize - 1) / raster::binSize;
+        }
+
+        size_t width() const { return pixelsX; }
+        size_t height() const { return pixelsY; }
+
+        void setDepthMode(CameraDepthMode depthMode) { mode = depthMode; }
+        void setCullMode(CullMode cull) { cullMode = cull; }
+        void setDepthTest(bool enabled) { depthTest = enabled; }
+        void setDepthWrite(bool enabled) { depthWrite = enabled; }
+        // SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+        void setBlend(bool enabled) { blend = enabled; }
+
+        // 用给定颜色清空颜色缓冲，深度清为远平面（reverse-Z 为 0，否则为 1）
+        void clear(float r, float g, float b, float a)
+        {
+            std::fill(colorBuffer.begin(), colorBuffer.end(), raster::packColor(raster::toByte(r), raster::toByte(g), raster::toByte(b), raster::toByte(a)));
+            std::fill(depthBuffer.begin(), depthBuffer.end(), farDepth());
+        }
+
+        /// @brief 绘制带索引的三角形
+        /// @param clipPositions 裁剪空间位置，每个顶点 4 个 float
+        /// @param varyings 每个顶点 varyingCount 个 float，透视校正插值后传给片元回调，可为 nullptr
+        /// @param varyingCount 每个顶点的 varying 个数，超过 FragmentLanes::maxVaryings 的部分被忽略
+        /// @param shader 片元回调 shader(const FragmentLanes &, FragmentOutput &)，会被多个线程同时调用
+        /// @param threads 线程数，按 64x64 的 tile 动态分配
+        /// @return 建立后参与光栅化的三角形个数（裁剪产生的三角形分别计数）
+        template <typename Shader>
+        size_t drawIndexed(const float *clipPositions, const float *varyings, size_t varyingCount, size_t vertexCount,
+                           const uint32_t *indices, size_t triangleCount, const Shader &shader, unsigned threads = 1)
+        {
+            size_t usedVaryings = std::min(varyingCount, FragmentLanes::maxVaryings);
+            triangles.clear();
+            attributeData.clear();
+            for (size_t t = 0; t < triangleCount; t++)
+            {
+                uint32_t index[3] = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+                if (!GLMCS_GUARD(index[0] < vertexCount && index[1] < vertexCount && index[2] < vertexCount, GLMCS_error_index_out_of_range, "drawIndexed"))
+                {
+                    continue;
+                }
+                clipTriangle(clipPositions, varyings, varyingCount, usedVaryings, index, uint32_t(t));
+            }
+            buildBins();
+            parallelForEach(binsX * binsY, threads, [&](size_t bin)
+                            { rasterizeBin(bin, usedVaryings, shader); });
+            return triangles.size();
+        }
+
+        // 非索引绘制：每 3 个顶点组成一个三角形
+        template <typename Shader>
+        size_t draw(const float *clipPositions, const float *varyings, size_t varyingCount, size_t vertexCount, const Shader &shader, unsigned threads = 1)
+        {
+            sequentialIndices.resize(vertexCount / 3 * 3);
+            for (size_t i = 0; i < sequentialIndices.size(); i++)
+            {
+                sequentialIndices[i] = uint32_t(i);
+            }
+            return drawIndexed(clipPositions, varyings, varyingCount, vertexCount, sequentialIndices.data(), vertexCount / 3, shader, threads);
+        }
+
+        // 像素 (x, y) 的 RGBA8，y = 0 为最下一行
+        const uint8_t *pixel(size_t x, size_t y) const { return reinterpret_cast<const uint8_t *>(&colorBuffer[y * stride + x]); }
+        float depth(size_t x, size_t y) const { return depthBuffer[y * stride + x]; }
+
+        /// @brief 复制颜色缓冲
+        /// @param rgba 输出 width * height * 4 字节
+        /// @param topDown 为 true 时第一行是图像最上一行（PNG 等图片格式）
+        void readColor(uint8_t *rgba, bool topDown = false) const
+        {
+            for (size_t y = 0; y < pixelsY; y++)
+            {
+                size_t row = topDown ? pixelsY - 1 - y : y;
+                memcpy(rgba + y * pixelsX * 4, &colorBuffer[row * stride], pixelsX * 4);
+            }
+        }
+
+        void readDepth(float *depths, bool topDown = false) const
+        {
+            for (size_t y = 0; y < pixelsY; y++)
+            {
+                size_t row = topDown ? pixelsY - 1 - y : y;
+                memcpy(depths + y * pixelsX, &depthBuffer[row * stride], pixelsX * sizeof(float));
+            }
+        }
+
+    private:
+        CameraDepthMode mode;
+        CullMode cullMode = GLMCS_cull_none;
+        bool depthTest = true;
+        bool depthWrite = true;
+        bool blend = false;
+        size_t pixelsX = 0, pixelsY = 0, stride = 0;
+        size_t binsX = 0, binsY = 0;
+        std::vector<uint32_t> colorBuffer; // RGBA8（内存顺序 R, G, B, A），每行 stride 个像素
+        std::vector<float> depthBuffer;
+        std::vector<raster::Triangle> triangles;
+        std::vector<float> attributeData;
+        std::vector<uint32_t> binStart, binTriangles, sequentialIndices;
+
+        float farDepth() const { return mode == GLMCS_depth_reverse_z ? 0.0f : 1.0f; }
+
+        // 对近平面与保护带做 Sutherland-Hodgman 裁剪，再按扇形拆分
+        void clipTriangle(const float *clipPositions, const float *varyings, size_t varyingCount, size_t usedVaryings, const uint32_t index[3], uint32_t primitiveId)
+        {
+            const size_t vertexFloats = 4 + FragmentLanes::maxVaryings;
+            float buffers[2][raster::maxClipVertices][vertexFloats];
+            size_t count = 3;
+            bool inside = true;
+            for (size_t k = 0; k < 3; k++)
+            {
+                memcpy(buffers[0][k], clipPositions + index[k] * 4, 4 * sizeof(float));
+                for (size_t v = 0; v < usedVaryings; v++)
+                {
+                    buffers[0][k][4 + v] = varyings[index[k] * varyingCount + v];
+                }
+            }
+            for (size_t plane = 0; plane < 5; plane++)
+            {
+                inside = inside && raster::planeDistance(buffers[0][0], plane, mode) >= 0.0f && raster::planeDistance(buffers[0][1], plane, mode) >= 0.0f &&
+                         raster::planeDistance(buffers[0][2], plane, mode) >= 0.0f;
+            }
+            size_t current = 0;
+            if (!inside)
+            {
+                for (size_t plane = 0; plane < 5 && count >= 3; plane++)
+                {
+                    float(*src)[vertexFloats] = buffers[current];
+                    float(*dst)[vertexFloats] = buffers[current ^ 1];
+                    size_t n = 0;
+                    for (size_t k = 0; k < count; k++)
+                    {
+                        const float *a = src[k], *b = src[(k + 1) % count];
+                        float da = raster::planeDistance(a, plane, mode), db = raster::planeDistance(b, plane, mode);
+                        if (da >= 0.0f)
+                        {
+                            memcpy(dst[n++], a, vertexFloats * sizeof(float));
+                        }
+                        if ((da >= 0.0f) != (db >= 0.0f))
+                        {
+                            float s = da / (da - db);
+                            for (size_t c = 0; c < 4 + usedVaryings; c++)
+                            {
+                                dst[n][c] = a[c] + (b[c] - a[c]) * s;
+                            }
+                            n++;
+                        }
+                    }
+                    count = n;
+                    current ^= 1;
+                }
+            }
+            for (size_t k = 2; k < count; k++)
+            {
+                setupTriangle(buffers[current][0], buffers[current][k - 1], buffers[current][k], usedVaryings, primitiveId);
+            }
+        }
+
+        void setupTriangle(const float *a, const float *b, const float *c, size_t usedVaryings, uint32_t primitiveId)
+        {
+            const float *v[3] = {a, b, c};
+            float x[3], y[3], z[3], invW[3];
+            for (size_t k = 0; k < 3; k++)
+            {
+                if (!(v[k][3] > 0.0f))
+                {
+                    return;
+                }
+                invW[k] = 1.0f / v[k][3];
+                x[k] = raster::snap((v[k][0] * invW[k] * 0.5f + 0.5f) * float(pixelsX));
+                y[k] = raster::snap((v[k][1] * invW[k] * 0.5f + 0.5f) * float(pixelsY));
+                z[k] = mode == GLMCS_depth_negative_one_to_one ? v[k][2] * invW[k] * 0.5f + 0.5f : v[k][2] * invW[k];
+            }
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+            if (!(area != 0.0f))
+            {
+                return;
+            }
+            bool front = area > 0.0f;
+            if ((cullMode == GLMCS_cull_back && !front) || (cullMode == GLMCS_cull_front && front))
+            {
+                return;
+            }
+            // 覆盖的像素中心范围
+            float minX = std::min(x[0], std::min(x[1], x[2])), maxX = std::max(x[0], std::max(x[1], x[2]));
+            float minY = std::min(y[0], std::min(y[1], y[2])), maxY = std::max(y[0], std::max(y[1], y[2]));
+            float px0 = std::max(ceilf(minX - 0.5f), 0.0f), px1 = std::min(floorf(maxX - 0.5f), float(pixelsX) - 1.0f);
+            float py0 = std::max(ceilf(minY - 0.5f), 0.0f), py1 = std::min(floorf(maxY - 0.5f), float(pixelsY) - 1.0f);
+            if (!(px0 <= px1 && py0 <= py1))
+            {
+                return;
+            }
+            // 顺时针三角形交换顶点 1、2，使内侧的边函数为正；插值仍以交换后的顶点为准
+            size_t order[3] = {0, front ? size_t(1) : size_t(2), front ? size_t(2) : size_t(1)};
+            raster::Triangle t;
+            float sx[3], sy[3];
+            for (size_t k = 0; k < 3; k++)
+            {
+                sx[k] = x[order[k]];
+                sy[k] = y[order[k]];
+            }
+            for (size_t e = 0; e < 3; e++)
+            {
+                size_t p = e, q = (e + 1) % 3;
+                // 以字典序较小的端点为原点，共享边在两个三角形中的计算完全相同
+                bool reversed = sx[q] < sx[p] || (sx[q] == sx[p] && sy[q] < sy[p]);
+                size_t o = reversed ? q : p, d = reversed ? p : q;
+                float A = sy[o] - sy[d], B = sx[d] - sx[o];
+                t.originX[e] = sx[o];
+                t.originY[e] = sy[o];
+                t.edgeA[e] = reversed ? -A : A;
+                t.edgeB[e] = reversed ? -B : B;
+                t.topLeft[e] = t.edgeA[e] > 0.0f || (t.edgeA[e] == 0.0f && t.edgeB[e] < 0.0f);
+            }
+            t.invArea = 1.0f / fabsf(area);
+            size_t i0 = order[0], i1 = order[1], i2 = order[2];
+            t.z0 = z[i0];
+            t.dz1 = z[i1] - z[i0];
+            t.dz2 = z[i2] - z[i0];
+            t.w0 = invW[i0];
+            t.dw1 = invW[i1] - invW[i0];
+            t.dw2 = invW[i2] - invW[i0];
+            t.attributes = uint32_t(attributeData.size());
+            for (size_t k = 0; k < usedVaryings; k++)
+            {
+                float a0 = v[i0][4 + k] * invW[i0], a1 = v[i1][4 + k] * invW[i1], a2 = v[i2][4 + k] * invW[i2];
+                attributeData.push_back(a0);
+                attributeData.push_back(a1 - a0);
+                attributeData.push_back(a2 - a0);
+            }
+            t.px0 = uint32_t(px0);
+            t.py0 = uint32_t(py0);
+            t.px1 = uint32_t(px1);
+            t.py1 = uint32_t(py1);
+            t.primitiveId = primitiveId;
+            t.frontFacing = front;
+            triangles.push_back(t);
+        }
+
+        // 计数排序：每个 tile 的三角形列表保持提交顺序
+        void buildBins()
+        {
+            binStart.assign(binsX * binsY + 1, 0);
+            for (size_t i = 0; i < triangles.size(); i++)
+            {
+                const raster::Triangle &t = triangles[i];
+                for (size_t by = t.py0 / raster::binSize; by <= t.py1 / raster::binSize; by++)
+                {
+                    for (size_t bx = t.px0 / raster::binSize; bx <= t.px1 / raster::binSize; bx++)
+                    {
+                        binStart[by * binsX + bx + 1]++;
+                    }
+                }
+            }
+            for (size_t b = 0; b < binsX * binsY; b++)
+            {
+                binStart[b + 1] += binStart[b];
+            }
+            binTriangles.resize(binStart[binsX * binsY]);
+            std::vector<uint32_t> fill(binStart.begin(), binStart.end() - 1);
+            for (size_t i = 0; i < triangles.size(); i++)
+            {
+                const raster::Triangle &t = triangles[i];
+                for (size_t by = t.py0 / raster::binSize; by <= t.py1 / raster::binSize; by++)
+                {
+                    for (size_t bx = t.px0 / raster::binSize; bx <= t.px1 / raster::binSize; bx++)
+                    {
+                        binTriangles[fill[by * binsX + bx]++] = uint32_t(i);
+                    }
+                }
+            }
+        }
+
+        template <typename Shader>
+        void rasterizeBin(size_t bin, size_t usedVaryings, const Shader &shader)
+        {
+            size_t binX0 = (bin % binsX) * raster::binSize, binY0 = (bin / binsX) * raster::binSize;
+            size_t binX1 = std::min(binX0 + raster::binSize, pixelsX) - 1, binY1 = std::min(binY0 + raster::binSize, pixelsY) - 1;
+            FragmentLanes in;
+            FragmentOutput out;
+            for (size_t k = binStart[bin]; k < binStart[bin + 1]; k++)
+            {
+                const raster::Triangle &t = triangles[binTriangles[k]];
+                size_t x0 = std::max<size_t>(t.px0, binX0), x1 = std::min<size_t>(t.px1, binX1);
+                size_t y0 = std::max<size_t>(t.py0, binY0), y1 = std::min<size_t>(t.py1, binY1);
+                in.frontFacing = t.frontFacing;
+                in.primitiveId = t.primitiveId;
+                for (size_t y = y0; y <= y1; y++)
+                {
+                    for (size_t span = x0 / raster::lanes * raster::lanes; span <= x1; span += raster::lanes)
+                    {
+                        // 片段中位于 [x0, x1] 的通道
+                        size_t first = span < x0 ? x0 - span : 0, last = std::min(x1 - span, raster::lanes - 1);
+                        uint32_t spanMask = ((2u << last) - 1u) & ~((1u << first) - 1u);
+                        shadeSpan(t, span, y, spanMask, usedVaryings, shader, in, out);
+                    }
+                }
+            }
+        }
+
+        template <typename Shader>
+        void shadeSpan(const raster::Triangle &t, size_t span, size_t y, uint32_t spanMask, size_t usedVaryings, const Shader &shader,
+                       FragmentLanes &in, FragmentOutput &out)
+        {
+            float *depthRow = &depthBuffer[y * stride + span];
+            float py = float(y) + 0.5f;
+            const float *attributes = attributeData.data() + t.attributes;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(float(span) + 0.5f), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+            __m256 e[3];
+            uint32_t mask = spanMask;
+            for (size_t k = 0; k < 3; k++)
+            {
+                e[k] = simd::madd(_mm256_set1_ps(t.edgeA[k]), _mm256_sub_ps(px, _mm256_set1_ps(t.originX[k])), _mm256_set1_ps(t.edgeB[k] * (py - t.originY[k])));
+                __m256 covered = t.topLeft[k] ? _mm256_cmp_ps(e[k], zero, _CMP_GE_OQ) : _mm256_cmp_ps(e[k], zero, _CMP_GT_OQ);
+                mask &= uint32_t(_mm256_movemask_ps(covered));
+            }
+            if (mask == 0)
+            {
+                return;
+            }
+            // 屏幕空间重心坐标：e[1] 对应顶点 0，e[2] 对应顶点 1，e[0] 对应顶点 2
+            __m256 invArea = _mm256_set1_ps(t.invArea);
+            __m256 b1 = _mm256_mul_ps(e[2], invArea), b2 = _mm256_mul_ps(e[0], invArea);
+            __m256 z = simd::madd(b2, _mm256_set1_ps(t.dz2), simd::madd(b1, _mm256_set1_ps(t.dz1), _mm256_set1_ps(t.z0)));
+            __m256 pass = _mm256_and_ps(_mm256_cmp_ps(z, zero, _CMP_GE_OQ), _mm256_cmp_ps(z, one, _CMP_LE_OQ));
+            if (depthTest)
+            {
+                __m256 stored = _mm256_loadu_ps(depthRow);
+                pass = _mm256_and_ps(pass, mode == GLMCS_depth_reverse_z ? _mm256_cmp_ps(z, stored, _CMP_GT_OQ) : _mm256_cmp_ps(z, stored, _CMP_LT_OQ));
+            }
+            mask &= uint32_t(_mm256_movemask_ps(pass));
+            if (mask == 0)
+            {
+                return;
+            }
+            __m256 w = _mm256_div_ps(one, simd::madd(b2, _mm256_set1_ps(t.dw2), simd::madd(b1, _mm256_set1_ps(t.dw1), _mm256_set1_ps(t.w0))));
+            for (size_t k = 0; k < usedVaryings; k++)
+            {
+                const float *a = attributes + k * 3;
+                __m256 value = simd::madd(b2, _mm256_set1_ps(a[2]), simd::madd(b1, _mm256_set1_ps(a[1]), _mm256_set1_ps(a[0])));
+                _mm256_storeu_ps(in.varyings[k], _mm256_mul_ps(value, w));
+            }
+            _mm256_storeu_ps(in.x, px);
+            _mm256_storeu_ps(in.y, _mm256_set1_ps(py));
+            _mm256_storeu_ps(in.depth, z);
+#else
+            uint32_t mask = spanMask;
+            float b1[raster::lanes], b2[raster::lanes];
+            for (size_t l = 0; l < raster::lanes; l++)
+            {
+                float px = float(span + l) + 0.5f, e[3];
+                for (size_t k = 0; k < 3; k++)
+                {
+                    e[k] = t.edgeA[k] * (px - t.originX[k]) + t.edgeB[k] * (py - t.originY[k]);
+                    if (!(e[k] > 0.0f || (t.topLeft[k] && e[k] == 0.0f)))
+                    {
+                        mask &= ~(1u << l);
+                    }
+                }
+                b1[l] = e[2] * t.invArea;
+                b2[l] = e[0] * t.invArea;
+                float z = t.z0 + b1[l] * t.dz1 + b2[l] * t.dz2;
+                bool pass = z >= 0.0f && z <= 1.0f;
+                if (depthTest)
+                {
+                    pass = pass && (mode == GLMCS_depth_reverse_z ? z > depthRow[l] : z < depthRow[l]);
+                }
+                mask &= pass ? ~0u : ~(1u << l);
+                in.x[l] = px;
+                in.y[l] = py;
+                in.depth[l] = z;
+            }
+            if (mask == 0)
+            {
+                return;
+            }
+            for (size_t l = 0; l < raster::lanes; l++)
+            {
+                float w = 1.0f / (t.w0 + b1[l] * t.dw1 + b2[l] * t.dw2);
+                for (size_t k = 0; k < usedVaryings; k++)
+                {
+                    const float *a = attributes + k * 3;
+                    in.varyings[k][l] = (a[0] + b1[l] * a[1] + b2[l] * a[2]) * w;
+                }
+            }
+#endif
+            in.mask = mask;
+            out.mask = mask;
+            shader(in, out);
+            mask &= out.mask;
+            uint32_t *colorRow = &colorBuffer[y * stride + span];
+            if (blend)
+            {
+                for (size_t l = 0; l < raster::lanes; l++)
+                {
+                    if ((mask & (1u << l)) == 0)
+                    {
+                        continue;
+                    }
+                    uint8_t *dst = reinterpret_cast<uint8_t *>(colorRow + l);
+                    float alpha = !(out.color[3][l] > 0.0f) ? 0.0f : (out.color[3][l] > 1.0f ? 1.0f : out.color[3][l]);
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        dst[c] = raster::toByte(out.color[c][l] * alpha + float(dst[c]) * (1.0f / 255.0f) * (1.0f - alpha));
+                    }
+                }
+            }
+            else
+            {
+#if defined(GLMCS_HAS_AVX)
+                // 按掩码混合后整段写回（行宽已补齐到 8 的倍数）
+                alignas(32) uint32_t packed[raster::lanes];
+                raster::packColors(out.color, packed);
+                __m256 keep = raster::laneMask(mask);
+                float *colors = reinterpret_cast<float *>(colorRow);
+                _mm256_storeu_ps(colors, _mm256_blendv_ps(_mm256_loadu_ps(colors), _mm256_load_ps(reinterpret_cast<const float *>(packed)), keep));
+                if (depthWrite)
+                {
+                    _mm256_storeu_ps(depthRow, _mm256_blendv_ps(_mm256_loadu_ps(depthRow), _mm256_loadu_ps(in.depth), keep));
+                }
+                return;
+#else
+                uint32_t packed[raster::lanes];
+                raster::packColors(out.color, packed);
+                for (size_t l = 0; l < raster::lanes; l++)
+                {
+                    if (mask & (1u << l))
+                    {
+                        colorRow[l] = packed[l];
+                    }
+                }
+#endif
+            }
+            if (depthWrite)
+            {
+                for (size_t l = 0; l < raster::lanes; l++)
+                {
+                    if (mask & (1u << l))
+                    {
+                        depthRow[l] = in.depth[l];
+                    }
+                }
+            }
+        }
+    };
+} // namespace glmCS
+
+#endif // __CSSOFTWARE_RASTERIZER_H__
@@ -0,0 +1,143 @@
+/// @ref core
+/// @file cstransform_buffer.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Lock-free triple buffer for handing whole frames of transforms from one producer thread to one consumer.
+/// Three slots each hold a full array. The producer writes into its private back slot and publish() swaps it with
+/// the shared slot in a single atomic exchange. The consumer's read() swaps the shared slot with its private front
+/// slot, but only when a newer frame was published. Neither side ever waits for the other. The consumer always
+/// reads a complete frame, because nobody else can touch the front slot, so it never sees a torn matrix. A frame
+/// published again before the consumer looks is simply replaced (latest wins). Exactly one producer thread and
+/// one consumer thread may use the buffer at a time.
+///
+/// After publish() the producer gets back the slot from two publications ago. Pass keepContents = true to copy
+/// the frame just published into it, when the producer only updates part of the array each frame.
+///
+/// glmCS::TransformTripleBuffer transforms(objectCount);
+/// // simulation thread
+/// glmCS::Matrix<float, 4, 4> *world = transforms.writeBuffer();
+/// ... write world[0 .. objectCount) ...
+/// transforms.publish();
+/// // render thread
+/// const glmCS::Matrix<float, 4, 4> *latest = transforms.read();
+///
+
+#ifndef __CSTRANSFORM_BUFFER_H__
+#define __CSTRANSFORM_BUFFER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+#include "csmatrix_utils.hpp"
+
+namespace glmCS
+{
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        explicit TripleBuffer(size_t count = 0)
+        {
+            resize(count);
+        }
+
+        /// @brief 调整每个槽的元素个数，不能与 writeBuffer()/publish()/read() 并发调用
+        void resize(size_t count)
+        {
+            for (size_t i = 0; i < 3; i++)
+            {
+                slots[i].data.resize(count);
+            }
+        }
+
+        size_t size() const { return slots[0].data.size(); }
+
+        // ---------------------------------------------------------------- 生产者线程
+
+        // 当前可写的后台槽，publish() 之后会换成另一个槽
+        T *writeBuffer() { return slots[back].data.data(); }
+
+        /// @brief 发布后台槽中的整帧数据（一次原子交换）
+        /// @param keepContents 为 true 时把刚发布的帧复制到新的后台槽，以便只修改部分元素
+        void publish(bool keepContents = false)
+        {
+            uint32_t published = back;
+            slots[published].sequence = ++publishCount;
+            back = shared.exchange(published | freshBit, std::memory_order_acq_rel) & indexMask;
+            if (keepContents)
+            {
+                // 消费者此时可能也在读 published，两边都只读，不构成数据竞争
+                copySlot(slots[back].data, slots[published].data);
+            }
+        }
+
+        // 已发布的帧数
+        uint64_t publishedFrames() const { return publishCount; }
+
+        // ---------------------------------------------------------------- 消费者线程
+
+        /// @brief 有新帧时换入最新帧，返回前台槽（完整的一帧，在下一次 read() 之前保持不变）
+        const T *read()
+        {
+            if (shared.load(std::memory_order_relaxed) & freshBit)
+            {
+                front = shared.exchange(front, std::memory_order_acq_rel) & indexMask;
+            }
+            return slots[front].data.data();
+        }
+
+        // 是否有尚未被 read() 取走的新帧
+        bool hasNewData() const
+        {
+            return (shared.load(std::memory_order_relaxed) & freshBit) != 0;
+        }
+
+        // 前台槽中的帧序号（第几次 publish，尚未读到任何帧时为 0）
+        uint64_t readSequence() const { return slots[front].sequence; }
+
+    private:
+        static constexpr uint32_t indexMask = 3u;
+        static constexpr uint32_t freshBit = 4u; // 共享槽中有未读的新帧
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "TripleBuffer needs a lock-free 32-bit atomic");
+
+        // 每个槽独占缓存行，避免两个线程更新 sequence 时伪共享
+        struct alignas(64) Slot
+        {
+            std::vector<T> data;
+            uint64_t sequence = 0;
+        };
+
+        Slot slots[3];
+        alignas(64) std::atomic<uint32_t> shared{1u};
+        alignas(64) uint32_t back = 0; // 仅生产者访问
+        uint64_t publishCount = 0;
+        alignas(64) uint32_t front = 2; // 仅消费者访问
+
+        static void copySlot(std::vector<T> &dst, const std::vector<T> &src)
+        {
+            if (std::is_trivially_copyable<T>::value)
+            {
+                if (!src.empty())
+                {
+                    memcpy(static_cast<void *>(dst.data()), src.data(), src.size() * sizeof(T));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < src.size(); i++)
+                {
+                    dst[i] = src[i];
+                }
+            }
+        }
+    };
+
+    // 世界矩阵数组的三缓冲
+    typedef TripleBuffer<Matrix<float, 4, 4>> TransformTripleBuffer;
+} // namespace glmCS
+
+#endif // __CSTRANSFORM_BUFFER_H__
@@ -0,0 +1,255 @@
+/// @ref core
+/// @file cstransform_hierarchy.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Transform hierarchy (scene graph) for glmCS matrices.
+/// Nodes are stored as structure-of-arrays (parent index, local matrix, world matrix, dirty flag) sorted so that
+/// every parent precedes its children. World matrices are recomputed in one linear sweep with the SIMD
+/// matrixMultiply; only dirty nodes and their descendants are touched. The array is laid out as a short prefix of
+/// root nodes followed by independent subtrees, each stored breadth-first, so subtrees can be updated on
+/// different threads without synchronisation.
+///
+/// glmCS::TransformHierarchy scene;
+/// uint32_t body = scene.addNode(glmCS::TransformHierarchy::npos, bodyMatrix);
+/// uint32_t arm = scene.addNode(body, armMatrix);
+/// scene.setLocal(arm, glmCS::rotate(30, armMatrix, 0, 0, 1));
+/// scene.update(4);
+/// const glmCS::Matrix<float, 4, 4> &armWorld = scene.world(arm);
+///
+
+#ifndef __CSTRANSFORM_HIERARCHY_H__
+#define __CSTRANSFORM_HIERARCHY_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    class TransformHierarchy
+    {
+    public:
+        static constexpr uint32_t npos = 0xFFFFFFFFu; // 无父节点
+
+    private:
+        // 独立子树在排序数组中的区间 [begin, end)
+        struct Segment
+        {
+            uint32_t begin, end;
+        };
+
+        // 按添加顺序记录的节点（句柄 = 下标）
+        std::vector<uint32_t> handleParent;
+
+        // 排序后的 SoA 数组
+        std::vector<uint32_t> parent;               // 父节点的排序下标
+        std::vector<Matrix<float, 4, 4>> local;     // 局部矩阵
+        std::vector<Matrix<float, 4, 4>> worldMats; // 世界矩阵
+        std::vector<uint8_t> dirty;                 // 需要重新计算
+        std::vector<uint32_t> handleToIndex;
+        std::vector<uint32_t> indexToHandle;
+
+        std::vector<Segment> segments;
+        uint32_t prefixEnd = 0; // [0, prefixEnd) 为串行处理的根节点
+        bool built = true;
+        bool anyDirty = false;
+
+        // 重新计算一个区间内节点的世界矩阵（父节点一定在前）
+        void sweep(uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                uint32_t p = parent[i];
+                if (p == npos)
+                {
+                    if (dirty[i])
+                    {
+                        worldMats[i] = local[i];
+                    }
+                    continue;
+                }
+                dirty[i] |= dirty[p];
+                if (dirty[i])
+                {
+                    // 列主序：matrixMultiply(local, parentWorld) 即 GLSL 的 world = parentWorld * local
+                    worldMats[i] = matrixMultiply(local[i], worldMats[p].mat);
+                }
+            }
+        }
+
+    public:
+        TransformHierarchy() {}
+
+        /// @brief 添加节点
+        /// @param parentHandle 父节点句柄，根节点传 npos；父节点必须先于子节点添加
+        /// @param localMatrix 相对父节点的局部矩阵
+        /// @return 节点句柄，父节点无效时返回 npos
+        uint32_t addNode(uint32_t parentHandle, const Matrix<float, 4, 4> &localMatrix)
+        {
+            uint32_t handle = uint32_t(handleParent.size());
+            if (parentHandle != npos && parentHandle >= handle)
+            {
+                return npos;
+            }
+            handleParent.push_back(parentHandle);
+            // 先追加在末尾，build() 时重新排序
+            parent.push_back(npos);
+            local.push_back(localMatrix);
+            worldMats.push_back(localMatrix);
+            dirty.push_back(1);
+            handleToIndex.push_back(handle);
+            indexToHandle.push_back(handle);
+            built = false;
+            anyDirty = true;
+            return handle;
+        }
+
+        /// @brief 按 "根节点前缀 + 广度优先的独立子树" 重新排列节点
+        void build()
+        {
+            const uint32_t count = uint32_t(handleParent.size());
+            std::vector<uint32_t> childStart(count + 1, 0), children(count);
+            std::vector<uint32_t> roots;
+            for (uint32_t h = 0; h < count; h++)
+            {
+                if (handleParent[h] == npos)
+                {
+                    roots.push_back(h);
+                }
+                else
+                {
+                    childStart[handleParent[h] + 1]++;
+                }
+            }
+            for (uint32_t h = 0; h < count; h++)
+            {
+                childStart[h + 1] += childStart[h];
+            }
+            std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+            for (uint32_t h = 0; h < count; h++)
+            {
+                if (handleParent[h] != npos)
+                {
+                    children[fill[handleParent[h]]++] = h;
+                }
+            }
+
+            // 根节点较少时（常见的单一场景根），以根的子节点作为独立子树，根节点放入串行前缀
+            std::vector<uint32_t> order;
+            order.reserve(count);
+            std::vector<uint32_t> segmentRoots;
+            if (roots.size() < 8)
+            {
+                for (size_t r = 0; r < roots.size(); r++)
+                {
+                    order.push_back(roots[r]);
+                    for (uint32_t c = childStart[roots[r]]; c < childStart[roots[r] + 1]; c++)
+                    {
+                        segmentRoots.push_back(children[c]);
+                    }
+                }
+            }
+            else
+            {
+                segmentRoots = roots;
+            }
+            prefixEnd = uint32_t(order.size());
+
+            segments.clear();
+            for (size_t s = 0; s < segmentRoots.size(); s++)
+            {
+                Segment seg;
+                seg.begin = uint32_t(order.size());
+                order.push_back(segmentRoots[s]);
+                // 广度优先：order 本身作为队列
+                for (size_t q = seg.begin; q < order.size(); q++)
+                {
+                    uint32_t h = order[q];
+                    for (uint32_t c = childStart[h]; c < childStart[h + 1]; c++)
+                    {
+                        order.push_back(children[c]);
+                    }
+                }
+                seg.end = uint32_t(order.size());
+                segments.push_back(seg);
+            }
+
+            std::vector<Matrix<float, 4, 4>> newLocal(count), newWorld(count);
+            std::vector<uint8_t> newDirty(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t h = order[i];
+                uint32_t old = handleToIndex[h];
+                newLocal[i] = local[old];
+                newWorld[i] = worldMats[old];
+                newDirty[i] = dirty[old];
+            }
+            for (uint32_t i = 0; i < count; i++)
+            {
+                handleToIndex[order[i]] = i;
+            }
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t p = handleParent[order[i]];
+                parent[i] = p == npos ? npos : handleToIndex[p];
+            }
+            indexToHandle.swap(order);
+            local.swap(newLocal);
+            worldMats.swap(newWorld);
+            dirty.swap(newDirty);
+            built = true;
+        }
+
+        // 设置局部矩阵，节点及其子树在下次 update() 时重新计算
+        void setLocal(uint32_t handle, const Matrix<float, 4, 4> &localMatrix)
+        {
+            uint32_t i = handleToIndex[handle];
+            local[i] = localMatrix;
+            dirty[i] = 1;
+            anyDirty = true;
+        }
+
+        const Matrix<float, 4, 4> &getLocal(uint32_t handle) const { return local[handleToIndex[handle]]; }
+
+        // 获取世界矩阵（update() 之后有效）
+        const Matrix<float, 4, 4> &world(uint32_t handle) const { return worldMats[handleToIndex[handle]]; }
+
+        /// @brief 重新计算所有脏节点及其子树的世界矩阵
+        /// @param threads 线程数，独立子树分配到不同线程；1 表示在调用线程上完成
+        void update(unsigned threads = 1)
+        {
+            if (!built)
+            {
+                build();
+            }
+            if (!anyDirty)
+            {
+                return;
+            }
+            sweep(0, prefixEnd);
+            if (threads <= 1 || segments.size() < 2)
+            {
+                sweep(prefixEnd, uint32_t(worldMats.size()));
+            }
+            else
+            {
+                parallelForEach(segments.size(), threads, [this](size_t s)
+                                { sweep(segments[s].begin, segments[s].end); });
+            }
+            memset(dirty.data(), 0, dirty.size());
+            anyDirty = false;
+        }
+
+        size_t size() const { return handleParent.size(); }
+
+        // 排序后的世界矩阵数组，可直接整体上传
+        const Matrix<float, 4, 4> *worldMatrices() const { return worldMats.data(); }
+        // 排序下标对应的节点句柄
+        const uint32_t *sortedHandles() const { return indexToHandle.data(); }
+    };
+} // namespace glmCS
+
+#endif // __CSTRANSFORM_HIERARCHY_H__
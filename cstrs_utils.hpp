@@ -0,0 +1,614 @@
+/// @ref core
+/// @file cstrs_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Batch translation / rotation / scale (TRS) conversions for instanced rendering.
+/// Instances keep translation, unit quaternion and scale in SoA arrays. buildTRSMatrices() writes the packed
+/// instance matrices M = T * R * S directly (scale first, then rotation, then translation) instead of chaining
+/// initIdentityMatrix -> translateMatrix -> rotate -> scaleMatrix with a full copy and a 4x4 multiply per step.
+/// The AVX path builds 8 instances per iteration in SoA registers and transposes them on the store.
+///
+/// Two output formats:
+///   4x4  16 floats per instance, the same column-major storage as Matrix<float,4,4> (mat[3] is the translation)
+///   3x4  12 floats per instance, the first three rows of M (row r = M(r,0), M(r,1), M(r,2), t_r); the last row
+///        is always (0, 0, 0, 1), so instanced vertex attributes can drop it
+///
+/// decomposeTRS() / decomposeTRSMatrices() go the other way. Columns with orthogonal directions (no shear) are
+/// split exactly: scale = column lengths, rotation = normalized columns. A reflection (negative determinant) is
+/// returned as a negative x scale. Sheared input falls back to a polar decomposition M3 = R * S (scaled Newton
+/// iteration) and keeps the closest rotation R plus the diagonal of S; the shear itself is dropped. A singular
+/// 3x3 part (a zero scale axis) still yields an orthonormal rotation, completed with coordinate axes, and is
+/// reported as GLMCS_error_singular_matrix. The batch version handles 8 matrices per AVX iteration and only
+/// sends the lanes that need a fallback through the scalar code.
+///
+/// glmCS::TRSArraysSoA trs = {tx, ty, tz, qx, qy, qz, qw, sx, sy, sz};
+/// glmCS::buildTRSMatrices(trs, count, instanceBuffer, 4);     // 4x4
+/// glmCS::buildTRSMatrices3x4(trs, count, instanceBuffer, 4);  // 3x4
+///
+/// glmCS::decomposeTRS(model, &translation, &rotation, &scale);
+/// glmCS::TRSSoABuffer pose;
+/// glmCS::decomposeTRSMatrices(boneMatrices, boneCount, pose, 4);
+/// glmCS::buildTRSMatrices(pose.arrays(), boneCount, boneMatrices, 4);
+///
+
+#ifndef __CSTRS_UTILS_H__
+#define __CSTRS_UTILS_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+#include "csmatrix_utils.hpp"
+#include "csquaternion_utils.hpp"
+#include "csparallel_utils.hpp"
+
+namespace glmCS
+{
+    // SoA 排列的平移、单位四元数 (x, y, z, w) 与缩放
+    struct TRSArraysSoA
+    {
+        const float *translationX, *translationY, *translationZ;
+        const float *rotationX, *rotationY, *rotationZ, *rotationW;
+        const float *scaleX, *scaleY, *scaleZ;
+    };
+
+    // 持有 SoA 的平移、旋转、缩放（decomposeTRSMatrices 的输出）
+    struct TRSSoABuffer
+    {
+        std::vector<float> translationX, translationY, translationZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+
+        void resize(size_t count)
+        {
+            translationX.resize(count);
+            translationY.resize(count);
+            translationZ.resize(count);
+            rotationX.resize(count);
+            rotationY.resize(count);
+            rotationZ.resize(count);
+            rotationW.resize(count);
+            scaleX.resize(count);
+            scaleY.resize(count);
+            scaleZ.resize(count);
+        }
+
+        TRSArraysSoA arrays() const
+        {
+            TRSArraysSoA trs = {translationX.data(), translationY.data(), translationZ.data(),
+                                rotationX.data(), rotationY.data(), rotationZ.data(), rotationW.data(),
+                                scaleX.data(), scaleY.data(), scaleZ.data()};
+            return trs;
+        }
+    };
+
+    namespace trsbatch
+    {
+        // 单个实例的 3x3 部分：m[c][r] 为第 c 列第 r 行（已乘缩放）
+        inline void rotationScale(const TRSArraysSoA &trs, size_t i, float m[3][3])
+        {
+            float x = trs.rotationX[i], y = trs.rotationY[i], z = trs.rotationZ[i], w = trs.rotationW[i];
+            float x2 = x + x, y2 = y + y, z2 = z + z;
+            float xx = x * x2, yy = y * y2, zz = z * z2;
+            float xy = x * y2, xz = x * z2, yz = y * z2;
+            float wx = w * x2, wy = w * y2, wz = w * z2;
+            float sx = trs.scaleX[i], sy = trs.scaleY[i], sz = trs.scaleZ[i];
+            m[0][0] = (1.0f - (yy + zz)) * sx;
+            m[0][1] = (xy + wz) * sx;
+            m[0][2] = (xz - wy) * sx;
+            m[1][0] = (xy - wz) * sy;
+            m[1][1] = (1.0f - (xx + zz)) * sy;
+            m[1][2] = (yz + wx) * sy;
+            m[2][0] = (xz + wy) * sz;
+            m[2][1] = (yz - wx) * sz;
+            m[2][2] = (1.0f - (xx + yy)) * sz;
+        }
+
+#if defined(GLMCS_HAS_AVX)
+        // 8 个实例的 3x3 部分，m[c * 3 + r] 为第 c 列第 r 行
+        inline void rotationScale8(const TRSArraysSoA &trs, size_t i, __m256 m[9])
+        {
+            __m256 x = _mm256_loadu_ps(trs.rotationX + i), y = _mm256_loadu_ps(trs.rotationY + i);
+            __m256 z = _mm256_loadu_ps(trs.rotationZ + i), w = _mm256_loadu_ps(trs.rotationW + i);
+            __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+            __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+            __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+            __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+            __m256 sx = _mm256_loadu_ps(trs.scaleX + i), sy = _mm256_loadu_ps(trs.scaleY + i), sz = _mm256_loadu_ps(trs.scaleZ + i);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            m[0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx);
+            m[1] = _mm256_mul_ps(_mm256_add_ps(xy, wz), sx);
+            m[2] = _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx);
+            m[3] = _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy);
+            m[4] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy);
+            m[5] = _mm256_mul_ps(_mm256_add_ps(yz, wx), sy);
+            m[6] = _mm256_mul_ps(_mm256_add_ps(xz, wy), sz);
+            m[7] = _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz);
+            m[8] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz);
+        }
+#endif
+
+        inline void buildMatricesRange(const TRSArraysSoA &trs, size_t begin, size_t end, float *out)
+        {
+            size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            for (; i + 8 <= end; i += 8)
+            {
+                __m256 m[9];
+                rotationScale8(trs, i, m);
+                __m256 soa[16] = {m[0], m[1], m[2], zero,
+                                  m[3], m[4], m[5], zero,
+                                  m[6], m[7], m[8], zero,
+                                  _mm256_loadu_ps(trs.translationX + i), _mm256_loadu_ps(trs.translationY + i), _mm256_loadu_ps(trs.translationZ + i), one};
+                simd::storeMatrices8(out + i * 16, soa);
+            }
+#endif
+            for (; i < end; i++)
+            {
+                float m[3][3];
+                rotationScale(trs, i, m);
+                float *dst = out + i * 16;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    dst[c * 4 + 0] = m[c][0];
+                    dst[c * 4 + 1] = m[c][1];
+                    dst[c * 4 + 2] = m[c][2];
+                    dst[c * 4 + 3] = 0.0f;
+                }
+                dst[12] = trs.translationX[i];
+                dst[13] = trs.translationY[i];
+                dst[14] = trs.translationZ[i];
+                dst[15] = 1.0f;
+            }
+        }
+
+        inline void buildMatrices3x4Range(const TRSArraysSoA &trs, size_t begin, size_t end, float *out)
+        {
+            size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+            for (; i + 8 <= end; i += 8)
+            {
+                __m256 m[9];
+                rotationScale8(trs, i, m);
+                // 按行排列：第 r 行为 (m[0 + r], m[3 + r], m[6 + r], t_r)
+                __m256 soa[12] = {m[0], m[3], m[6], _mm256_loadu_ps(trs.translationX + i),
+                                  m[1], m[4], m[7], _mm256_loadu_ps(trs.translationY + i),
+                                  m[2], m[5], m[8], _mm256_loadu_ps(trs.translationZ + i)};
+                simd::storeMatrices3x4x8(out + i * 12, soa);
+            }
+#endif
+            for (; i < end; i++)
+            {
+                float m[3][3];
+                rotationScale(trs, i, m);
+                const float t[3] = {trs.translationX[i], trs.translationY[i], trs.translationZ[i]};
+                float *dst = out + i * 12;
+                for (size_t r = 0; r < 3; r++)
+                {
+                    dst[r * 4 + 0] = m[0][r];
+                    dst[r * 4 + 1] = m[1][r];
+                    dst[r * 4 + 2] = m[2][r];
+                    dst[r * 4 + 3] = t[r];
+                }
+            }
+        }
+
+        // ---------------------------------------------------------------- decomposition
+        // 以下 a、r 均为 3x3 列数组：a[c][r] 为第 c 列第 r 行
+
+        // 列长度平方低于 tiny * 最大列长度平方视为奇异；归一化列两两点积超过 shearTolerance 视为有切变
+        template <typename T>
+        inline T decomposeTiny() { return T(1e-12); }
+        template <typename T>
+        inline T shearTolerance() { return T(1e-4); }
+
+        template <typename T>
+        inline T dot3(const T a[3], const T b[3])
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        template <typename T>
+        inline void cross3(const T a[3], const T b[3], T out[3])
+        {
+            out[0] = a[1] * b[2] - a[2] * b[1];
+            out[1] = a[2] * b[0] - a[0] * b[2];
+            out[2] = a[0] * b[1] - a[1] * b[0];
+        }
+
+        template <typename T>
+        inline T determinant3(const T r[3][3])
+        {
+            T c[3];
+            cross3(r[1], r[2], c);
+            return dot3(r[0], c);
+        }
+
+        // 奇异矩阵：Gram-Schmidt 正交化，长度为 0 的列用与已有列最不相关的坐标轴补足，再修正为右手系
+        template <typename T>
+        inline void completeRotationScale(const T a[3][3], T maxLen2, T r[3][3], T s[3])
+        {
+            for (size_t c = 0; c < 3; c++)
+            {
+                T v[3] = {a[c][0], a[c][1], a[c][2]};
+                for (size_t k = 0; k < c; k++)
+                {
+                    T d = dot3(v, r[k]);
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        v[j] -= d * r[k][j];
+                    }
+                }
+                T len2 = dot3(v, v);
+                if (!(len2 > decomposeTiny<T>() * maxLen2))
+                {
+                    len2 = T(-1);
+                    for (size_t e = 0; e < 3; e++)
+                    {
+                        T axis[3] = {T(0), T(0), T(0)};
+                        axis[e] = T(1);
+                        for (size_t k = 0; k < c; k++)
+                        {
+                            T d = r[k][e];
+                            for (size_t j = 0; j < 3; j++)
+                            {
+                                axis[j] -= d * r[k][j];
+                            }
+                        }
+                        T axisLen2 = dot3(axis, axis);
+                        if (axisLen2 > len2)
+                        {
+                            len2 = axisLen2;
+                            v[0] = axis[0];
+                            v[1] = axis[1];
+                            v[2] = axis[2];
+                        }
+                    }
+                }
+                T inv = T(1) / sqrt(len2);
+                r[c][0] = v[0] * inv;
+                r[c][1] = v[1] * inv;
+                r[c][2] = v[2] * inv;
+                s[c] = dot3(r[c], a[c]);
+            }
+            if (determinant3(r) < T(0))
+            {
+                // 翻转缩放最小（被补足）的一列
+                size_t k = 0;
+                for (size_t c = 1; c < 3; c++)
+                {
+                    k = fabs(s[c]) < fabs(s[k]) ? c : k;
+                }
+                r[k][0] = -r[k][0];
+                r[k][1] = -r[k][1];
+                r[k][2] = -r[k][2];
+                s[k] = -s[k];
+            }
+        }
+
+        // 有切变：极分解 M3 = R * S，带 Frobenius 缩放的 Newton 迭代 X = (g * X + X^-T / g) / 2。
+        // 反射时先取 -a0 使行列式为正，sign0 为 -1
+        template <typename T>
+        inline void polarRotationScale(const T a[3][3], T sign0, T r[3][3], T s[3])
+        {
+            T x[3][3] = {{a[0][0] * sign0, a[0][1] * sign0, a[0][2] * sign0},
+                         {a[1][0], a[1][1], a[1][2]},
+                         {a[2][0], a[2][1], a[2][2]}};
+            for (size_t iteration = 0; iteration < 32; iteration++)
+            {
+                // X^-T 的列为余子式 (x1 × x2, x2 × x0, x0 × x1) / det
+                T cof[3][3];
+                cross3(x[1], x[2], cof[0]);
+                cross3(x[2], x[0], cof[1]);
+                cross3(x[0], x[1], cof[2]);
+                T det = dot3(x[0], cof[0]);
+                T normX = dot3(x[0], x[0]) + dot3(x[1], x[1]) + dot3(x[2], x[2]);
+                T normCof = dot3(cof[0], cof[0]) + dot3(cof[1], cof[1]) + dot3(cof[2], cof[2]);
+                // g = sqrt(|X^-1|_F / |X|_F)
+                T g = sqrt(sqrt(normCof / normX) / det);
+                T ga = T(0.5) * g, gb = T(0.5) / (g * det);
+                T change = T(0);
+                for (size_t c = 0; c < 3; c++)
+                {
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        T next = ga * x[c][j] + gb * cof[c][j];
+                        T d = fabs(next - x[c][j]);
+                        change = d > change ? d : change;
+                        x[c][j] = next;
+                    }
+                }
+                if (change <= T(1e-6))
+                {
+                    break;
+                }
+            }
+            for (size_t c = 0; c < 3; c++)
+            {
+                r[c][0] = x[c][0];
+                r[c][1] = x[c][1];
+                r[c][2] = x[c][2];
+                s[c] = dot3(r[c], a[c]);
+            }
+        }
+
+        /// @brief 分解 3x3 部分 a = R * diag(s)
+        /// @return 非奇异时为 true；奇异时 r 仍为正交矩阵，对应的缩放为 0
+        template <typename T>
+        inline bool rotationScaleFromColumns(const T a[3][3], T r[3][3], T s[3])
+        {
+            T len2[3] = {dot3(a[0], a[0]), dot3(a[1], a[1]), dot3(a[2], a[2])};
+            T maxLen2 = len2[0] > len2[1] ? len2[0] : len2[1];
+            maxLen2 = len2[2] > maxLen2 ? len2[2] : maxLen2;
+            T tiny = decomposeTiny<T>() * maxLen2;
+            if (!(len2[0] > tiny && len2[1] > tiny && len2[2] > tiny))
+            {
+                completeRotationScale(a, maxLen2, r, s);
+                return false;
+            }
+            for (size_t c = 0; c < 3; c++)
+            {
+                s[c] = sqrt(len2[c]);
+                T inv = T(1) / s[c];
+                r[c][0] = a[c][0] * inv;
+                r[c][1] = a[c][1] * inv;
+                r[c][2] = a[c][2] * inv;
+            }
+            T det = determinant3(r);
+            T sign0 = T(1);
+            if (det < T(0))
+            {
+                sign0 = T(-1);
+                s[0] = -s[0];
+                r[0][0] = -r[0][0];
+                r[0][1] = -r[0][1];
+                r[0][2] = -r[0][2];
+            }
+            T d01 = fabs(dot3(r[0], r[1])), d02 = fabs(dot3(r[0], r[2])), d12 = fabs(dot3(r[1], r[2]));
+            T maxDot = d01 > d02 ? d01 : d02;
+            maxDot = d12 > maxDot ? d12 : maxDot;
+            if (maxDot <= shearTolerance<T>())
+            {
+                return true;
+            }
+            // 三列近似共面：按奇异处理
+            if (!(fabs(det) > T(1e-6)))
+            {
+                completeRotationScale(a, maxLen2, r, s);
+                return false;
+            }
+            polarRotationScale(a, sign0, r, s);
+            return true;
+        }
+
+        // 旋转矩阵转四元数：取 1 + (±r00 ± r11 ± r22) 中最大者对应的分量开方（与 AVX 路径的选择顺序相同）
+        template <typename T>
+        inline Quaternion<T> quaternionFromRotation(const T r[3][3])
+        {
+            // R(row, col) = r[col][row]
+            T r00 = r[0][0], r11 = r[1][1], r22 = r[2][2];
+            T d0 = r[1][2] - r[2][1], d1 = r[2][0] - r[0][2], d2 = r[0][1] - r[1][0];
+            T p0 = r[1][2] + r[2][1], p1 = r[2][0] + r[0][2], p2 = r[0][1] + r[1][0];
+            T t = T(1) + r00 + r11 + r22;
+            Quaternion<T> q = quaternion(d0, d1, d2, t);
+            T tx = T(1) + r00 - r11 - r22;
+            if (tx > t)
+            {
+                t = tx;
+                q = quaternion(tx, p2, p1, d0);
+            }
+            T ty = T(1) - r00 + r11 - r22;
+            if (ty > t)
+            {
+                t = ty;
+                q = quaternion(p2, ty, p0, d1);
+            }
+            T tz = T(1) - r00 - r11 + r22;
+            if (tz > t)
+            {
+                t = tz;
+                q = quaternion(p1, p0, tz, d2);
+            }
+            T k = T(0.5) / sqrt(t);
+            return quaternion(q.x * k, q.y * k, q.z * k, q.w * k);
+        }
+
+        // 分解 src 处的一个 4x4 矩阵，写入 dst[0..9][i]（顺序与 TRSSoABuffer 成员相同）
+        inline bool decomposeMatrix(const float *src, float *const dst[10], size_t i)
+        {
+            const float a[3][3] = {{src[0], src[1], src[2]}, {src[4], src[5], src[6]}, {src[8], src[9], src[10]}};
+            float r[3][3], s[3];
+            bool regular = rotationScaleFromColumns(a, r, s);
+            Quaternion<float> q = quaternionFromRotation(r);
+            const float values[10] = {src[12], src[13], src[14], q.x, q.y, q.z, q.w, s[0], s[1], s[2]};
+            for (size_t k = 0; k < 10; k++)
+            {
+                dst[k][i] = values[k];
+            }
+            return regular;
+        }
+
+        inline size_t decomposeMatricesRange(const float *matrices, size_t begin, size_t end, float *const dst[10])
+        {
+            size_t singular = 0;
+            size_t i = begin;
+#if defined(GLMCS_HAS_AVX)
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), half = _mm256_set1_ps(0.5f);
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+            const __m256 tiny = _mm256_set1_ps(decomposeTiny<float>()), tolerance = _mm256_set1_ps(shearTolerance<float>());
+            for (; i + 8 <= end; i += 8)
+            {
+                __m256 soa[16];
+                simd::loadMatrices8(matrices + i * 16, soa);
+                __m256 n[3][3], s[3], len2[3];
+                for (size_t c = 0; c < 3; c++)
+                {
+                    len2[c] = simd::madd(soa[c * 4 + 2], soa[c * 4 + 2], simd::madd(soa[c * 4 + 1], soa[c * 4 + 1], _mm256_mul_ps(soa[c * 4], soa[c * 4])));
+                    s[c] = _mm256_sqrt_ps(len2[c]);
+                    __m256 inv = _mm256_div_ps(one, s[c]);
+                    for (size_t r = 0; r < 3; r++)
+                    {
+                        n[c][r] = _mm256_mul_ps(soa[c * 4 + r], inv);
+                    }
+                }
+                __m256 limit = _mm256_mul_ps(tiny, _mm256_max_ps(len2[0], _mm256_max_ps(len2[1], len2[2])));
+                __m256 ok = _mm256_and_ps(_mm256_cmp_ps(len2[0], limit, _CMP_GT_OQ),
+                                          _mm256_and_ps(_mm256_cmp_ps(len2[1], limit, _CMP_GT_OQ), _mm256_cmp_ps(len2[2], limit, _CMP_GT_OQ)));
+                // 行列式为负：翻转第 0 列与 x 缩放
+                __m256 c12x = _mm256_sub_ps(_mm256_mul_ps(n[1][1], n[2][2]), _mm256_mul_ps(n[1][2], n[2][1]));
+                __m256 c12y = _mm256_sub_ps(_mm256_mul_ps(n[1][2], n[2][0]), _mm256_mul_ps(n[1][0], n[2][2]));
+                __m256 c12z = _mm256_sub_ps(_mm256_mul_ps(n[1][0], n[2][1]), _mm256_mul_ps(n[1][1], n[2][0]));
+                __m256 det = simd::madd(n[0][2], c12z, simd::madd(n[0][1], c12y, _mm256_mul_ps(n[0][0], c12x)));
+                __m256 flip = _mm256_and_ps(_mm256_cmp_ps(det, zero, _CMP_LT_OQ), signBit);
+                s[0] = _mm256_xor_ps(s[0], flip);
+                for (size_t r = 0; r < 3; r++)
+                {
+                    n[0][r] = _mm256_xor_ps(n[0][r], flip);
+                }
+                // 切变检测：归一化列两两点积
+                __m256 d01 = simd::madd(n[0][2], n[1][2], simd::madd(n[0][1], n[1][1], _mm256_mul_ps(n[0][0], n[1][0])));
+                __m256 d02 = simd::madd(n[0][2], n[2][2], simd::madd(n[0][1], n[2][1], _mm256_mul_ps(n[0][0], n[2][0])));
+                __m256 d12 = simd::madd(n[1][2], n[2][2], simd::madd(n[1][1], n[2][1], _mm256_mul_ps(n[1][0], n[2][0])));
+                __m256 maxDot = _mm256_max_ps(_mm256_andnot_ps(signBit, d01), _mm256_max_ps(_mm256_andnot_ps(signBit, d02), _mm256_andnot_ps(signBit, d12)));
+                ok = _mm256_and_ps(ok, _mm256_cmp_ps(maxDot, tolerance, _CMP_LE_OQ));
+
+                // 四元数，分支选择与 quaternionFromRotation 相同
+                __m256 d0 = _mm256_sub_ps(n[1][2], n[2][1]), d1 = _mm256_sub_ps(n[2][0], n[0][2]), d2 = _mm256_sub_ps(n[0][1], n[1][0]);
+                __m256 p0 = _mm256_add_ps(n[1][2], n[2][1]), p1 = _mm256_add_ps(n[2][0], n[0][2]), p2 = _mm256_add_ps(n[0][1], n[1][0]);
+                __m256 t = _mm256_add_ps(_mm256_add_ps(one, n[0][0]), _mm256_add_ps(n[1][1], n[2][2]));
+                __m256 qx = d0, qy = d1, qz = d2, qw = t;
+                __m256 tx = _mm256_sub_ps(_mm256_add_ps(one, n[0][0]), _mm256_add_ps(n[1][1], n[2][2]));
+                __m256 m = _mm256_cmp_ps(tx, t, _CMP_GT_OQ);
+                t = _mm256_blendv_ps(t, tx, m);
+                qx = _mm256_blendv_ps(qx, tx, m);
+                qy = _mm256_blendv_ps(qy, p2, m);
+                qz = _mm256_blendv_ps(qz, p1, m);
+                qw = _mm256_blendv_ps(qw, d0, m);
+                __m256 ty = _mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(one, n[0][0]), n[1][1]), n[2][2]);
+                m = _mm256_cmp_ps(ty, t, _CMP_GT_OQ);
+                t = _mm256_blendv_ps(t, ty, m);
+                qx = _mm256_blendv_ps(qx, p2, m);
+                qy = _mm256_blendv_ps(qy, ty, m);
+                qz = _mm256_blendv_ps(qz, p0, m);
+                qw = _mm256_blendv_ps(qw, d1, m);
+                __m256 tz = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(one, n[0][0]), n[1][1]), n[2][2]);
+                m = _mm256_cmp_ps(tz, t, _CMP_GT_OQ);
+                t = _mm256_blendv_ps(t, tz, m);
+                qx = _mm256_blendv_ps(qx, p1, m);
+                qy = _mm256_blendv_ps(qy, p0, m);
+                qz = _mm256_blendv_ps(qz, tz, m);
+                qw = _mm256_blendv_ps(qw, d2, m);
+                __m256 k = _mm256_div_ps(half, _mm256_sqrt_ps(t));
+
+                const __m256 values[10] = {soa[12], soa[13], soa[14],
+                                           _mm256_mul_ps(qx, k), _mm256_mul_ps(qy, k), _mm256_mul_ps(qz, k), _mm256_mul_ps(qw, k),
+                                           s[0], s[1], s[2]};
+                for (size_t v = 0; v < 10; v++)
+                {
+                    _mm256_storeu_ps(dst[v] + i, values[v]);
+                }
+                // 有切变、奇异或 NaN 的通道走标量路径
+                int fallback = ~_mm256_movemask_ps(ok) & 0xff;
+                for (size_t lane = 0; fallback != 0 && lane < 8; lane++)
+                {
+                    if (fallback & (1 << lane))
+                    {
+                        fallback &= ~(1 << lane);
+                        if (!decomposeMatrix(matrices + (i + lane) * 16, dst, i + lane))
+                        {
+                            singular++;
+                            (void)GLMCS_CHECK(false, GLMCS_error_singular_matrix, "decomposeTRSMatrices");
+                        }
+                    }
+                }
+            }
+#endif
+            for (; i < end; i++)
+            {
+                if (!decomposeMatrix(matrices + i * 16, dst, i))
+                {
+                    singular++;
+                    (void)GLMCS_CHECK(false, GLMCS_error_singular_matrix, "decomposeTRSMatrices");
+                }
+            }
+            return singular;
+        }
+    } // namespace trsbatch
+
+    /// @brief 由 SoA 的平移、旋转、缩放批量生成 4x4 实例矩阵 M = T * R * S
+    /// @param trs SoA 输入，旋转须为单位四元数
+    /// @param count 实例个数
+    /// @param out 输出，count * 16 个 float，与 Matrix<float,4,4> 的存储相同
+    /// @param threads 线程数，1 表示在调用线程上完成
+    inline void buildTRSMatrices(const TRSArraysSoA &trs, size_t count, float *out, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { trsbatch::buildMatricesRange(trs, begin, end, out); }, 8);
+    }
+
+    // 输出为矩阵数组的重载
+    inline void buildTRSMatrices(const TRSArraysSoA &trs, size_t count, Matrix<float, 4, 4> *out, unsigned threads = 1)
+    {
+        buildTRSMatrices(trs, count, reinterpret_cast<float *>(out), threads);
+    }
+
+    /// @brief 同 buildTRSMatrices，输出 3x4 矩阵（M 的前三行，每行 4 个 float）
+    /// @param out 输出，count * 12 个 float
+    inline void buildTRSMatrices3x4(const TRSArraysSoA &trs, size_t count, float *out, unsigned threads = 1)
+    {
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { trsbatch::buildMatrices3x4Range(trs, begin, end, out); }, 8);
+    }
+    /// @brief 将 M = T * R * S 分解为平移、旋转（单位四元数）与缩放，是 buildTRSMatrices 的逆运算。
+    /// 行列式为负（镜像）时 x 缩放为负；有切变时取极分解的最近旋转，缩放为拉伸矩阵的对角线
+    /// @param m 仿射矩阵，最后一行须为 (0, 0, 0, 1)
+    /// @return GLMCS_ok；3x3 部分奇异时为 GLMCS_false（仍输出正交的旋转，对应轴的缩放为 0）
+    template <typename T>
+    inline int decomposeTRS(const Matrix<T, 4, 4> &m, Vector3T<T> *translation, Quaternion<T> *rotation, Vector3T<T> *scale)
+    {
+        const T a[3][3] = {{m.mat[0][0], m.mat[0][1], m.mat[0][2]},
+                           {m.mat[1][0], m.mat[1][1], m.mat[1][2]},
+                           {m.mat[2][0], m.mat[2][1], m.mat[2][2]}};
+        T r[3][3], s[3];
+        bool regular = trsbatch::rotationScaleFromColumns(a, r, s);
+        translation->x = m.mat[3][0];
+        translation->y = m.mat[3][1];
+        translation->z = m.mat[3][2];
+        *rotation = trsbatch::quaternionFromRotation(r);
+        scale->x = s[0];
+        scale->y = s[1];
+        scale->z = s[2];
+        if (!regular)
+        {
+            (void)GLMCS_CHECK(false, GLMCS_error_singular_matrix, "decomposeTRS");
+            return GLMCS_false;
+        }
+        return GLMCS_ok;
+    }
+
+    /// @brief 批量分解 count 个 4x4 矩阵（与 Matrix<float,4,4> 相同的存储），结果可直接传回 buildTRSMatrices
+    /// @param matrices 输入，count * 16 个 float
+    /// @param out 输出，按 count 调整大小
+    /// @param threads 线程数，1 表示在调用线程上完成
+    /// @return 3x3 部分奇异的矩阵个数
+    inline size_t decomposeTRSMatrices(const float *matrices, size_t count, TRSSoABuffer &out, unsigned threads = 1)
+    {
+        out.resize(count);
+        float *const dst[10] = {out.translationX.data(), out.translationY.data(), out.translationZ.data(),
+                                out.rotationX.data(), out.rotationY.data(), out.rotationZ.data(), out.rotationW.data(),
+                                out.scaleX.data(), out.scaleY.data(), out.scaleZ.data()};
+        std::atomic<size_t> singular(0);
+        parallelFor(count, threads, [&](size_t begin, size_t end)
+                    { singular += trsbatch::decomposeMatricesRange(matrices, begin, end, dst); }, 8);
+        return singular.load();
+    }
+
+    inline size_t decomposeTRSMatrices(const Matrix<float, 4, 4> *matrices, size_t count, TRSSoABuffer &out, unsigned threads = 1)
+    {
+        return decomposeTRSMatrices(reinterpret_cast<const float *>(matrices), count, out, threads);
+    }
+} // namespace glmCS
+
+#endif // __CSTRS_UTILS_H__
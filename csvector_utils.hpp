@@ -0,0 +1,523 @@
+/// @ref core
+/// @file csvector_utils.hpp
+///
+/// @defgroup CS https://github.com/CSsaan/OpenGL_GLSL
+///
+/// @brief Generic GLSL-style vectors for glmCS.
+/// Vector<T, N> supports component-wise operators, GLSL swizzles (v.xy(), v.zyx(), v.xxyy() or v.swizzle<2, 1, 0>())
+/// and matrix-vector products with the same meaning as GLSL (mat * vec, vec * mat).
+/// Vector<float, 3> and Vector<float, 4> are stored in one 16-byte-aligned SIMD register (SSE / NEON);
+/// the padding lane of a vec3 is kept at zero.
+///
+/// glmCS::Vec3 p(1.0f, 2.0f, 3.0f);
+/// glmCS::Vec4 clip = mvp * glmCS::Vec4(p, 1.0f);
+/// glmCS::Vec3 n = glmCS::normalize(glmCS::cross(p, clip.xyz()));
+///
+
+#ifndef __CSVECTOR_UTILS_H__
+#define __CSVECTOR_UTILS_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <type_traits>
+#include "csmatrix_utils.hpp"
+
+namespace glmCS
+{
+    // 向量的存储方式：float 的 vec3/vec4 占用一个 16 字节对齐的 SIMD 寄存器，其余按元素紧密排列
+    template <typename T, size_t N>
+    struct VectorStorage
+    {
+        static const bool simd = false;
+        static const size_t size = N;
+        static const size_t align = alignof(T);
+    };
+    template <>
+    struct VectorStorage<float, 3>
+    {
+        static const bool simd = true;
+        static const size_t size = 4;
+        static const size_t align = 16;
+    };
+    template <>
+    struct VectorStorage<float, 4>
+    {
+        static const bool simd = true;
+        static const size_t size = 4;
+        static const size_t align = 16;
+    };
+
+#if defined(GLMCS_HAS_SSE2) || defined(GLMCS_HAS_NEON)
+#define GLMCS_VECTOR_SIMD 1
+#endif
+
+    // 定义一个 N 维向量
+    template <typename T, size_t N>
+    struct alignas(VectorStorage<T, N>::align) Vector
+    {
+        static_assert(N >= 1 && N <= 4, "glmCS::Vector supports 1 to 4 components");
+        typedef T value_type;
+        static const size_t components = N;
+
+        T v[VectorStorage<T, N>::size];
+
+        Vector() : v() {}
+        explicit Vector(T s) : v()
+        {
+#if defined(GLMCS_HAS_SSE2)
+            // 在寄存器内广播后整体写入；逐元素写入再被 SIMD 读取会导致 store forwarding 失败（v * s 的热点）
+            if constexpr (VectorStorage<T, N>::simd)
+            {
+                _mm_store_ps(v, N == 3 ? _mm_set_ps(0.0f, s, s, s) : _mm_set1_ps(s));
+                return;
+            }
+#endif
+            for (size_t i = 0; i < N; i++)
+            {
+                v[i] = s;
+            }
+        }
+        template <typename... Args, typename = typename std::enable_if<(N > 1) && sizeof...(Args) == N>::type>
+        Vector(Args... args) : v{T(args)...}
+        {
+        }
+        // vec4(vec3, w) / vec3(vec2, z)
+        template <size_t M = N, typename = typename std::enable_if<(M > 1)>::type>
+        Vector(const Vector<T, M - 1> &a, T last) : v()
+        {
+            for (size_t i = 0; i + 1 < N; i++)
+            {
+                v[i] = a.v[i];
+            }
+            v[N - 1] = last;
+        }
+        // 与 Vector3T 互相转换
+        template <size_t M = N, typename = typename std::enable_if<M == 3>::type>
+        Vector(const Vector3T<T> &a) : v{a.x, a.y, a.z}
+        {
+        }
+        Vector3T<T> toVector3() const
+        {
+            static_assert(N == 3, "toVector3() requires a 3-component vector");
+            Vector3T<T> r;
+            r.x = v[0];
+            r.y = v[1];
+            r.z = v[2];
+            return r;
+        }
+
+        T &operator[](size_t i) { return v[i]; }
+        const T &operator[](size_t i) const { return v[i]; }
+
+        T &x() { return v[0]; }
+        T &y()
+        {
+            static_assert(N > 1, "y() out of range");
+            return v[1];
+        }
+        T &z()
+        {
+            static_assert(N > 2, "z() out of range");
+            return v[2];
+        }
+        T &w()
+        {
+            static_assert(N > 3, "w() out of range");
+            return v[3];
+        }
+        T x() const { return v[0]; }
+        T y() const
+        {
+            static_assert(N > 1, "y() out of range");
+            return v[1];
+        }
+        T z() const
+        {
+            static_assert(N > 2, "z() out of range");
+            return v[2];
+        }
+        T w() const
+        {
+            static_assert(N > 3, "w() out of range");
+            return v[3];
+        }
+
+        /// @brief 通用重排：v.swizzle<2, 1, 0>() 等价于 GLSL 的 v.zyx
+        template <size_t... I>
+        Vector<T, sizeof...(I)> swizzle() const
+        {
+            static_assert(sizeof...(I) >= 2 && sizeof...(I) <= 4, "swizzle needs 2 to 4 components");
+            static_assert(((I < N) && ...), "swizzle component out of range");
+            return Vector<T, sizeof...(I)>(v[I]...);
+        }
+
+        // GLSL 命名重排：xy() / zyx() / xxyy() ...
+#define GLMCS_SWIZZLE2(A, IA, B, IB) \
+    Vector<T, 2> A##B() const { return swizzle<IA, IB>(); }
+#define GLMCS_SWIZZLE3(A, IA, B, IB, C, IC) \
+    Vector<T, 3> A##B##C() const { return swizzle<IA, IB, IC>(); }
+#define GLMCS_SWIZZLE4(A, IA, B, IB, C, IC, D, ID) \
+    Vector<T, 4> A##B##C##D() const { return swizzle<IA, IB, IC, ID>(); }
+#define GLMCS_SWIZZLE2_B(A, IA) \
+    GLMCS_SWIZZLE2(A, IA, x, 0) GLMCS_SWIZZLE2(A, IA, y, 1) GLMCS_SWIZZLE2(A, IA, z, 2) GLMCS_SWIZZLE2(A, IA, w, 3)
+#define GLMCS_SWIZZLE3_C(A, IA, B, IB) \
+    GLMCS_SWIZZLE3(A, IA, B, IB, x, 0) GLMCS_SWIZZLE3(A, IA, B, IB, y, 1) GLMCS_SWIZZLE3(A, IA, B, IB, z, 2) GLMCS_SWIZZLE3(A, IA, B, IB, w, 3)
+#define GLMCS_SWIZZLE3_B(A, IA) \
+    GLMCS_SWIZZLE3_C(A, IA, x, 0) GLMCS_SWIZZLE3_C(A, IA, y, 1) GLMCS_SWIZZLE3_C(A, IA, z, 2) GLMCS_SWIZZLE3_C(A, IA, w, 3)
+#define GLMCS_SWIZZLE4_D(A, IA, B, IB, C, IC) \
+    GLMCS_SWIZZLE4(A, IA, B, IB, C, IC, x, 0) GLMCS_SWIZZLE4(A, IA, B, IB, C, IC, y, 1) GLMCS_SWIZZLE4(A, IA, B, IB, C, IC, z, 2) GLMCS_SWIZZLE4(A, IA, B, IB, C, IC, w, 3)
+#define GLMCS_SWIZZLE4_C(A, IA, B, IB) \
+    GLMCS_SWIZZLE4_D(A, IA, B, IB, x, 0) GLMCS_SWIZZLE4_D(A, IA, B, IB, y, 1) GLMCS_SWIZZLE4_D(A, IA, B, IB, z, 2) GLMCS_SWIZZLE4_D(A, IA, B, IB, w, 3)
+#define GLMCS_SWIZZLE4_B(A, IA) \
+    GLMCS_SWIZZLE4_C(A, IA, x, 0) GLMCS_SWIZZLE4_C(A, IA, y, 1) GLMCS_SWIZZLE4_C(A, IA, z, 2) GLMCS_SWIZZLE4_C(A, IA, w, 3)
+#define GLMCS_SWIZZLE_ALL(M) M(x, 0) M(y, 1) M(z, 2) M(w, 3)
+
+        GLMCS_SWIZZLE_ALL(GLMCS_SWIZZLE2_B)
+        GLMCS_SWIZZLE_ALL(GLMCS_SWIZZLE3_B)
+        GLMCS_SWIZZLE_ALL(GLMCS_SWIZZLE4_B)
+
+#undef GLMCS_SWIZZLE_ALL
+#undef GLMCS_SWIZZLE4_B
+#undef GLMCS_SWIZZLE4_C
+#undef GLMCS_SWIZZLE4_D
+#undef GLMCS_SWIZZLE3_B
+#undef GLMCS_SWIZZLE3_C
+#undef GLMCS_SWIZZLE2_B
+#undef GLMCS_SWIZZLE4
+#undef GLMCS_SWIZZLE3
+#undef GLMCS_SWIZZLE2
+    };
+
+    typedef Vector<float, 2> Vec2;
+    typedef Vector<float, 3> Vec3;
+    typedef Vector<float, 4> Vec4;
+    typedef Vector<double, 2> DVec2;
+    typedef Vector<double, 3> DVec3;
+    typedef Vector<double, 4> DVec4;
+    typedef Vector<int, 2> IVec2;
+    typedef Vector<int, 3> IVec3;
+    typedef Vector<int, 4> IVec4;
+
+    // -------------------------------------------------------------------
+    // SIMD 寄存器读写（仅 float vec3/vec4）
+#if defined(GLMCS_HAS_SSE2)
+    typedef __m128 VectorRegister;
+    template <size_t N>
+    inline __m128 loadVector(const Vector<float, N> &a) { return _mm_load_ps(a.v); }
+    template <size_t N>
+    inline void storeVector(Vector<float, N> &a, __m128 r) { _mm_store_ps(a.v, r); }
+    // 清零 vec3 的填充分量
+    inline __m128 maskPadding(__m128 r, size_t N)
+    {
+        return N == 3 ? _mm_and_ps(r, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1))) : r;
+    }
+#elif defined(GLMCS_HAS_NEON)
+    typedef float32x4_t VectorRegister;
+    template <size_t N>
+    inline float32x4_t loadVector(const Vector<float, N> &a) { return vld1q_f32(a.v); }
+    template <size_t N>
+    inline void storeVector(Vector<float, N> &a, float32x4_t r) { vst1q_f32(a.v, r); }
+    inline float32x4_t maskPadding(float32x4_t r, size_t N)
+    {
+        return N == 3 ? vsetq_lane_f32(0.0f, r, 3) : r;
+    }
+#endif
+
+    // 逐分量运算
+    template <typename T, size_t N, typename Op>
+    inline Vector<T, N> componentWise(const Vector<T, N> &a, const Vector<T, N> &b, Op op)
+    {
+        Vector<T, N> r;
+        for (size_t i = 0; i < N; i++)
+        {
+            r.v[i] = op(a.v[i], b.v[i]);
+        }
+        return r;
+    }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> operator+(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+#if defined(GLMCS_VECTOR_SIMD)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            Vector<T, N> r;
+#if defined(GLMCS_HAS_SSE2)
+            storeVector(r, _mm_add_ps(loadVector(a), loadVector(b)));
+#else
+            storeVector(r, vaddq_f32(loadVector(a), loadVector(b)));
+#endif
+            return r;
+        }
+#endif
+        return componentWise(a, b, [](T x, T y)
+                             { return x + y; });
+    }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> operator-(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+#if defined(GLMCS_VECTOR_SIMD)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            Vector<T, N> r;
+#if defined(GLMCS_HAS_SSE2)
+            storeVector(r, _mm_sub_ps(loadVector(a), loadVector(b)));
+#else
+            storeVector(r, vsubq_f32(loadVector(a), loadVector(b)));
+#endif
+            return r;
+        }
+#endif
+        return componentWise(a, b, [](T x, T y)
+                             { return x - y; });
+    }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> operator*(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+#if defined(GLMCS_VECTOR_SIMD)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            Vector<T, N> r;
+#if defined(GLMCS_HAS_SSE2)
+            storeVector(r, _mm_mul_ps(loadVector(a), loadVector(b)));
+#else
+            storeVector(r, vmulq_f32(loadVector(a), loadVector(b)));
+#endif
+            return r;
+        }
+#endif
+        return componentWise(a, b, [](T x, T y)
+                             { return x * y; });
+    }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> operator/(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+#if defined(GLMCS_HAS_SSE2)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            // vec3 的填充分量为 0/0，需要清零
+            Vector<T, N> r;
+            storeVector(r, maskPadding(_mm_div_ps(loadVector(a), loadVector(b)), N));
+            return r;
+        }
+#endif
+        return componentWise(a, b, [](T x, T y)
+                             { return x / y; });
+    }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> operator*(const Vector<T, N> &a, T s) { return a * Vector<T, N>(s); }
+    template <typename T, size_t N>
+    inline Vector<T, N> operator*(T s, const Vector<T, N> &a) { return a * Vector<T, N>(s); }
+    template <typename T, size_t N>
+    inline Vector<T, N> operator/(const Vector<T, N> &a, T s)
+    {
+        // 浮点类型用倒数相乘；整数类型的 T(1) / s 会截断为 0，需逐分量相除
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            return a * Vector<T, N>(T(1) / s);
+        }
+        else
+        {
+            return componentWise(a, Vector<T, N>(s), [](T x, T y)
+                                 { return x / y; });
+        }
+    }
+    template <typename T, size_t N>
+    inline Vector<T, N> operator+(const Vector<T, N> &a, T s) { return a + Vector<T, N>(s); }
+    template <typename T, size_t N>
+    inline Vector<T, N> operator-(const Vector<T, N> &a, T s) { return a - Vector<T, N>(s); }
+    template <typename T, size_t N>
+    inline Vector<T, N> operator-(const Vector<T, N> &a) { return Vector<T, N>() - a; }
+
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator+=(Vector<T, N> &a, const Vector<T, N> &b) { return a = a + b; }
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator-=(Vector<T, N> &a, const Vector<T, N> &b) { return a = a - b; }
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator*=(Vector<T, N> &a, const Vector<T, N> &b) { return a = a * b; }
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator/=(Vector<T, N> &a, const Vector<T, N> &b) { return a = a / b; }
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator*=(Vector<T, N> &a, T s) { return a = a * s; }
+    template <typename T, size_t N>
+    inline Vector<T, N> &operator/=(Vector<T, N> &a, T s) { return a = a / s; }
+
+    template <typename T, size_t N>
+    inline bool operator==(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            if (a.v[i] != b.v[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    template <typename T, size_t N>
+    inline bool operator!=(const Vector<T, N> &a, const Vector<T, N> &b) { return !(a == b); }
+
+    // -------------------------------------------------------------------
+    // 获取向量内积
+    template <typename T, size_t N>
+    inline T dot(const Vector<T, N> &a, const Vector<T, N> &b)
+    {
+#if defined(GLMCS_HAS_SSE41)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            return _mm_cvtss_f32(_mm_dp_ps(loadVector(a), loadVector(b), 0xF1));
+        }
+#endif
+        T sum = T(0);
+        for (size_t i = 0; i < N; i++)
+        {
+            sum += a.v[i] * b.v[i];
+        }
+        return sum;
+    }
+
+    // 获取vec3叉乘向量
+    template <typename T>
+    inline Vector<T, 3> cross(const Vector<T, 3> &a, const Vector<T, 3> &b)
+    {
+#if defined(GLMCS_HAS_SSE2)
+        if constexpr (VectorStorage<T, 3>::simd)
+        {
+            // a.yzx * b.zxy - a.zxy * b.yzx，填充分量保持为 0
+            __m128 va = loadVector(a), vb = loadVector(b);
+            __m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 c = _mm_sub_ps(_mm_mul_ps(va, b_yzx), _mm_mul_ps(a_yzx, vb));
+            Vector<T, 3> r;
+            storeVector(r, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+            return r;
+        }
+#endif
+        return Vector<T, 3>(a.v[1] * b.v[2] - a.v[2] * b.v[1],
+                            a.v[2] * b.v[0] - a.v[0] * b.v[2],
+                            a.v[0] * b.v[1] - a.v[1] * b.v[0]);
+    }
+
+    // 获取向量长度
+    template <typename T, size_t N>
+    inline T length(const Vector<T, N> &a)
+    {
+        return sqrt(dot(a, a));
+    }
+
+    /// @brief 获取单位向量。float vec3/vec4 使用 rsqrt 近似加一次牛顿迭代（相对误差约 1e-7 量级），代替 sqrt 与逐分量除法。
+    /// 零向量返回零向量。
+    template <typename T, size_t N>
+    inline Vector<T, N> normalize(const Vector<T, N> &a)
+    {
+#if defined(GLMCS_HAS_SSE2)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            __m128 x = loadVector(a);
+            __m128 m = _mm_mul_ps(x, x);
+            __m128 d = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+            d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2))); // 各分量均为 |a|^2
+            __m128 r = _mm_rsqrt_ps(d);
+            // 牛顿迭代：r = r * (1.5 - 0.5 * d * r * r)
+            __m128 half_d_r = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), d), r);
+            r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half_d_r, r)));
+            // 零向量：rsqrt(0) 为 inf，屏蔽后结果为 0
+            r = _mm_and_ps(r, _mm_cmpgt_ps(d, _mm_setzero_ps()));
+            Vector<T, N> out;
+            storeVector(out, _mm_mul_ps(x, r));
+            return out;
+        }
+#elif defined(GLMCS_HAS_NEON)
+        if constexpr (VectorStorage<T, N>::simd)
+        {
+            float32x4_t x = loadVector(a);
+            float32x4_t m = vmulq_f32(x, x);
+            float32x4_t d = vdupq_n_f32(vaddvq_f32(m));
+            float32x4_t r = vrsqrteq_f32(d);
+            r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(d, r), r)); // 牛顿迭代
+            r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(d, r), r)); // NEON 的初始估计只有 8 位，需要两次
+            r = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(r), vcgtq_f32(d, vdupq_n_f32(0.0f))));
+            Vector<T, N> out;
+            storeVector(out, vmulq_f32(x, r));
+            return out;
+        }
+#endif
+        T len2 = dot(a, a);
+        if (len2 == T(0))
+        {
+            return Vector<T, N>();
+        }
+        return a * (T(1) / T(sqrt(len2)));
+    }
+
+    // -------------------------------------------------------------------
+    /// @brief 矩阵乘向量，与 GLSL 的 mat * vec 一致：mat[i] 为第 i 列，结果为各列按 vec 分量加权求和。
+    /// 对应 csmatrix_utils 的存储方式（平移位于 mat[3]），mvp * vec4(p, 1) 即得到裁剪坐标。
+    template <typename T, size_t rows, size_t cols>
+    inline Vector<T, cols> operator*(const Matrix<T, rows, cols> &m, const Vector<T, rows> &a)
+    {
+        Vector<T, cols> r;
+        for (size_t j = 0; j < cols; j++)
+        {
+            T sum = T(0);
+            for (size_t i = 0; i < rows; i++)
+            {
+                sum += m.mat[i][j] * a.v[i];
+            }
+            r.v[j] = sum;
+        }
+        return r;
+    }
+
+#if defined(GLMCS_HAS_SSE2)
+    inline Vector<float, 4> operator*(const Matrix<float, 4, 4> &m, const Vector<float, 4> &a)
+    {
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(m.mat[0]), _mm_set1_ps(a.v[0]));
+        r = simd::madd(_mm_loadu_ps(m.mat[1]), _mm_set1_ps(a.v[1]), r);
+        r = simd::madd(_mm_loadu_ps(m.mat[2]), _mm_set1_ps(a.v[2]), r);
+        r = simd::madd(_mm_loadu_ps(m.mat[3]), _mm_set1_ps(a.v[3]), r);
+        Vector<float, 4> out;
+        storeVector(out, r);
+        return out;
+    }
+#endif
+
+    /// @brief 向量乘矩阵，与 GLSL 的 vec * mat 一致：结果的第 i 个分量为 vec 与第 i 列的内积。
+    template <typename T, size_t rows, size_t cols>
+    inline Vector<T, rows> operator*(const Vector<T, cols> &a, const Matrix<T, rows, cols> &m)
+    {
+        Vector<T, rows> r;
+        for (size_t i = 0; i < rows; i++)
+        {
+            T sum = T(0);
+            for (size_t j = 0; j < cols; j++)
+            {
+                sum += m.mat[i][j] * a.v[j];
+            }
+            r.v[i] = sum;
+        }
+        return r;
+    }
+
+    // 变换点（w = 1，不做透视除法）
+    template <typename T>
+    inline Vector<T, 3> transformPoint(const Matrix<T, 4, 4> &m, const Vector<T, 3> &p)
+    {
+        Vector<T, 4> r = m * Vector<T, 4>(p, T(1));
+        return Vector<T, 3>(r.v[0], r.v[1], r.v[2]);
+    }
+
+    // 变换方向（w = 0，忽略平移）
+    template <typename T>
+    inline Vector<T, 3> transformVector(const Matrix<T, 4, 4> &m, const Vector<T, 3> &d)
+    {
+        Vector<T, 4> r = m * Vector<T, 4>(d, T(0));
+        return Vector<T, 3>(r.v[0], r.v[1], r.v[2]);
+    }
+} // namespace glmCS
+
+#endif // __CSVECTOR_UTILS_H__
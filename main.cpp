@@ -1,29 +1,32 @@
 #include <stdio.h>
-#include "csmatrix_utils.h"
+#include <vector>
+#include "csmatrix_utils.hpp"
 
 int main()
 {
-    glmCS::Matrix modelMatrix;
-    glmCS::initIdentityMatrix4x4(&modelMatrix); // 单位矩阵
-
-    // 检测返回值
-    int ret = 0;
+    glmCS::Matrix<float, 4, 4> modelMatrix = glmCS::initIdentityMatrix<float, 4>(); // 单位矩阵
 
     // 执行平移变换
-    glmCS::translateMatrix(&modelMatrix, 4.0f, 5.0f, 6.0f);
+    modelMatrix = glmCS::translateMatrix<float>(modelMatrix, 4.0f, 5.0f, 6.0f);
 
     // 绕x/y/z轴旋转
-    ret = glmCS::rotate(90, &modelMatrix, 0, 0, 1); // 绕z轴旋转
+    modelMatrix = glmCS::rotate(90, modelMatrix, 0, 0, 1); // 绕z轴旋转
 
     // 缩放
-    glmCS::scaleMatrix(&modelMatrix, 2.0f, 2.0f, 2.0f);
+    modelMatrix = glmCS::scaleMatrix<float>(modelMatrix, 2.0f, 2.0f, 2.0f);
 
     // 打印生成的模型矩阵
     printf("Model Matrix result:\n");
     glmCS::printMatrix(&modelMatrix);
 
-    // 将二维数组转为一维数组
-    float *p = (float *)modelMatrix.mat4;
+    // 连续的列主序数据，可直接 glUniformMatrix4fv(location, 1, GL_FALSE, p)
+    const float *p = glmCS::valuePtr(modelMatrix);
+    printf("translation: %.2f %.2f %.2f\n", p[12], p[13], p[14]);
+
+    // 矩阵数组整体上传只需一次 memcpy
+    std::vector<glmCS::Matrix<float, 4, 4>> instances(4, modelMatrix);
+    std::vector<float> uploadBuffer(instances.size() * 16);
+    glmCS::copyMatricesForUpload(instances.data(), instances.size(), uploadBuffer.data());
 
     return 0;
 }
@@ -18,6 +18,9 @@
 ///        std::string name = truetype.getTTFdir();
 ///    [5].get bitmap result:
 ///        truetype.bitmap;
+///    [6].(optional) replace the shaping stage or resize the shaped-run cache:
+///        truetype.setShaper(std::make_shared<MyShaper>());
+///        truetype.setShapedRunCacheCapacity(256);
 //////////////////////////////////////////////////////////////////////////////
 
 #ifndef __TRUETYPE_H__
@@ -27,10 +30,191 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <list>
+#include <memory>
+#include <unordered_map>
 
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"
 
+// 整形后的单个字形
+struct ShapedGlyph
+{
+    int glyph;   // 字形索引（非码点）
+    int x;       // 字形原点在位图中的x（已包含字距调整）
+    int y;       // 字形左上角在位图中的y
+    int w, h;    // 字形位图的宽、高
+    int bearing; // 左侧位置（像素）
+};
+
+// 整形结果：一段已定位的字形序列
+struct ShapedRun
+{
+    float scale = 0.0f; // 字体缩放
+    int ascent = 0;     // 缩放后的基线到顶部高度
+    int descent = 0;    // 缩放后的基线到底部高度
+    int width = 0;      // 整段文本的总宽度
+    std::vector<ShapedGlyph> glyphs;
+};
+
+/// @brief 文本整形阶段的接口，将码点序列转换为已定位的字形序列。
+/// 可替换为支持连字、复杂文字的实现（例如基于 HarfBuzz 的整形器）。
+class TextShaper
+{
+public:
+    virtual ~TextShaper() {}
+    /// @brief 对码点序列进行整形
+    /// @param info 字体信息
+    /// @param codepoints 输入的 Unicode 码点
+    /// @param pixels 字体像素高度
+    /// @param run 输出的整形结果
+    virtual void shape(const stbtt_fontinfo *info, const std::vector<int> &codepoints, float pixels, ShapedRun &run) = 0;
+};
+
+/// @brief 内置的简单整形器：逐字形前进，并应用成对字距调整。
+/// stbtt_GetGlyphKernAdvance 优先读取 GPOS 的成对调整（PairPos），字体没有 GPOS 表时回退到旧的 kern 表。
+class SimpleShaper : public TextShaper
+{
+public:
+    void shape(const stbtt_fontinfo *info, const std::vector<int> &codepoints, float pixels, ShapedRun &run) override
+    {
+        run.glyphs.clear();
+        run.scale = stbtt_ScaleForPixelHeight(info, pixels);
+        int ascent = 0, descent = 0, lineGap = 0;
+        stbtt_GetFontVMetrics(info, &ascent, &descent, &lineGap);
+        run.ascent = roundf(ascent * run.scale);
+        run.descent = roundf(descent * run.scale);
+
+        // 码点 -> 字形索引只查一次，字距调整直接使用字形索引
+        std::vector<int> glyphs(codepoints.size());
+        for (size_t i = 0; i < codepoints.size(); ++i)
+        {
+            glyphs[i] = stbtt_FindGlyphIndex(info, codepoints[i]);
+        }
+
+        run.glyphs.reserve(glyphs.size());
+        int x = 0;
+        for (size_t i = 0; i < glyphs.size(); ++i)
+        {
+            int advanceWidth = 0;
+            int leftSideBearing = 0;
+            stbtt_GetGlyphHMetrics(info, glyphs[i], &advanceWidth, &leftSideBearing);
+            int c_x1, c_y1, c_x2, c_y2;
+            stbtt_GetGlyphBitmapBox(info, glyphs[i], run.scale, run.scale, &c_x1, &c_y1, &c_x2, &c_y2);
+
+            ShapedGlyph g;
+            g.glyph = glyphs[i];
+            g.x = x;
+            g.y = run.ascent + c_y1;
+            g.w = c_x2 - c_x1;
+            g.h = c_y2 - c_y1;
+            g.bearing = roundf(leftSideBearing * run.scale);
+            run.glyphs.push_back(g);
+
+            x += roundf(advanceWidth * run.scale);
+            /* 最后一个字形之后没有字距调整 */
+            if (i + 1 < glyphs.size())
+            {
+                x += roundf(stbtt_GetGlyphKernAdvance(info, glyphs[i], glyphs[i + 1]) * run.scale);
+            }
+        }
+        run.width = x;
+    }
+};
+
+/// @brief 整形结果的 LRU 缓存，键为 (字符串哈希, 字体, 字号)。
+/// 每帧重复出现的 UI 文本只整形一次。
+class ShapedRunCache
+{
+private:
+    struct Key
+    {
+        size_t hash;
+        const stbtt_fontinfo *font;
+        float pixels;
+        bool operator==(const Key &o) const { return hash == o.hash && font == o.font && pixels == o.pixels; }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const
+        {
+            size_t h = k.hash;
+            h ^= std::hash<const void *>()(k.font) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<float>()(k.pixels) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    struct Entry
+    {
+        Key key;
+        std::string text; // 用于排除哈希冲突
+        ShapedRun run;
+    };
+
+    size_t capacity;
+    std::list<Entry> entries; // 头部为最近使用
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+public:
+    explicit ShapedRunCache(size_t capacity = 64) : capacity(capacity > 0 ? capacity : 1) {}
+
+    /// @brief 查找缓存的整形结果，命中时将其移到最近使用的位置
+    /// @return 命中返回整形结果，否则返回 nullptr
+    const ShapedRun *find(const std::string &text, const stbtt_fontinfo *font, float pixels)
+    {
+        Key key = {std::hash<std::string>()(text), font, pixels};
+        auto it = index.find(key);
+        if (it == index.end() || it->second->text != text)
+        {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->run;
+    }
+
+    /// @brief 插入整形结果，超出容量时淘汰最久未使用的条目
+    const ShapedRun *insert(const std::string &text, const stbtt_fontinfo *font, float pixels, ShapedRun &&run)
+    {
+        Key key = {std::hash<std::string>()(text), font, pixels};
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            // 同键（或哈希冲突）直接覆盖
+            it->second->text = text;
+            it->second->run = std::move(run);
+            entries.splice(entries.begin(), entries, it->second);
+            return &it->second->run;
+        }
+        if (entries.size() >= capacity)
+        {
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+        entries.push_front(Entry{key, text, std::move(run)});
+        index[key] = entries.begin();
+        return &entries.front().run;
+    }
+
+    void setCapacity(size_t newCapacity)
+    {
+        capacity = newCapacity > 0 ? newCapacity : 1;
+        while (entries.size() > capacity)
+        {
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        index.clear();
+    }
+
+    size_t size() const { return entries.size(); }
+};
+
 class TrueType
 {
     /* data */
@@ -39,14 +223,16 @@ private:
     stbtt_fontinfo info;
     int bitmap_w = 512; // 位图的宽
     int bitmap_h = 128; // 位图的高
+    std::shared_ptr<TextShaper> shaper = std::make_shared<SimpleShaper>(); // 整形阶段
+    ShapedRunCache runCache;                                                // 整形结果缓存
 public:
     unsigned char *bitmap = NULL; // 位图
 
     /* func */
 private:
     int init_truetype();
-    int ttf2picture(const std::vector<char> &word, float pixels);
-    void stringToHex(const std::string &input, std::vector<char> &word);
+    int ttf2picture(const ShapedRun &run);
+    void stringToCodepoints(const std::string &input, std::vector<int> &codepoints);
     void resetBitmap();
     bool isFileExists(const char *tickImagePath);
 
@@ -58,6 +244,8 @@ public:
     // TODO: 实现拿参数的函数
     void getBitmapWH(int *w, int *h);
     std::string getTTFdir();
+    void setShaper(const std::shared_ptr<TextShaper> &shaper);
+    void setShapedRunCacheCapacity(size_t capacity);
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -107,53 +295,23 @@ int TrueType::init_truetype()
     return 1;
 }
 
-int TrueType::ttf2picture(const std::vector<char> &word, float pixels)
+int TrueType::ttf2picture(const ShapedRun &run)
 {
     resetBitmap();
-    /* 计算字体缩放 */
-    float scale = stbtt_ScaleForPixelHeight(&info, pixels); /* scale = pixels / (ascent - descent) */
-    /**
-     * 获取垂直方向上的度量
-     * ascent：字体从基线到顶部的高度；
-     * descent：基线到底部的高度，通常为负值；
-     * lineGap：两个字体之间的间距；
-     * 行间距为：ascent - descent + lineGap。
-     */
-    int ascent = 0;
-    int descent = 0;
-    int lineGap = 0;
-    stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
-    /* 根据缩放调整字高 */
-    ascent = roundf(ascent * scale);
-    descent = roundf(descent * scale);
-    int x = 0; /*位图的x*/
-    /* 循环加载word中每个字符 */
-    for (int i = 0; i < (int)word.size(); ++i)
-    {
-        /**
-         * 获取水平方向上的度量
-         * advanceWidth：字宽；
-         * leftSideBearing：左侧位置；
-         */
-        int advanceWidth = 0;
-        int leftSideBearing = 0;
-        stbtt_GetCodepointHMetrics(&info, word[i], &advanceWidth, &leftSideBearing);
-        /* 获取字符的边框（边界） */
-        int c_x1, c_y1, c_x2, c_y2;
-        stbtt_GetCodepointBitmapBox(&info, word[i], scale, scale, &c_x1, &c_y1, &c_x2, &c_y2);
-        /* 计算位图的y (不同字符的高度不同） */
-        int y = ascent + c_y1;
-        /* 渲染字符 */
-        int byteOffset = x + roundf(leftSideBearing * scale) + (y * bitmap_w);
-        stbtt_MakeCodepointBitmap(&info, bitmap + byteOffset, c_x2 - c_x1, c_y2 - c_y1, bitmap_w, scale, scale, word[i]);
-        /* 调整x */
-        x += roundf(advanceWidth * scale);
-        /* 调整字距 */
-        int kern;
-        kern = stbtt_GetCodepointKernAdvance(&info, word[i], word[i + 1]);
-        x += roundf(kern * scale);
+    /* 按整形结果逐个渲染字形 */
+    for (size_t i = 0; i < run.glyphs.size(); ++i)
+    {
+        const ShapedGlyph &g = run.glyphs[i];
+        int px = g.x + g.bearing;
+        /* 超出位图范围的字形跳过，避免越界写入 */
+        if (px < 0 || g.y < 0 || px + g.w > bitmap_w || g.y + g.h > bitmap_h)
+        {
+            continue;
+        }
+        int byteOffset = px + (g.y * bitmap_w);
+        stbtt_MakeGlyphBitmap(&info, bitmap + byteOffset, g.w, g.h, bitmap_w, run.scale, run.scale, g.glyph);
     }
-    if (x == 0)
+    if (run.width == 0)
     {
         printf("[%s:%i]No bitmap write.\n", __FILE__, __LINE__);
         return 0;
@@ -161,11 +319,52 @@ int TrueType::ttf2picture(const std::vector<char> &word, float pixels)
     return 1;
 }
 
-void TrueType::stringToHex(const std::string &input, std::vector<char> &word)
+void TrueType::stringToCodepoints(const std::string &input, std::vector<int> &codepoints)
 {
-    for (size_t i = 0; i < input.length(); ++i)
+    /* UTF-8 解码，非法字节按单字节码点处理 */
+    size_t i = 0;
+    while (i < input.length())
     {
-        word.push_back(input[i]);
+        unsigned char c = input[i];
+        int cp = c;
+        size_t n = 0;
+        if (c >= 0xF0 && c < 0xF8)
+        {
+            cp = c & 0x07;
+            n = 3;
+        }
+        else if (c >= 0xE0 && c < 0xF0)
+        {
+            cp = c & 0x0F;
+            n = 2;
+        }
+        else if (c >= 0xC0 && c < 0xE0)
+        {
+            cp = c & 0x1F;
+            n = 1;
+        }
+        if (n > 0 && i + n < input.length())
+        {
+            size_t k;
+            for (k = 1; k <= n; ++k)
+            {
+                unsigned char cc = input[i + k];
+                if ((cc & 0xC0) != 0x80)
+                {
+                    break;
+                }
+                cp = (cp << 6) | (cc & 0x3F);
+            }
+            if (k > n)
+            {
+                codepoints.push_back(cp);
+                i += n + 1;
+                continue;
+            }
+        }
+        /* ASCII、非法引导字节（含 0xF8~0xFF）或不完整的序列：按单字节输出 */
+        codepoints.push_back(c);
+        ++i;
     }
 }
 
@@ -183,9 +382,16 @@ void TrueType::resetBitmap()
 
 void TrueType::processInput(const std::string &input, float pixels)
 {
-    std::vector<char> word;
-    stringToHex(input, word);
-    ttf2picture(word, pixels);
+    const ShapedRun *run = runCache.find(input, &info, pixels);
+    if (run == nullptr)
+    {
+        std::vector<int> codepoints;
+        stringToCodepoints(input, codepoints);
+        ShapedRun shaped;
+        shaper->shape(&info, codepoints, pixels, shaped);
+        run = runCache.insert(input, &info, pixels, std::move(shaped));
+    }
+    ttf2picture(*run);
 }
 
 bool TrueType::isFileExists(const char *tickImagePath)
@@ -205,4 +411,18 @@ std::string TrueType::getTTFdir()
     return ttf_dir;
 }
 
+void TrueType::setShaper(const std::shared_ptr<TextShaper> &shaper)
+{
+    if (shaper != nullptr)
+    {
+        this->shaper = shaper;
+        runCache.clear(); // 整形器变化后缓存失效
+    }
+}
+
+void TrueType::setShapedRunCacheCapacity(size_t capacity)
+{
+    runCache.setCapacity(capacity);
+}
+
 #endif // __TRUETYPE_H__